@@ -0,0 +1,380 @@
+#!/usr/bin/env python
+
+# file: benchmark.py
+# author: Anush Krishnan (anush@bu.edu)
+# description: Runs the benchmark suite (2-D and 3-D cavity and cylinder
+#              problems at several sizes and numbers of processes), writes
+#              the timings, the iteration counts and the memory of the runs
+#              in a report, and compares them with a baseline.
+
+
+import os
+import re
+import sys
+import json
+import time
+import glob
+import shutil
+import socket
+import argparse
+import subprocess
+
+
+# template case and dimensions of each problem of the suite
+PROBLEMS = {'cavity2d': ('cases/2d/lidDrivenCavity/Re100', 2),
+            'cylinder2d': ('cases/2d/cylinder/Re40', 2),
+            'cavity3d': ('cases/3d/lidDrivenCavity/Re100PeriodicX', 3),
+            'cylinder3d': ('cases/3d/cylinder/Re40', 3),
+            'sphere3d': ('cases/3d/sphere/Re100', 3)}
+
+# problems run when none is given
+DEFAULT_PROBLEMS = ['cavity2d', 'cavity3d', 'cylinder2d', 'cylinder3d']
+
+# runs shorter than this (in seconds) are not compared with the baseline
+MINIMUM_TIME = 1.0E-02
+
+
+def read_inputs():
+  """Parses the command-line."""
+  # create parser
+  parser = argparse.ArgumentParser(description='Runs the benchmark suite and '
+                                               'compares it with a baseline',
+                        formatter_class= argparse.ArgumentDefaultsHelpFormatter)
+  # fill parser with arguments
+  parser.add_argument('--problems', dest='problems', type=str, nargs='+',
+                      default=DEFAULT_PROBLEMS,
+                      choices=sorted(PROBLEMS.keys()),
+                      help='problems to run')
+  parser.add_argument('--parameters', dest='parameters', type=str,
+                      nargs='+', default=[],
+                      help='simulation parameters set in every run, '
+                           'as key=value (e.g. forceScaling=true)')
+  parser.add_argument('--refinements', dest='refinements', type=float,
+                      nargs='+', default=[1.0, 2.0],
+                      help='refinement factors of the grids of the templates')
+  parser.add_argument('--ranks', dest='ranks', type=int, nargs='+',
+                      default=[1, 2, 4],
+                      help='numbers of processes')
+  parser.add_argument('--scaling', dest='scaling', type=str, default='both',
+                      choices=['strong', 'weak', 'both'],
+                      help='strong scaling (fixed grid) and/or weak scaling '
+                           '(grid growing with the number of processes)')
+  parser.add_argument('--steps', dest='steps', type=int, default=20,
+                      help='number of time steps of each run')
+  parser.add_argument('--bin-dir', dest='bin_directory', type=str,
+                      default=os.path.join(os.environ.get('PETIBM_DIR',
+                                                          os.getcwd()), 'bin'),
+                      help='directory of the executables')
+  parser.add_argument('--mpiexec', dest='mpiexec', type=str,
+                      default='mpiexec', help='MPI launcher')
+  parser.add_argument('--petsc-options', dest='petsc_options', type=str,
+                      default='-sys2_pc_type gamg -sys2_pc_gamg_type agg '
+                              '-sys2_pc_gamg_agg_nsmooths 1',
+                      help='options passed to every run')
+  parser.add_argument('--directory', dest='directory', type=str,
+                      default=os.path.join(os.getcwd(), 'bench'),
+                      help='directory of the runs')
+  parser.add_argument('--output', dest='output', type=str,
+                      default='report.json',
+                      help='report of the runs (relative to --directory)')
+  parser.add_argument('--baseline', dest='baseline', type=str,
+                      default='baseline.json',
+                      help='baseline report (relative to --directory)')
+  parser.add_argument('--save-baseline', dest='save_baseline',
+                      action='store_true',
+                      help='stores the report as the new baseline')
+  parser.add_argument('--time-tolerance', dest='time_tolerance', type=float,
+                      default=0.10,
+                      help='relative slowdown of a time above which '
+                           'a run fails')
+  parser.add_argument('--iteration-tolerance', dest='iteration_tolerance',
+                      type=float, default=0.05,
+                      help='relative increase of the mean iteration counts '
+                           'above which a run fails')
+  parser.add_argument('--memory-tolerance', dest='memory_tolerance',
+                      type=float, default=0.10,
+                      help='relative increase of the peak memory above which '
+                           'a run fails')
+  parser.set_defaults(save_baseline=False)
+  return parser.parse_args()
+
+
+def runs_of_suite(args):
+  """Lists the runs of the suite.
+
+  In a strong-scaling run, the grid is refined by the refinement factor.
+  In a weak-scaling run, the grid is also refined so that the number of cells
+  per process stays the same as with the smallest number of processes.
+
+  Returns
+  -------
+  runs: list(dict)
+    Name, problem, scaling, refinement and number of processes of each run.
+  """
+  runs = []
+  scalings = ['strong', 'weak'] if args.scaling == 'both' else [args.scaling]
+  for problem in args.problems:
+    dim = PROBLEMS[problem][1]
+    for scaling in scalings:
+      for refinement in args.refinements:
+        for ranks in args.ranks:
+          if scaling == 'weak':
+            if ranks == min(args.ranks) and 'strong' in scalings:
+              continue  # same run as the strong-scaling one
+            factor = refinement*(float(ranks)/min(args.ranks))**(1.0/dim)
+          else:
+            factor = refinement
+          runs.append({'name': '{}-{}-r{:g}-n{}'.format(problem, scaling,
+                                                        refinement, ranks),
+                       'problem': problem, 'dim': dim, 'scaling': scaling,
+                       'refinement': refinement, 'factor': factor,
+                       'ranks': ranks})
+  return runs
+
+
+def create_case(run, steps, parameters, directory):
+  """Copies the template of a run and refines its grid.
+
+  The number of cells of each sub-domain is multiplied by the refinement
+  factor and its stretching ratio r becomes r**(n/n') (same grading from n
+  to n' cells), the time-step is divided by the factor (same CFL number),
+  no save point is written and the body points are resampled to the new
+  grid spacing.
+  The simulation parameters given as key=value replace those of the template.
+  """
+  template = PROBLEMS[run['problem']][0]
+  if os.path.isdir(directory):
+    shutil.rmtree(directory)
+  os.makedirs(directory)
+  for path in glob.glob(os.path.join(template, '*')):
+    if os.path.isfile(path):
+      shutil.copy(path, directory)
+  factor = run['factor']
+  def refine(match):
+    sub_domain = match.group(0)
+    cells = re.search(r'^(\s*cells:\s*)(\d+)', sub_domain, flags=re.MULTILINE)
+    old_cells = int(cells.group(2))
+    new_cells = max(1, int(round(old_cells*factor)))
+    sub_domain = re.sub(r'^(\s*cells:\s*)\d+', r'\g<1>{}'.format(new_cells),
+                        sub_domain, flags=re.MULTILINE)
+    return re.sub(r'^(\s*stretchRatio:\s*)(\S+)',
+                  lambda m: '{}{!r}'.format(m.group(1),
+                                            float(m.group(2))**(float(old_cells)/new_cells)),
+                  sub_domain, flags=re.MULTILINE)
+  def substitute(name, pattern, replacement):
+    path = os.path.join(directory, name)
+    with open(path, 'r') as infile:
+      text = infile.read()
+    with open(path, 'w') as outfile:
+      outfile.write(re.sub(pattern, replacement, text, flags=re.MULTILINE))
+  # each sub-domain is an item of the list, up to the next item or direction
+  substitute('cartesianMesh.yaml',
+             r'^[ \t]+- end:.*\n(?:(?![ \t]*-).*\n?)*', refine)
+  substitute('simulationParameters.yaml', r'^(\s*dt:\s*)(\S+)',
+             lambda m: '{}{!r}'.format(m.group(1), float(m.group(2))/factor))
+  substitute('simulationParameters.yaml', r'^(\s*startStep:\s*)\S+',
+             r'\g<1>0')
+  substitute('simulationParameters.yaml', r'^(\s*restart:\s*)\S+',
+             r'\g<1>false')
+  substitute('simulationParameters.yaml', r'^(\s*nt:\s*)\S+',
+             r'\g<1>{}'.format(steps))
+  substitute('simulationParameters.yaml', r'^(\s*nsave:\s*)\S+',
+             r'\g<1>{}'.format(steps+1))
+  for parameter in parameters:
+    key, value = parameter.split('=', 1)
+    path = os.path.join(directory, 'simulationParameters.yaml')
+    with open(path, 'r') as infile:
+      text = infile.read()
+    if re.search(r'^\s*{}:'.format(key), text, flags=re.MULTILINE):
+      substitute('simulationParameters.yaml',
+                 r'^(\s*{}:\s*).*$'.format(key), r'\g<1>{}'.format(value))
+    else:
+      substitute('simulationParameters.yaml', r'^(- type: simulation.*)$',
+                 r'\g<1>\n  {}: {}'.format(key, value))
+  if os.path.isfile(os.path.join(directory, 'bodies.yaml')):
+    substitute('bodies.yaml', r'^(- type:.*)$',
+               r'\g<1>\n  pointSpacingRatio: 1.0')
+  # number of cells along each direction (the sub-domains are consecutive)
+  with open(os.path.join(directory, 'cartesianMesh.yaml'), 'r') as infile:
+    text = infile.read()
+  sizes = []
+  for block in re.split(r'^- direction:', text, flags=re.MULTILINE)[1:]:
+    sizes.append(sum(int(n) for n in re.findall(r'^\s*cells:\s*(\d+)', block,
+                                                flags=re.MULTILINE)))
+  return sizes
+
+
+def read_performance_summary(directory):
+  """Reads the wall-time, the stage times and the event times from
+  the PETSc log of a run (maximum over the processes)."""
+  wall_time, stages, events = float('nan'), {}, {}
+  in_stages = in_events = False
+  with open(os.path.join(directory, 'performanceSummary.txt'), 'r') as infile:
+    for line in infile:
+      if line.startswith('Memory usage is given in bytes'):
+        break  # objects of each stage
+      elif line.startswith('Time (sec):'):
+        wall_time = float(line.split()[2])
+      elif line.startswith('Summary of Stages:'):
+        in_stages = True
+      elif line.startswith('--- Event Stage'):
+        in_stages, in_events = False, True
+      elif in_events and line.startswith('----'):
+        in_events = False
+      elif in_stages:
+        match = re.match(r'^\s*\d+:\s*(.+?):\s+(\S+)', line)
+        if match:
+          stages[match.group(1)] = float(match.group(2))
+      elif in_events:
+        columns = line.split()
+        # name, count (max, ratio), time (max, ratio), ...
+        if len(columns) > 4 and columns[1].isdigit():
+          events[columns[0]] = events.get(columns[0], 0.0) + float(columns[3])
+  return wall_time, stages, events
+
+
+def read_iterations(directory):
+  """Returns the mean iteration counts of the linear solvers of a run."""
+  counts = {'ksp1': [], 'ksp2': []}
+  with open(os.path.join(directory, 'telemetry.jsonl'), 'r') as infile:
+    for line in infile:
+      if line.strip():
+        record = json.loads(line)
+        for system in counts:
+          counts[system].append(record[system]['iterations'])
+  return dict((system, float(sum(its))/max(1, len(its)))
+              for system, its in counts.items())
+
+
+def read_memory(log):
+  """Returns the peak memory (in MB) printed at the end of a run."""
+  match = re.search(r'Peak memory: (\S+) MB \(largest process\), '
+                    r'(\S+) MB \(all processes\)', log)
+  if not match:
+    return {}
+  return {'max': float(match.group(1)), 'total': float(match.group(2))}
+
+
+def run_case(run, args):
+  """Runs a case of the suite and collects its measurements."""
+  directory = os.path.join(args.directory, 'runs', run['name'])
+  run['cells'] = create_case(run, args.steps, args.parameters, directory)
+  executable = os.path.join(args.bin_directory, 'PetIBM{}d'.format(run['dim']))
+  command = (args.mpiexec.split() + ['-n', str(run['ranks']), executable,
+                                     '-caseFolder', directory]
+             + args.petsc_options.split())
+  print('[{}] {}'.format(run['name'], ' '.join(command)))
+  start = time.time()
+  process = subprocess.Popen(command, stdout=subprocess.PIPE,
+                             stderr=subprocess.STDOUT)
+  log = process.communicate()[0].decode('utf-8', 'replace')
+  elapsed = time.time() - start
+  with open(os.path.join(directory, 'run.log'), 'w') as outfile:
+    outfile.write(log)
+  run['steps'] = args.steps
+  if process.returncode != 0:
+    run['failed'] = True
+    print('\t-> failed (exit code {}); see {}/run.log'
+          .format(process.returncode, directory))
+    return run
+  run['elapsed'] = elapsed
+  run['wallTime'], run['stages'], run['events'] = \
+      read_performance_summary(directory)
+  run['iterations'] = read_iterations(directory)
+  run['memory'] = read_memory(log)
+  print('\t-> {:.3f} s, {} its (velocity), {} its (Poisson)'
+        .format(run['wallTime'], run['iterations']['ksp1'],
+                run['iterations']['ksp2']))
+  return run
+
+
+def compare(report, baseline, args):
+  """Compares the runs of a report with those of the baseline.
+
+  Returns
+  -------
+  failures: list(str)
+    Descriptions of the measurements above the tolerances.
+  """
+  failures = []
+  reference = dict((run['name'], run) for run in baseline['runs'])
+  def check(name, label, value, ref, tolerance, minimum=0.0):
+    if ref is None or value is None or ref <= minimum:
+      return
+    change = (value - ref)/ref
+    status = 'FAIL' if change > tolerance else 'ok'
+    print('{:<36}{:<28}{:>14.6g}{:>14.6g}{:>10.1%}  {}'
+          .format(name, label, ref, value, change, status))
+    if change > tolerance:
+      failures.append('{}: {} {:.1%} above the baseline'
+                      .format(name, label, change))
+  print('\n{:<36}{:<28}{:>14}{:>14}{:>10}'
+        .format('run', 'measurement', 'baseline', 'current', 'change'))
+  for run in report['runs']:
+    if run['name'] not in reference:
+      print('{:<36}not in the baseline'.format(run['name']))
+      continue
+    ref = reference[run['name']]
+    if run.get('failed'):
+      failures.append('{}: the run failed'.format(run['name']))
+      continue
+    if ref.get('failed'):
+      continue
+    check(run['name'], 'wall-time', run['wallTime'], ref['wallTime'],
+          args.time_tolerance, MINIMUM_TIME)
+    for stage in sorted(run['stages']):
+      check(run['name'], 'stage ' + stage, run['stages'][stage],
+            ref['stages'].get(stage), args.time_tolerance, MINIMUM_TIME)
+    for system in sorted(run['iterations']):
+      check(run['name'], 'iterations ' + system, run['iterations'][system],
+            ref['iterations'].get(system), args.iteration_tolerance)
+    for key in sorted(run['memory']):
+      check(run['name'], 'memory ' + key, run['memory'][key],
+            ref['memory'].get(key), args.memory_tolerance)
+  return failures
+
+
+def main():
+  """Runs the suite, writes the report and compares it with the baseline."""
+  args = read_inputs()
+  if not os.path.isdir(args.directory):
+    os.makedirs(args.directory)
+  report = {'host': socket.gethostname(),
+            'date': time.strftime('%Y-%m-%d %H:%M:%S'),
+            'steps': args.steps,
+            'petscOptions': args.petsc_options,
+            'parameters': args.parameters,
+            'runs': [run_case(run, args) for run in runs_of_suite(args)]}
+  output = os.path.join(args.directory, args.output)
+  with open(output, 'w') as outfile:
+    json.dump(report, outfile, indent=2, sort_keys=True)
+  print('\n[report] {}'.format(output))
+
+  baseline_path = os.path.join(args.directory, args.baseline)
+  if args.save_baseline:
+    shutil.copy(output, baseline_path)
+    print('[baseline] saved in {}'.format(baseline_path))
+    return 0
+  if not os.path.isfile(baseline_path):
+    print('[baseline] {} does not exist; nothing to compare with '
+          '(store one with --save-baseline)'.format(baseline_path))
+    return 0
+  with open(baseline_path, 'r') as infile:
+    baseline = json.load(infile)
+  if baseline['host'] != report['host']:
+    print('[baseline] warning: recorded on {}'.format(baseline['host']))
+  failures = compare(report, baseline, args)
+  if failures:
+    print('\n[baseline] {} regression(s):'.format(len(failures)))
+    for failure in failures:
+      print('\t-> {}'.format(failure))
+    return 1
+  print('\n[baseline] no regression')
+  return 0
+
+
+if __name__ == '__main__':
+  print('\n[{}] START\n'.format(os.path.basename(__file__)))
+  status = main()
+  print('\n[{}] END\n'.format(os.path.basename(__file__)))
+  sys.exit(status)
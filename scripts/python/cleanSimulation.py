@@ -27,12 +27,12 @@ def read_inputs():
   parser.add_argument('--no-solutions', dest='solutions', action='store_false',
                       help='does not remove the numrical solution folders')
   parser.add_argument('--no-forces', dest='forces', action='store_false',
-                      help='does not remove the forces data file')
+                      help='does not remove the forces and moments data files')
   parser.add_argument('--no-vtk', dest='vtk_files', action='store_false',
                       help='does not remove .vtk_files folder')
   parser.add_argument('--no-logs', dest='logs', action='store_false',
                       help='does not remove log files '
-                           '(iterationCount, performanceSummary)')
+                           '(telemetry, iterationCount, performanceSummary)')
   parser.set_defaults(images=True, data=True, grid=True, solutions=True, 
                       forces=True, vtk_files=True, logs=True)
   return parser.parse_args()
@@ -53,11 +53,12 @@ def main():
   if args.solutions:
     paths['solutions'] = '{}/0*'.format(args.case_directory)
   if args.forces:
-    paths['forces'] = '{}/forces.txt'.format(args.case_directory)
+    paths['forces'] = '{0}/forces.txt {0}/moments.txt'.format(args.case_directory)
   if args.vtk_files:
     paths['vtk_files'] = '{}/vtk_files'.format(args.case_directory)
   if args.logs:
-    paths['logs'] = ('{0}/iterationCount.txt '
+    paths['logs'] = ('{0}/telemetry.jsonl '
+                     '{0}/iterationCount.txt '
                      '{0}/performanceSummary.txt'.format(args.case_directory))
   # delete appropriate files/folders
   print('[case-directory] {}'.format(args.case_directory))
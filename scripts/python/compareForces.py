@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+
+# file: compareForces.py
+# author: Anush Krishnan (anush@bu.edu)
+# description: Compares the forces and the cost of several simulations
+#              of the same flow (e.g. with different immersed boundary methods).
+
+
+import os
+import argparse
+
+import numpy
+
+
+def read_inputs():
+  """Parses the command-line."""
+  # create parser
+  parser = argparse.ArgumentParser(description='Compares the forces and the '
+                                               'cost of several simulations',
+                        formatter_class= argparse.ArgumentDefaultsHelpFormatter)
+  # fill parser with arguments
+  parser.add_argument('--cases', dest='case_directories', type=str, nargs='+',
+                      required=True,
+                      help='directories of the simulations '
+                           '(the first one is the reference)')
+  parser.add_argument('--average', '-a', dest='average_limits', type=float,
+                      nargs='+', default=[0.0, float('inf')],
+                      help='temporal limits to consider to average forces')
+  return parser.parse_args()
+
+
+class Case(object):
+  """Contains the forces and the cost of a simulation."""
+  def __init__(self, directory, average_limits):
+    """Reads the forces, the iteration counts and the wall-time.
+
+    Parameters
+    ----------
+    directory: str
+      Directory of the simulation.
+    average_limits: list of floats
+      Temporal limits to consider to average forces.
+    """
+    self.name = os.path.basename(os.path.normpath(directory))
+    # forces of the first body
+    with open('{}/forces.txt'.format(directory), 'r') as infile:
+      data = numpy.loadtxt(infile, dtype=float).transpose()
+    t = data[0]
+    mask = numpy.where(numpy.logical_and(t >= average_limits[0],
+                                         t <= average_limits[1]))[0]
+    self.fx = data[1][mask]
+    self.fy = data[2][mask]
+    # iterations of the Poisson solver
+    with open('{}/iterationCount.txt'.format(directory), 'r') as infile:
+      iterations = numpy.loadtxt(infile, dtype=float).transpose()
+    self.poisson_iterations = iterations[2].mean()
+    # wall-time from the PETSc log
+    self.wall_time = float('nan')
+    with open('{}/performanceSummary.txt'.format(directory), 'r') as infile:
+      for line in infile:
+        if line.startswith('Time (sec):'):
+          self.wall_time = float(line.split()[2])
+          break
+
+  def values(self):
+    """Returns the mean drag, the mean lift, the amplitude of the lift,
+    the mean number of Poisson iterations and the wall-time."""
+    return [self.fx.mean(), self.fy.mean(), 0.5*(self.fy.max()-self.fy.min()),
+            self.poisson_iterations, self.wall_time]
+
+
+def main():
+  """Prints the forces and the cost of each case relative to the first one."""
+  args = read_inputs()
+  cases = [Case(directory, args.average_limits)
+           for directory in args.case_directories]
+  labels = ['<fx>', '<fy>', 'fy amplitude', 'Poisson its', 'wall-time (s)']
+  reference = cases[0].values()
+  print('\n{:<30}'.format('case')
+        + ''.join(['{:>16}'.format(label) for label in labels]))
+  for case in cases:
+    values = case.values()
+    print('{:<30}'.format(case.name)
+          + ''.join(['{:>16.6g}'.format(value) for value in values]))
+    if case is not cases[0]:
+      differences = [(value-ref)/abs(ref) if ref != 0.0 else float('nan')
+                     for value, ref in zip(values, reference)]
+      print('{:<30}'.format('  relative to reference')
+            + ''.join(['{:>16.3%}'.format(d) for d in differences]))
+
+
+if __name__ == '__main__':
+  print('\n[{}] START\n'.format(os.path.basename(__file__)))
+  main()
+  print('\n[{}] END\n'.format(os.path.basename(__file__)))
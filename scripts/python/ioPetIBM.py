@@ -7,6 +7,7 @@
 
 import os
 import sys
+import struct
 
 import numpy
 sys.path.append(os.path.join(os.environ['PETSC_DIR'], 'bin', 'pythonscripts'))
@@ -48,6 +49,85 @@ def get_time_steps(case_directory, time_steps_range=[]):
                               if folder[0] == '0')
 
 
+def read_encoded_values(file_path):
+  """Reads the values of a flow variable written in reduced or compressed
+  form (file <name>.enc).
+
+  Parameters
+  ----------
+  file_path: str
+    Path of the file.
+
+  Returns
+  -------
+  values: Numpy array
+    Values of the variable in the natural ordering.
+  """
+  SINGLE_PRECISION, LOSSLESS, ERROR_BOUNDED = 1, 2, 3
+  with open(file_path, 'rb') as infile:
+    data = infile.read()
+  assert data[:8] == b'PETIBMEF'
+  encoding, num_chunks = struct.unpack_from('=ii', data, 8)
+  size, tolerance = struct.unpack_from('=qd', data, 16)
+  chunks = struct.unpack_from('={}q'.format(2*num_chunks), data, 32)
+  position = 32 + 16*num_chunks
+  values = numpy.empty(size, dtype=numpy.float64)
+  start = 0
+  for num_values, num_bytes in zip(chunks[0::2], chunks[1::2]):
+    chunk = bytearray(data[position:position+num_bytes])
+    position += num_bytes
+    if encoding == SINGLE_PRECISION:
+      values[start:start+num_values] = numpy.frombuffer(bytes(chunk), dtype=numpy.float32)
+    elif encoding == LOSSLESS:
+      previous, k = 0, 0
+      bits = numpy.empty(num_values, dtype=numpy.uint64)
+      for i in range(num_values):
+        for j in range(chunk[k]):
+          previous ^= chunk[k+1+j] << (8*j)
+        bits[i] = previous
+        k += 1 + chunk[k]
+      values[start:start+num_values] = bits.view(numpy.float64)
+    elif encoding == ERROR_BOUNDED:
+      current, k = 0, 0
+      for i in range(num_values):
+        zigzag, shift = 0, 0
+        while True:
+          byte = chunk[k]
+          k += 1
+          zigzag |= (byte & 0x7f) << shift
+          shift += 7
+          if not byte & 0x80:
+            break
+        current += (zigzag >> 1) ^ -(zigzag & 1)
+        values[start+i] = current*2.0*tolerance
+    else:
+      values[start:start+num_values] = numpy.frombuffer(bytes(chunk), dtype=numpy.float64)
+    start += num_values
+  return values
+
+
+def read_field_values(time_step_directory, name):
+  """Reads the values of a flow variable at a save point, from the PETSc
+  binary file <name>.dat or, if absent, from the encoded file <name>.enc.
+
+  Parameters
+  ----------
+  time_step_directory: str
+    Folder of the save point.
+  name: str
+    Name of the variable (qx, qy, qz, phi).
+
+  Returns
+  -------
+  values: Numpy array
+    Values of the variable in the natural ordering.
+  """
+  file_path = '{}/{}.dat'.format(time_step_directory, name)
+  if os.path.isfile(file_path):
+    return PetscBinaryIO.PetscBinaryIO().readBinaryFile(file_path)[0]
+  return read_encoded_values('{}/{}.enc'.format(time_step_directory, name))
+
+
 def read_grid(case_directory):
   """Reads the coordinates from the file grid.txt.
 
@@ -98,11 +178,9 @@ def read_velocity(case_directory, time_step, coords, periodic=[]):
   # folder with numerical solution
   time_step_directory = '{}/{:0>7}'.format(case_directory, time_step)
   # read x-flux
-  flux_path = '{}/qx.dat'.format(time_step_directory)
-  qx = PetscBinaryIO.PetscBinaryIO().readBinaryFile(flux_path)[0]
+  qx = read_field_values(time_step_directory, 'qx')
   # read y-flux
-  flux_path = '{}/qy.dat'.format(time_step_directory)
-  qy = PetscBinaryIO.PetscBinaryIO().readBinaryFile(flux_path)[0]
+  qy = read_field_values(time_step_directory, 'qy')
   # get velocity nodes coordinates
   xu, yu = x[1:-1], 0.5*(y[:-1]+y[1:])
   xv, yv = 0.5*(x[:-1]+x[1:]), y[1:-1]
@@ -120,8 +198,7 @@ def read_velocity(case_directory, time_step, coords, periodic=[]):
     v = ( qy[:, :(-1 if 'y' in periodic else None), :]
           /reduce(numpy.multiply, numpy.ix_(dz, numpy.ones(ny-1), dx)) )
     # read z-flux
-    flux_path = '{}/qz.dat'.format(time_step_directory)
-    qz = PetscBinaryIO.PetscBinaryIO().readBinaryFile(flux_path)[0]
+    qz = read_field_values(time_step_directory, 'qz')
     # get coordinates of z-velocity nodes
     xw, yw, zw = 0.5*(x[:-1]+x[1:]), 0.5*(y[:-1]+y[1:]), z[1:-1]
     # compute z-velocity field
@@ -172,8 +249,7 @@ def read_pressure(case_directory, time_step, coords):
   # folder with numerical solution
   time_step_directory = '{}/{:0>7}'.format(case_directory, time_step)
   # pressure
-  pressure_path = '{}/phi.dat'.format(time_step_directory)
-  p = PetscBinaryIO.PetscBinaryIO().readBinaryFile(pressure_path)[0]
+  p = read_field_values(time_step_directory, 'phi')
   # get pressure nodes coordinates
   xp, yp = 0.5*(x[:-1]+x[1:]), 0.5*(y[:-1]+y[1:])
   nx, ny = xp.size, yp.size
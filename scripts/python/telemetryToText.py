@@ -0,0 +1,84 @@
+#!/usr/bin/env python
+
+# file: telemetryToText.py
+# author: Anush Krishnan (anush@bu.edu)
+# description: Generates the files iterationCount.txt, forces.txt and
+#              moments.txt from the telemetry log of a simulation.
+
+
+import os
+import json
+import argparse
+
+
+def read_inputs():
+  """Parses the command-line."""
+  # create parser
+  parser = argparse.ArgumentParser(description='Generates the text logs '
+                                               '(iterations, forces, moments) '
+                                               'from the telemetry log',
+                        formatter_class= argparse.ArgumentDefaultsHelpFormatter)
+  # fill parser with arguments
+  parser.add_argument('--case', dest='case_directory', type=str,
+                      default=os.getcwd(), help='directory of the simulation')
+  parser.add_argument('--stages', dest='stages', action='store_true',
+                      help='also writes the wall time of each stage '
+                           'in stageTimes.txt')
+  parser.set_defaults(stages=False)
+  return parser.parse_args()
+
+
+def read_telemetry(case_directory):
+  """Reads the records of the telemetry log.
+
+  Parameters
+  ----------
+  case_directory: str
+    Directory of the simulation.
+
+  Returns
+  -------
+  records: list(dict)
+    One record per time step.
+  """
+  records = []
+  with open('{}/telemetry.jsonl'.format(case_directory), 'r') as infile:
+    for line in infile:
+      if line.strip():
+        records.append(json.loads(line))
+  return records
+
+
+def main():
+  """Writes the text logs of a simulation from its telemetry log."""
+  # parse command-line
+  args = read_inputs()
+  records = read_telemetry(args.case_directory)
+  print('[case-directory] {}'.format(args.case_directory))
+  print('\t-> {} time steps'.format(len(records)))
+  with open('{}/iterationCount.txt'.format(args.case_directory), 'w') as outfile:
+    for record in records:
+      outfile.write('{}\t{}\t{}\n'.format(record['step'],
+                                          record['ksp1']['iterations'],
+                                          record['ksp2']['iterations']))
+  if records and 'forces' in records[0]:
+    for name in ['forces', 'moments']:
+      with open('{}/{}.txt'.format(args.case_directory, name), 'w') as outfile:
+        for record in records:
+          outfile.write('\t'.join(repr(value) for value in
+                                  [record['time']] + record[name]) + '\n')
+  if args.stages:
+    stages = ['solveIntermediateVelocity', 'solvePoissonSystem',
+              'projectionStep']
+    with open('{}/stageTimes.txt'.format(args.case_directory), 'w') as outfile:
+      for record in records:
+        outfile.write('\t'.join(repr(value) for value in
+                                [record['step']] +
+                                [record['wallTime'][stage]
+                                 for stage in stages]) + '\n')
+
+
+if __name__ == '__main__':
+  print('\n[{}] START\n'.format(os.path.basename(__file__)))
+  main()
+  print('\n[{}] END\n'.format(os.path.basename(__file__)))
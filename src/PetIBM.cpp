@@ -27,6 +27,11 @@ int main(int argc,char **argv)
   char           caseFolder[PETSC_MAX_PATH_LEN];
   
   ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
+  // the peak memory of the processes is printed at the end of the run
+  ierr = PetscMemorySetGetMaximumUsage(); CHKERRQ(ierr);
+  // the stages and events are timed for the performance summary
+  // (written in performanceSummary.txt, without the need of -log_summary)
+  ierr = PetscLogBegin(); CHKERRQ(ierr);
 
   ierr = PetscOptionsGetString(NULL, "-caseFolder", caseFolder, sizeof(caseFolder), NULL); CHKERRQ(ierr);
 
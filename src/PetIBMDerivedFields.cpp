@@ -0,0 +1,74 @@
+/***************************************************************************//**
+ * \file PetIBMDerivedFields.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Main source-file of the post-processor that writes the vorticity,
+ *        the Q-criterion and the divergence of saved time steps.
+ *
+ * Usage:
+ *
+ *     mpiexec -n <np> PetIBMDerivedFields3d -caseFolder <folder> -timeStep <first>
+ *                     [-lastTimeStep <last>] [-every <n>]
+ *
+ * The time steps from `first` to `last` (default: `first`), every `n`
+ * (default: `nsave`), are read from the output of the simulation (folders or
+ * container) and their derived fields are written in the folders of the save
+ * points. The domain is decomposed as in the simulation.
+ */
+
+
+#include "NavierStokesSolver.h"
+
+#ifndef DIMENSIONS
+#define DIMENSIONS 2
+#endif
+
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  const PetscInt dim = DIMENSIONS;
+  char           caseFolder[PETSC_MAX_PATH_LEN];
+  PetscInt       firstStep = 0,
+                 lastStep,
+                 every;
+  PetscBool      found;
+
+  ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
+
+  ierr = PetscOptionsGetString(NULL, "-caseFolder", caseFolder, sizeof(caseFolder), NULL); CHKERRQ(ierr);
+
+  std::string          folder(caseFolder);
+  FlowDescription      FD(folder+"/flowDescription.yaml");
+  CartesianMesh        CM(folder+"/cartesianMesh.yaml");
+  SimulationParameters SP(folder+"/simulationParameters.yaml");
+
+  ierr = PetscOptionsGetInt(NULL, "-timeStep", &firstStep, &found); CHKERRQ(ierr);
+  if(!found)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_WRONG, "Option -timeStep is required");
+  }
+  lastStep = firstStep;
+  every = SP.nsave;
+  ierr = PetscOptionsGetInt(NULL, "-lastTimeStep", &lastStep, NULL); CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL, "-every", &every, NULL); CHKERRQ(ierr);
+  if(every < 1)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "Option -every must be positive");
+  }
+
+  // the fluxes are read as when the simulation is restarted
+  SP.restart = PETSC_TRUE;
+  SP.startStep = firstStep;
+
+  NavierStokesSolver<dim> solver(folder, &FD, &SP, &CM);
+
+  ierr = solver.initializePostProcessing(); CHKERRQ(ierr);
+  for(PetscInt step=firstStep; step<=lastStep; step+=every)
+  {
+    ierr = solver.postProcess(step); CHKERRQ(ierr);
+  }
+  ierr = solver.finalizePostProcessing(); CHKERRQ(ierr);
+
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+  return 0;
+}
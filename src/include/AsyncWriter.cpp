@@ -0,0 +1,181 @@
+/***************************************************************************//**
+ * \file AsyncWriter.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the class \c AsyncWriter.
+ */
+
+
+#include "AsyncWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <petscvec.h>
+
+
+/**
+ * \brief Reverses the bytes of each word of an array (PETSc binary files are
+ *        big-endian).
+ */
+static void toBigEndian(char *data, size_t wordSize, size_t numWords)
+{
+#if !defined(PETSC_WORDS_BIGENDIAN)
+  for(size_t i=0; i<numWords; i++)
+    std::reverse(data + i*wordSize, data + (i+1)*wordSize);
+#endif
+}
+
+/**
+ * \brief Writes a buffer at a given position of a file.
+ */
+static bool writeAt(int fd, const char *data, size_t length, off_t position)
+{
+  while(length > 0)
+  {
+    ssize_t written = pwrite(fd, data, length, position);
+    if(written < 0)
+    {
+      if(errno == EINTR)
+        continue;
+      return false;
+    }
+    data += written;
+    length -= written;
+    position += written;
+  }
+  return true;
+}
+
+/**
+ * \brief Constructor -- Starts the background thread.
+ */
+AsyncWriter::AsyncWriter(PetscInt maxSnapshots) : maxSnapshots(std::max<PetscInt>(1, maxSnapshots)), inFlight(0), stop(PETSC_FALSE)
+{
+  thread = std::thread(&AsyncWriter::run, this);
+}
+
+/**
+ * \brief Destructor -- Writes the pending save points and stops the thread.
+ */
+AsyncWriter::~AsyncWriter()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    stop = PETSC_TRUE;
+  }
+  queueChanged.notify_all();
+  thread.join();
+}
+
+/**
+ * \brief Stages a record of the current save point (the values are moved).
+ */
+void AsyncWriter::add(AsyncRecord &record)
+{
+  staged.push_back(AsyncRecord());
+  std::swap(staged.back(), record);
+}
+
+/**
+ * \brief Hands the staged save point over to the background thread.
+ *
+ * Waits until fewer than `maxSnapshots` save points are in flight.
+ */
+PetscErrorCode AsyncWriter::submit()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  if(!error.empty())
+  {
+    SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Background writing failed: %s", error.c_str());
+  }
+  if(staged.empty())
+    return 0;
+  while(inFlight >= maxSnapshots)
+    queueChanged.wait(lock);
+  queue.push_back(std::vector<AsyncRecord>());
+  queue.back().swap(staged);
+  inFlight++;
+  lock.unlock();
+  queueChanged.notify_all();
+
+  return 0;
+}
+
+/**
+ * \brief Waits for all the submitted save points to be written.
+ */
+PetscErrorCode AsyncWriter::drain()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while(inFlight > 0)
+    queueChanged.wait(lock);
+  if(!error.empty())
+  {
+    SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Background writing failed: %s", error.c_str());
+  }
+
+  return 0;
+}
+
+void AsyncWriter::run()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while(true)
+  {
+    while(queue.empty() && !stop)
+      queueChanged.wait(lock);
+    if(queue.empty())
+      break;
+
+    // write the oldest save point without holding the lock
+    std::vector<AsyncRecord> &snapshot = queue.front();
+    lock.unlock();
+    std::string message;
+    for(size_t i=0; i<snapshot.size() && message.empty(); i++)
+      message = write(snapshot[i]);
+    lock.lock();
+
+    if(!message.empty() && error.empty())
+      error = message;
+    queue.pop_front();
+    inFlight--;
+    queueChanged.notify_all();
+  }
+}
+
+/**
+ * \brief Writes a record as `VecView` does with a binary viewer: the class id
+ *        and the size of the vector, followed by its values.
+ */
+std::string AsyncWriter::write(AsyncRecord &record)
+{
+  int fd = open(record.fileName.c_str(), O_WRONLY | O_CREAT, 0644);
+  if(fd < 0)
+    return record.fileName + ": " + strerror(errno);
+
+  bool      success = true;
+  PetscInt  header[2] = {VEC_FILE_CLASSID, record.size};
+  size_t    headerSize = sizeof(header);
+  if(record.header)
+  {
+    toBigEndian(reinterpret_cast<char *>(header), sizeof(PetscInt), 2);
+    success = writeAt(fd, reinterpret_cast<char *>(header), headerSize, record.offset);
+  }
+  if(success && !record.values.empty())
+  {
+    toBigEndian(reinterpret_cast<char *>(&record.values[0]), sizeof(PetscScalar), record.values.size());
+    success = writeAt(fd, reinterpret_cast<char *>(&record.values[0]), record.values.size()*sizeof(PetscScalar), record.offset + headerSize + record.start*sizeof(PetscScalar));
+  }
+  std::string message = (success)? "" : record.fileName + ": " + strerror(errno);
+  if(close(fd) != 0 && success)
+    message = record.fileName + ": " + strerror(errno);
+
+  return message;
+}
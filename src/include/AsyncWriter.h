@@ -0,0 +1,79 @@
+/***************************************************************************//**
+ * \file AsyncWriter.h
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Definition of the class \c AsyncWriter.
+ */
+
+
+#if !defined(ASYNC_WRITER_H)
+#define ASYNC_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <petscsys.h>
+
+
+/**
+ * \brief Portion of a vector owned by a process, staged to be written in the
+ *        PETSc binary format.
+ */
+struct AsyncRecord
+{
+  std::string fileName;           ///< file in which the vector is written
+  PetscInt64  offset;             ///< position of the vector in the file (bytes)
+  PetscInt    size;               ///< global size of the vector
+  PetscInt    start;              ///< global index of the first local value
+  PetscBool   header;             ///< write the class id and the size of the vector
+  std::vector<PetscScalar> values; ///< local values, in the order of the file
+};
+
+/**
+ * \brief Writes the save points with a background thread.
+ *
+ * The records of a save point are staged with \c add and handed over to the
+ * thread with \c submit. Each process writes its own portion of the vectors
+ * directly at its position in the files, so that the thread never calls PETSc
+ * or MPI. At most `maxSnapshots` save points are held in memory: \c submit
+ * waits for the oldest one to be written when the limit is reached.
+ */
+class AsyncWriter
+{
+public:
+  AsyncWriter(PetscInt maxSnapshots);
+  ~AsyncWriter();
+
+  // stage a record of the current save point
+  void add(AsyncRecord &record);
+
+  // hand the staged save point over to the background thread
+  PetscErrorCode submit();
+
+  // wait for all the submitted save points to be written
+  PetscErrorCode drain();
+
+private:
+  PetscInt maxSnapshots;
+
+  std::vector<AsyncRecord>              staged;
+  std::deque< std::vector<AsyncRecord> > queue;
+  PetscInt                              inFlight;
+  PetscBool                             stop;
+  std::string                           error;
+
+  std::mutex              mutex;
+  std::condition_variable queueChanged;
+  std::thread             thread;
+
+  // loop of the background thread
+  void run();
+
+  // write a record; returns an error message on failure
+  std::string write(AsyncRecord &record);
+};
+
+#endif
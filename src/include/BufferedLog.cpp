@@ -0,0 +1,66 @@
+/***************************************************************************//**
+ * \file BufferedLog.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the class \c BufferedLog.
+ */
+
+
+#include "BufferedLog.h"
+
+#include <algorithm>
+#include <fstream>
+
+
+/**
+ * \brief Constructor -- Creates the file, or keeps its content if `append`
+ *        is set (restarted simulation).
+ */
+BufferedLog::BufferedLog(std::string fileName, PetscInt flushInterval, PetscBool append) : fileName(fileName), flushInterval(std::max<PetscInt>(1, flushInterval)), numLines(0)
+{
+  std::ofstream file(fileName.c_str(), (append)? std::ios::out | std::ios::app : std::ios::out);
+}
+
+/**
+ * \brief Destructor -- Writes the remaining lines.
+ */
+BufferedLog::~BufferedLog()
+{
+  flush();
+}
+
+/**
+ * \brief Adds a line to the buffer, and writes the buffer when it holds
+ *        `flushInterval` lines.
+ */
+PetscErrorCode BufferedLog::addLine(const std::string &line)
+{
+  PetscErrorCode ierr;
+
+  buffer += line;
+  buffer += '\n';
+  numLines++;
+  if(numLines >= flushInterval)
+  {
+    ierr = flush(); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+PetscErrorCode BufferedLog::flush()
+{
+  if(buffer.empty())
+    return 0;
+
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::app);
+  file << buffer;
+  file.close();
+  if(!file)
+  {
+    SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Unable to write the file %s", fileName.c_str());
+  }
+  buffer.clear();
+  numLines = 0;
+
+  return 0;
+}
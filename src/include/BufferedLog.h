@@ -0,0 +1,42 @@
+/***************************************************************************//**
+ * \file BufferedLog.h
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Definition of the class \c BufferedLog.
+ */
+
+
+#if !defined(BUFFERED_LOG_H)
+#define BUFFERED_LOG_H
+
+#include <string>
+
+#include <petscsys.h>
+
+
+/**
+ * \brief Text file written by blocks of lines.
+ *
+ * The lines are kept in memory and appended to the file every
+ * `flushInterval` lines, and when the log is destroyed, so that the file is
+ * not reopened at every time step.
+ */
+class BufferedLog
+{
+public:
+  BufferedLog(std::string fileName, PetscInt flushInterval, PetscBool append);
+  ~BufferedLog();
+
+  // add a line (without its end-of-line character)
+  PetscErrorCode addLine(const std::string &line);
+
+  // append the buffered lines to the file
+  PetscErrorCode flush();
+
+private:
+  std::string fileName;
+  PetscInt    flushInterval,
+              numLines;
+  std::string buffer;
+};
+
+#endif
@@ -0,0 +1,96 @@
+/***************************************************************************//**
+ * \file DeltaFunctions.h
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Definition of the discrete delta kernels used to transfer quantities
+ *        between the Eulerian grid and the Lagrangian body points.
+ */
+
+
+#if !defined(DELTA_FUNCTIONS_H)
+#define DELTA_FUNCTIONS_H
+
+#include <cmath>
+
+#include <petscsys.h>
+
+
+/**
+ * \class RomaDelta
+ * \brief Three-point discrete delta function (Roma et al., 1999).
+ *
+ * \f[ \phi(r) = \frac{1}{3}\left(1 + \sqrt{1-3r^2}\right), \quad 0 \le r \le 1/2 \f]
+ * \f[ \phi(r) = \frac{1}{6}\left(5 - 3r - \sqrt{1-3(1-r)^2}\right), \quad 1/2 < r \le 3/2 \f]
+ */
+struct RomaDelta
+{
+  /// half-width of the kernel in number of cells
+  static PetscReal support() { return 1.5; }
+
+  /// value of the one-dimensional kernel at the normalized distance \c r
+  static inline PetscReal phi(PetscReal r)
+  {
+    if(r > 1.5) return 0.0;
+    if(r > 0.5) return (5.0 - 3.0*r - sqrt(1.0 - 3.0*(1.0-r)*(1.0-r)))/6.0;
+    return (1.0 + sqrt(1.0 - 3.0*r*r))/3.0;
+  }
+};
+
+/**
+ * \class PeskinDelta4
+ * \brief Four-point discrete delta function (Peskin, 2002).
+ *
+ * \f[ \phi(r) = \frac{1}{8}\left(3 - 2r + \sqrt{1+4r-4r^2}\right), \quad 0 \le r \le 1 \f]
+ * \f[ \phi(r) = \frac{1}{8}\left(5 - 2r - \sqrt{-7+12r-4r^2}\right), \quad 1 < r \le 2 \f]
+ */
+struct PeskinDelta4
+{
+  /// half-width of the kernel in number of cells
+  static PetscReal support() { return 2.0; }
+
+  /// value of the one-dimensional kernel at the normalized distance \c r
+  static inline PetscReal phi(PetscReal r)
+  {
+    if(r > 2.0) return 0.0;
+    if(r > 1.0) return (5.0 - 2.0*r - sqrt(-7.0 + 12.0*r - 4.0*r*r))/8.0;
+    return (3.0 - 2.0*r + sqrt(1.0 + 4.0*r - 4.0*r*r))/8.0;
+  }
+};
+
+/**
+ * \class BSplineDelta6
+ * \brief Six-point discrete delta function built from the quintic B-spline.
+ *
+ * \f[ \phi(r) = \frac{1}{120}\left((3-r)_+^5 - 6(2-r)_+^5 + 15(1-r)_+^5\right) \f]
+ *
+ * The kernel is polynomial, so its evaluation does not require any square root.
+ */
+struct BSplineDelta6
+{
+  /// half-width of the kernel in number of cells
+  static PetscReal support() { return 3.0; }
+
+  /// value of the one-dimensional kernel at the normalized distance \c r
+  static inline PetscReal phi(PetscReal r)
+  {
+    if(r >= 3.0) return 0.0;
+    PetscReal a = 3.0-r, b = 2.0-r, c = 1.0-r;
+    PetscReal value = a*a*a*a*a;
+    if(r < 2.0) value -= 6.0*b*b*b*b*b;
+    if(r < 1.0) value += 15.0*c*c*c*c*c;
+    return value/120.0;
+  }
+};
+
+/**
+ * \brief One-dimensional discrete delta function of width \c h.
+ *
+ * \param x distance between the grid node and the body point
+ * \param h grid-spacing
+ */
+template <typename Kernel>
+inline PetscReal dh(PetscReal x, PetscReal h)
+{
+  return Kernel::phi(fabs(x)/h)/h;
+}
+
+#endif
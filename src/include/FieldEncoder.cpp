@@ -0,0 +1,171 @@
+/***************************************************************************//**
+ * \file FieldEncoder.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the functions that encode and decode the values
+ *        of a flow variable.
+ */
+
+
+#include "FieldEncoder.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <stdint.h>
+
+// largest quantized value of ERROR_BOUNDED (the differences fit in 52 bits)
+static const int64_t MAX_QUANTIZED = (int64_t)1 << 50;
+
+/**
+ * \brief Appends an unsigned integer, 7 bits per byte.
+ */
+static void appendVarint(uint64_t value, std::vector<char> &bytes)
+{
+  while(value >= 0x80)
+  {
+    bytes.push_back((char)((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  bytes.push_back((char)value);
+}
+
+
+void encodeValues(FieldEncoding encoding, PetscReal tolerance, const PetscReal *values, size_t numValues, std::vector<char> &bytes)
+{
+  switch(encoding)
+  {
+    case SINGLE_PRECISION:
+    {
+      size_t start = bytes.size();
+      bytes.resize(start + numValues*sizeof(float));
+      for(size_t i=0; i<numValues; i++)
+      {
+        float value = (float)values[i];
+        memcpy(&bytes[start + i*sizeof(float)], &value, sizeof(float));
+      }
+      break;
+    }
+    case LOSSLESS:
+    {
+      uint64_t previous = 0, current, bits;
+      for(size_t i=0; i<numValues; i++)
+      {
+        memcpy(&current, &values[i], sizeof(uint64_t));
+        bits = current ^ previous;
+        previous = current;
+        char numBytes = 0;
+        while(numBytes < 8 && (bits >> (8*numBytes)) != 0)
+          numBytes++;
+        bytes.push_back(numBytes);
+        for(char k=0; k<numBytes; k++)
+          bytes.push_back((char)((bits >> (8*k)) & 0xff));
+      }
+      break;
+    }
+    case ERROR_BOUNDED:
+    {
+      PetscReal step = 2.0*tolerance;
+      int64_t   previous = 0, current;
+      uint64_t  zigzag;
+      for(size_t i=0; i<numValues; i++)
+      {
+        // values that are not finite, too large for the quantization, or
+        // whose multiple of the step misses the bound are escaped (code 0)
+        // and stored verbatim
+        PetscReal quotient = values[i]/step;
+        if(!std::isfinite(quotient) || fabs(quotient) >= MAX_QUANTIZED
+           || !(fabs(llround(quotient)*step - values[i]) <= tolerance))
+        {
+          bytes.push_back(0);
+          size_t start = bytes.size();
+          bytes.resize(start + sizeof(PetscReal));
+          memcpy(&bytes[start], &values[i], sizeof(PetscReal));
+          continue;
+        }
+        current = (int64_t)llround(quotient);
+        // zigzag mapping of the difference, shifted by one for the escape code
+        zigzag = ((uint64_t)(current - previous) << 1) ^ (uint64_t)((current - previous) >> 63);
+        previous = current;
+        appendVarint(zigzag + 1, bytes);
+      }
+      break;
+    }
+    default:
+    {
+      size_t start = bytes.size();
+      bytes.resize(start + numValues*sizeof(PetscReal));
+      memcpy(&bytes[start], values, numValues*sizeof(PetscReal));
+      break;
+    }
+  }
+}
+
+size_t decodeValues(FieldEncoding encoding, PetscReal tolerance, const char *bytes, size_t numValues, PetscReal *values)
+{
+  const unsigned char *data = reinterpret_cast<const unsigned char *>(bytes);
+  size_t              position = 0;
+
+  switch(encoding)
+  {
+    case SINGLE_PRECISION:
+    {
+      float value;
+      for(size_t i=0; i<numValues; i++)
+      {
+        memcpy(&value, data + i*sizeof(float), sizeof(float));
+        values[i] = value;
+      }
+      position = numValues*sizeof(float);
+      break;
+    }
+    case LOSSLESS:
+    {
+      uint64_t previous = 0, bits;
+      for(size_t i=0; i<numValues; i++)
+      {
+        unsigned char numBytes = data[position++];
+        bits = 0;
+        for(unsigned char k=0; k<numBytes; k++)
+          bits |= (uint64_t)data[position++] << (8*k);
+        previous ^= bits;
+        memcpy(&values[i], &previous, sizeof(uint64_t));
+      }
+      break;
+    }
+    case ERROR_BOUNDED:
+    {
+      PetscReal step = 2.0*tolerance;
+      int64_t   current = 0;
+      uint64_t  zigzag;
+      for(size_t i=0; i<numValues; i++)
+      {
+        zigzag = 0;
+        for(int shift=0; ; shift+=7)
+        {
+          unsigned char byte = data[position++];
+          zigzag |= (uint64_t)(byte & 0x7f) << shift;
+          if(!(byte & 0x80))
+            break;
+        }
+        if(zigzag == 0)
+        {
+          memcpy(&values[i], data + position, sizeof(PetscReal));
+          position += sizeof(PetscReal);
+          continue;
+        }
+        zigzag--;
+        current += (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+        values[i] = current*step;
+      }
+      break;
+    }
+    default:
+    {
+      memcpy(values, data, numValues*sizeof(PetscReal));
+      position = numValues*sizeof(PetscReal);
+      break;
+    }
+  }
+
+  return position;
+}
@@ -0,0 +1,47 @@
+/***************************************************************************//**
+ * \file FieldEncoder.h
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Declaration of the functions that encode and decode the values of
+ *        a flow variable in reduced or compressed form.
+ */
+
+
+#if !defined(FIELD_ENCODER_H)
+#define FIELD_ENCODER_H
+
+#include <cstddef>
+#include <vector>
+
+#include <petscsys.h>
+
+#include "types.h"
+
+
+/**
+ * \brief Appends the encoded values of an array to a byte buffer.
+ *
+ * - `SINGLE_PRECISION`: the values as 4-byte floats.
+ * - `LOSSLESS`: each value is XOR-ed with the previous one; the result is
+ *   stored as its number of non-zero low-order bytes (1 byte) followed by
+ *   those bytes. Neighbouring values of a smooth field share their sign,
+ *   exponent and leading digits, which are the high-order bytes; the gain is
+ *   modest (about 8% on a smooth field with small-scale fluctuations, since
+ *   the low-order bytes of the mantissa are noise).
+ * - `ERROR_BOUNDED`: each value is rounded to the nearest multiple of
+ *   `2*tolerance` (absolute error at most `tolerance`); the differences
+ *   between consecutive multiples are stored as variable-length integers.
+ *   Values that cannot be quantized within the bound (not finite, or larger
+ *   than 2^50 steps) are escaped and stored verbatim.
+ *
+ * The bytes are in the byte order of the machine (little-endian on x86).
+ */
+void encodeValues(FieldEncoding encoding, PetscReal tolerance, const PetscReal *values, size_t numValues, std::vector<char> &bytes);
+
+/**
+ * \brief Decodes `numValues` values encoded by \c encodeValues.
+ *
+ * \return the number of bytes read
+ */
+size_t decodeValues(FieldEncoding encoding, PetscReal tolerance, const char *bytes, size_t numValues, PetscReal *values);
+
+#endif
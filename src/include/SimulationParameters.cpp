@@ -7,7 +7,9 @@
 
 #include "SimulationParameters.h"
 
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 
 #include "yaml-cpp/yaml.h"
 
@@ -37,9 +39,114 @@ SolverType solverTypeFromString(std::string s)
     return NAVIER_STOKES;
   if (s == "TAIRA_COLONIUS")
     return TAIRA_COLONIUS;
+  if (s == "DIRECT_FORCING")
+    return DIRECT_FORCING;
+  if (s == "NULL_SPACE")
+    return NULL_SPACE;
   return NAVIER_STOKES;
 }
 
+/**
+ * \brief Converts \c std::string to \c DeltaFunctionType.
+ */
+DeltaFunctionType deltaFunctionFromString(std::string s)
+{
+  if (s == "ROMA_ET_AL")
+    return ROMA_ET_AL;
+  if (s == "PESKIN_4")
+    return PESKIN_4;
+  if (s == "BSPLINE_6")
+    return BSPLINE_6;
+  return ROMA_ET_AL;
+}
+
+/**
+ * \brief Converts \c std::string to \c DecompositionType.
+ */
+DecompositionType decompositionFromString(std::string s)
+{
+  if (s == "UNIFORM")
+    return UNIFORM;
+  if (s == "BODY_WEIGHTED")
+    return BODY_WEIGHTED;
+  return UNIFORM;
+}
+
+/**
+ * \brief Converts \c std::string to \c ForceSolverType.
+ */
+ForceSolverType forceSolverFromString(std::string s)
+{
+  if (s == "COUPLED")
+    return COUPLED;
+  if (s == "SCHUR_COMPLEMENT")
+    return SCHUR_COMPLEMENT;
+  return COUPLED;
+}
+
+/**
+ * \brief Converts \c std::string to \c OutputFormat.
+ */
+OutputFormat outputFormatFromString(std::string s)
+{
+  if (s == "FOLDERS")
+    return FOLDERS;
+  if (s == "CONTAINER")
+    return CONTAINER;
+  return FOLDERS;
+}
+
+/**
+ * \brief Converts \c std::string to \c VisualizationFormat.
+ */
+VisualizationFormat visualizationFormatFromString(std::string s)
+{
+  if (s == "NONE")
+    return NO_VISUALIZATION;
+  if (s == "XDMF")
+    return XDMF;
+  if (s == "VTK")
+    return VTK_RECTILINEAR;
+  return NO_VISUALIZATION;
+}
+
+/**
+ * \brief Converts \c std::string to \c FieldEncoding.
+ */
+FieldEncoding fieldEncodingFromString(std::string s)
+{
+  if (s == "FULL_PRECISION")
+    return FULL_PRECISION;
+  if (s == "SINGLE_PRECISION")
+    return SINGLE_PRECISION;
+  if (s == "LOSSLESS")
+    return LOSSLESS;
+  if (s == "ERROR_BOUNDED")
+    return ERROR_BOUNDED;
+  return FULL_PRECISION;
+}
+
+/**
+ * \brief Broadcasts a string from process 0 to all the processes.
+ */
+static void broadcastString(std::string &s)
+{
+  PetscInt length = s.size();
+  MPI_Bcast(&length, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  s.resize(length);
+  if (length > 0)
+    MPI_Bcast(&s[0], length, MPI_CHAR, 0, PETSC_COMM_WORLD);
+}
+
+/**
+ * \brief Reads the coordinates of a point (the missing ones are zero).
+ */
+static void readPoint(const YAML::Node &node, PetscReal *point)
+{
+  for (unsigned int d=0; d<3; d++)
+    point[d] = (d < node.size())? node[d].as<PetscReal>() : 0.0;
+}
+
 SimulationParameters::SimulationParameters()
 {
 }
@@ -73,10 +180,37 @@ void SimulationParameters::initialize(std::string fileName)
     dt = node["dt"].as<PetscReal>();
     startStep = node["startStep"].as<PetscInt>(0);
     restart = (startStep > 0) ? PETSC_TRUE : PETSC_FALSE;
+
+    // start from the data of another case, interpolated onto the grid
+    const YAML::Node &interpolation = node["interpolateFrom"];
+    interpolationStep = 0;
+    interpolationPressure = PETSC_FALSE;
+    if (interpolation.IsDefined())
+    {
+      interpolationFolder = interpolation["caseFolder"].as<std::string>();
+      interpolationStep = interpolation["timeStep"].as<PetscInt>();
+      interpolationPressure = (interpolation["pressure"].as<bool>(false))? PETSC_TRUE : PETSC_FALSE;
+      restart = PETSC_FALSE;
+    }
     nt = node["nt"].as<PetscInt>();
     nsave = node["nsave"].as<PetscInt>(nt);
+    nrestart = node["nrestart"].as<PetscInt>(0);
 
     solverType = solverTypeFromString(node["ibmScheme"].as<std::string>("NAVIER_STOKES"));
+    deltaFunction = deltaFunctionFromString(node["deltaFunction"].as<std::string>("ROMA_ET_AL"));
+    decomposition = decompositionFromString(node["decomposition"].as<std::string>("UNIFORM"));
+    bodyCostWeight = node["bodyCostWeight"].as<PetscReal>(1.0);
+    forceSolver = forceSolverFromString(node["forceSolver"].as<std::string>("COUPLED"));
+    schurMaxForces = node["schurMaxForces"].as<PetscInt>(2000);
+    forcingIterations = node["forcingIterations"].as<PetscInt>(1);
+    forceScaling = (node["forceScaling"].as<bool>(false))? PETSC_TRUE : PETSC_FALSE;
+    outputFormat = outputFormatFromString(node["outputFormat"].as<std::string>("FOLDERS"));
+    snapshotsPerFile = node["snapshotsPerFile"].as<PetscInt>(0);
+    asyncSnapshots = node["asyncSnapshots"].as<PetscInt>(0);
+    visualizationFormat = visualizationFormatFromString(node["visualization"].as<std::string>("NONE"));
+    telemetryInterval = node["telemetryInterval"].as<PetscInt>(100);
+    legacyLogs = (node["legacyLogs"].as<bool>(true))? PETSC_TRUE : PETSC_FALSE;
+    statisticsStart = node["statisticsStart"].as<PetscInt>(-1);
     convectionScheme = timeSchemeFromString(node["timeScheme"][0].as<std::string>("EULER_EXPLICIT"));
     diffusionScheme  = timeSchemeFromString(node["timeScheme"][1].as<std::string>("EULER_IMPLICIT"));
 
@@ -116,6 +250,109 @@ void SimulationParameters::initialize(std::string fileName)
         break;
     }
 
+    // encodings of the flow variables, e.g.
+    // - variables: [qx, qy]
+    //   encoding: ERROR_BOUNDED
+    //   tolerance: 1.0E-06
+    const YAML::Node &outputs = node["fieldOutput"];
+    for (unsigned int i=0; i<outputs.size(); i++)
+    {
+      FieldEncoding encoding = fieldEncodingFromString(outputs[i]["encoding"].as<std::string>("FULL_PRECISION"));
+      PetscReal tolerance = outputs[i]["tolerance"].as<PetscReal>(1.0E-06);
+      const YAML::Node &variables = outputs[i]["variables"];
+      for (unsigned int j=0; j<variables.size(); j++)
+      {
+        fieldEncodings[variables[j].as<std::string>()] = encoding;
+        fieldTolerances[variables[j].as<std::string>()] = tolerance;
+      }
+    }
+
+    // regions of the domain written at their own interval, e.g.
+    // - name: wake
+    //   box: [[0.5, -2.0], [10.0, 2.0]]
+    //   stride: 2
+    //   interval: 10
+    const YAML::Node &regionNodes = node["outputRegions"];
+    for (unsigned int i=0; i<regionNodes.size(); i++)
+    {
+      OutputRegion region;
+      region.name = regionNodes[i]["name"].as<std::string>();
+      region.stride = std::max<PetscInt>(1, regionNodes[i]["stride"].as<PetscInt>(1));
+      region.interval = std::max<PetscInt>(1, regionNodes[i]["interval"].as<PetscInt>(nsave));
+      for (PetscInt d=0; d<3; d++)
+      {
+        region.lower[d] = -PETSC_MAX_REAL;
+        region.upper[d] = PETSC_MAX_REAL;
+      }
+      const YAML::Node &box = regionNodes[i]["box"];
+      if (box.IsDefined())
+      {
+        for (unsigned int d=0; d<box[0].size() && d<3; d++)
+        {
+          region.lower[d] = box[0][d].as<PetscReal>();
+          region.upper[d] = box[1][d].as<PetscReal>();
+        }
+      }
+      outputRegions.push_back(region);
+    }
+
+    // probes sampled during the simulation, given as a list of points,
+    // a line or a plane (both evenly divided), e.g.
+    // - name: wake
+    //   points: [[2.0, 0.5], [4.0, 0.5]]
+    // - name: centreline
+    //   line: {start: [1.0, 0.0], end: [10.0, 0.0], numPoints: 50}
+    //   interval: 2
+    // - name: section
+    //   plane: {origin: [1.0, -2.0, 0.0], edges: [[4.0, 0.0, 0.0], [0.0, 4.0, 0.0]], numPoints: [40, 40]}
+    const YAML::Node &probeNodes = node["probes"];
+    for (unsigned int i=0; i<probeNodes.size(); i++)
+    {
+      ProbeSet  set;
+      PetscReal point[3], start[3], end[3], edges[2][3];
+      set.name = probeNodes[i]["name"].as<std::string>();
+      set.interval = std::max<PetscInt>(1, probeNodes[i]["interval"].as<PetscInt>(1));
+      const YAML::Node &points = probeNodes[i]["points"],
+                       &line = probeNodes[i]["line"],
+                       &plane = probeNodes[i]["plane"];
+      for (unsigned int k=0; k<points.size(); k++)
+      {
+        readPoint(points[k], point);
+        set.points.insert(set.points.end(), point, point+3);
+      }
+      if (line.IsDefined())
+      {
+        PetscInt n = std::max<PetscInt>(1, line["numPoints"].as<PetscInt>(2));
+        readPoint(line["start"], start);
+        readPoint(line["end"], end);
+        for (PetscInt k=0; k<n; k++)
+        {
+          PetscReal t = (n > 1)? (PetscReal)k/(n-1) : 0.0;
+          for (PetscInt d=0; d<3; d++)
+            set.points.push_back(start[d] + t*(end[d]-start[d]));
+        }
+      }
+      if (plane.IsDefined())
+      {
+        PetscInt n0 = std::max<PetscInt>(1, plane["numPoints"][0].as<PetscInt>(2)),
+                 n1 = std::max<PetscInt>(1, plane["numPoints"][1].as<PetscInt>(2));
+        readPoint(plane["origin"], start);
+        readPoint(plane["edges"][0], edges[0]);
+        readPoint(plane["edges"][1], edges[1]);
+        for (PetscInt l=0; l<n1; l++)
+        {
+          for (PetscInt k=0; k<n0; k++)
+          {
+            PetscReal s = (n0 > 1)? (PetscReal)k/(n0-1) : 0.0,
+                      t = (n1 > 1)? (PetscReal)l/(n1-1) : 0.0;
+            for (PetscInt d=0; d<3; d++)
+              set.points.push_back(start[d] + s*edges[0][d] + t*edges[1][d]);
+          }
+        }
+      }
+      probes.push_back(set);
+    }
+
     const YAML::Node &systems = node["linearSolvers"];
     std::string name, solver, preconditioner;
     for (unsigned int i=0; i<systems.size(); i++)
@@ -143,8 +380,12 @@ void SimulationParameters::initialize(std::string fileName)
   MPI_Bcast(&dt, 1, MPIU_REAL, 0, PETSC_COMM_WORLD);
   MPI_Bcast(&nt, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
   MPI_Bcast(&nsave, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&nrestart, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
   MPI_Bcast(&startStep, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
   MPI_Bcast(&restart, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  broadcastString(interpolationFolder);
+  MPI_Bcast(&interpolationStep, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&interpolationPressure, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
   
   MPI_Bcast(&gamma, 1, MPIU_REAL, 0, PETSC_COMM_WORLD);
   MPI_Bcast(&zeta, 1, MPIU_REAL, 0, PETSC_COMM_WORLD);
@@ -152,6 +393,101 @@ void SimulationParameters::initialize(std::string fileName)
   MPI_Bcast(&alphaImplicit, 1, MPIU_REAL, 0, PETSC_COMM_WORLD);
   
   MPI_Bcast(&solverType, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&deltaFunction, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&decomposition, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&bodyCostWeight, 1, MPIU_REAL, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&forceSolver, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&schurMaxForces, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&forcingIterations, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&forceScaling, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&outputFormat, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&snapshotsPerFile, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&asyncSnapshots, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&visualizationFormat, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&telemetryInterval, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&legacyLogs, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&statisticsStart, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+
+  // encodings of the flow variables, broadcast as lines "name encoding tolerance"
+  std::string encodings;
+  if (rank == 0)
+  {
+    std::stringstream ss;
+    ss.precision(17);
+    for (std::map<std::string, FieldEncoding>::iterator it=fieldEncodings.begin(); it!=fieldEncodings.end(); ++it)
+      ss << it->first << ' ' << it->second << ' ' << fieldTolerances[it->first] << '\n';
+    encodings = ss.str();
+  }
+  broadcastString(encodings);
+  if (rank != 0)
+  {
+    std::istringstream ss(encodings);
+    std::string name;
+    PetscInt    encoding;
+    PetscReal   tolerance;
+    while (ss >> name >> encoding >> tolerance)
+    {
+      fieldEncodings[name] = (FieldEncoding)encoding;
+      fieldTolerances[name] = tolerance;
+    }
+  }
+
+  // output regions, broadcast as lines "name stride interval lower upper"
+  std::string regions;
+  if (rank == 0)
+  {
+    std::stringstream ss;
+    ss.precision(17);
+    for (size_t i=0; i<outputRegions.size(); i++)
+    {
+      ss << outputRegions[i].name << ' ' << outputRegions[i].stride << ' ' << outputRegions[i].interval;
+      for (PetscInt d=0; d<3; d++)
+        ss << ' ' << outputRegions[i].lower[d] << ' ' << outputRegions[i].upper[d];
+      ss << '\n';
+    }
+    regions = ss.str();
+  }
+  broadcastString(regions);
+  if (rank != 0)
+  {
+    std::istringstream ss(regions);
+    OutputRegion       region;
+    while (ss >> region.name >> region.stride >> region.interval
+              >> region.lower[0] >> region.upper[0]
+              >> region.lower[1] >> region.upper[1]
+              >> region.lower[2] >> region.upper[2])
+      outputRegions.push_back(region);
+  }
+
+  // probes, broadcast as lines "name interval numPoints coordinates"
+  std::string probeSets;
+  if (rank == 0)
+  {
+    std::stringstream ss;
+    ss.precision(17);
+    for (size_t i=0; i<probes.size(); i++)
+    {
+      ss << probes[i].name << ' ' << probes[i].interval << ' ' << probes[i].points.size()/3;
+      for (size_t k=0; k<probes[i].points.size(); k++)
+        ss << ' ' << probes[i].points[k];
+      ss << '\n';
+    }
+    probeSets = ss.str();
+  }
+  broadcastString(probeSets);
+  if (rank != 0)
+  {
+    std::istringstream ss(probeSets);
+    ProbeSet           set;
+    size_t             numPoints;
+    while (ss >> set.name >> set.interval >> numPoints)
+    {
+      set.points.resize(3*numPoints);
+      for (size_t k=0; k<3*numPoints; k++)
+        ss >> set.points[k];
+      probes.push_back(set);
+    }
+  }
   
   MPI_Bcast(&convectionScheme, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
   MPI_Bcast(&diffusionScheme, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
@@ -160,4 +496,27 @@ void SimulationParameters::initialize(std::string fileName)
   MPI_Bcast(&PoissonSolveTolerance, 1, MPIU_REAL, 0, PETSC_COMM_WORLD);
   MPI_Bcast(&velocitySolveMaxIts, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
   MPI_Bcast(&PoissonSolveMaxIts, 1, MPIU_INT, 0, PETSC_COMM_WORLD);
+}
+
+/**
+ * \brief Returns the encoding of a flow variable at the save points.
+ */
+FieldEncoding SimulationParameters::fieldEncoding(std::string name)
+{
+  std::map<std::string, FieldEncoding>::iterator it = fieldEncodings.find(name);
+  return (it == fieldEncodings.end())? FULL_PRECISION : it->second;
+}
+
+/**
+ * \brief Returns true if a flow variable is saved with an encoding other
+ *        than full precision.
+ */
+PetscBool SimulationParameters::encodedOutput()
+{
+  for (std::map<std::string, FieldEncoding>::iterator it=fieldEncodings.begin(); it!=fieldEncodings.end(); ++it)
+  {
+    if (it->second != FULL_PRECISION)
+      return PETSC_TRUE;
+  }
+  return PETSC_FALSE;
 }
\ No newline at end of file
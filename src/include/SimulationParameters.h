@@ -10,11 +10,36 @@
 
 #include "types.h"
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include <petscsys.h>
 
 
+/**
+ * \brief Region of the domain whose flow variables are written separately.
+ */
+struct OutputRegion
+{
+  std::string name;     ///< name of the region (and of its output folder)
+  PetscReal   lower[3], ///< lower corner of the bounding box
+              upper[3]; ///< upper corner of the bounding box
+  PetscInt    stride,   ///< one grid line out of `stride` is written in each direction
+              interval; ///< number of time steps between two outputs
+};
+
+/**
+ * \brief Set of probe points at which the flow variables are sampled during
+ *        the simulation.
+ */
+struct ProbeSet
+{
+  std::string            name;     ///< name of the set (and of its output file)
+  PetscInt               interval; ///< number of time steps between two samples
+  std::vector<PetscReal> points;   ///< coordinates of the points (three per point)
+};
+
 /**
  * \class SimulationParameters
  * \brief Stores various parameters used in the simulation
@@ -26,9 +51,39 @@ public:
   
   PetscInt startStep, ///< initial time-step 
            nt,        ///< number of time steps
-           nsave;     ///< data-saving interval
+           nsave,     ///< data-saving interval
+           nrestart;  ///< interval of the exact (double precision) restart data (0: last time step only)
   
   SolverType solverType;  ///< type of flow solver
+
+  DeltaFunctionType deltaFunction; ///< discrete delta function of the immersed boundary method
+
+  DecompositionType decomposition; ///< distribution of the cells among the processes
+  PetscReal         bodyCostWeight; ///< cost of a body point relative to a cell (body-weighted decomposition)
+
+  ForceSolverType forceSolver; ///< method used to solve for the pressure and the body forces
+  PetscInt        schurMaxForces; ///< largest number of force components allowed with the Schur complement
+
+  PetscInt forcingIterations; ///< number of forcing iterations per time step (direct forcing)
+
+  PetscBool forceScaling; ///< scale the force unknowns of the Poisson system by its diagonal (off by default)
+
+  OutputFormat outputFormat;     ///< layout of the output files of the flow variables
+  PetscInt     snapshotsPerFile; ///< number of save points per container file (0: all in one file)
+  PetscInt     asyncSnapshots;   ///< maximum number of save points written in the background (0: synchronous output)
+
+  VisualizationFormat visualizationFormat; ///< format of the cell-centred velocity and pressure written at the save points
+
+  PetscInt  telemetryInterval; ///< number of samples kept in memory by the telemetry log and the probes
+  PetscInt  statisticsStart;   ///< time step after which the mean and RMS of the flow variables are accumulated (-1: none)
+  PetscBool legacyLogs;        ///< also write the files iterationCount.txt, forces.txt and moments.txt
+
+  std::map<std::string, FieldEncoding> fieldEncodings;  ///< encoding of the flow variables at the save points (default: full precision)
+  std::map<std::string, PetscReal>     fieldTolerances; ///< absolute error bound of the variables with the encoding ERROR_BOUNDED
+
+  std::vector<OutputRegion> outputRegions; ///< regions of the domain written at their own interval
+
+  std::vector<ProbeSet> probes; ///< points, lines and planes at which the flow variables are sampled
   
   TimeSteppingScheme convectionScheme, ///< time-scheme for the convection term
                      diffusionScheme;  ///< time-scheme for the diffusion term
@@ -40,11 +95,21 @@ public:
   
   PetscBool restart; ///< flag to indicate whether the simulation was restarted from saved data
 
+  std::string interpolationFolder;   ///< case whose saved data are interpolated onto the grid to start the simulation (empty: none)
+  PetscInt    interpolationStep;     ///< time step of the saved data to interpolate
+  PetscBool   interpolationPressure; ///< also interpolate the pressure
+
   PetscReal velocitySolveTolerance, ///< tolerance (velocity solver)
             PoissonSolveTolerance;  ///< tolerance (Poisson solver)
   PetscInt velocitySolveMaxIts, ///< maximum number of iterations (velocity solver)
            PoissonSolveMaxIts;  ///< maximum number of iterations (Poisson solver)
   
+  // encoding of a flow variable at the save points
+  FieldEncoding fieldEncoding(std::string name);
+
+  // is any flow variable saved in reduced or compressed form?
+  PetscBool encodedOutput();
+
   // Parse file and store simulation parameters
   SimulationParameters(std::string fileName);
   SimulationParameters();
@@ -58,7 +58,68 @@ enum TimeSteppingScheme
 enum SolverType
 {
   NAVIER_STOKES,  ///< no immersed bodies
-  TAIRA_COLONIUS  ///< immersed boundary projection method (Taira & Colonius, 2007)
+  TAIRA_COLONIUS, ///< immersed boundary projection method (Taira & Colonius, 2007)
+  DIRECT_FORCING, ///< explicit (multi-)direct forcing immersed boundary method
+  NULL_SPACE      ///< discrete streamfunction formulation of the projection method (2D)
+};
+
+/**
+ * \brief Discrete delta function used to regularize the body forces and to
+ *        interpolate the velocity onto the immersed boundary.
+ */
+enum DeltaFunctionType
+{
+  ROMA_ET_AL, ///< three-point kernel (Roma et al., 1999)
+  PESKIN_4,   ///< four-point kernel (Peskin, 2002)
+  BSPLINE_6   ///< six-point kernel based on the quintic B-spline
+};
+
+/**
+ * \brief Strategy used to distribute the cells of the domain among the processes.
+ */
+enum DecompositionType
+{
+  UNIFORM,      ///< same number of cells on each process (chosen by PETSc)
+  BODY_WEIGHTED ///< cells near the immersed boundary are weighted by the cost of the body
+};
+
+/**
+ * \brief Method used to solve the system for the pressure and the body forces.
+ */
+enum ForceSolverType
+{
+  COUPLED,         ///< iterative solve of the coupled pressure-force system
+  SCHUR_COMPLEMENT ///< pressure-only solve and precomputed Schur complement for the forces
+};
+
+/**
+ * \brief Layout of the output files of the flow variables.
+ */
+enum OutputFormat
+{
+  FOLDERS,  ///< one folder per save point, one file per variable
+  CONTAINER ///< all the variables of several save points in a single file, with an index
+};
+
+/**
+ * \brief Encoding of a flow variable in the output files.
+ */
+enum FieldEncoding
+{
+  FULL_PRECISION,   ///< double precision, PETSc binary format
+  SINGLE_PRECISION, ///< values rounded to single precision
+  LOSSLESS,         ///< double precision, compressed without loss
+  ERROR_BOUNDED     ///< values quantized with a bounded absolute error, then compressed
+};
+
+/**
+ * \brief Format of the cell-centred output of the flow, for visualization.
+ */
+enum VisualizationFormat
+{
+  NO_VISUALIZATION, ///< no visualization output
+  XDMF,             ///< XDMF description of raw binary arrays, one file per variable
+  VTK_RECTILINEAR   ///< VTK rectilinear grid, one piece per process
 };
 
 /**
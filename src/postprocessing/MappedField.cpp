@@ -0,0 +1,237 @@
+/***************************************************************************//**
+ * \file MappedField.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the classes \c MappedField and \c FieldView.
+ */
+
+
+#include "MappedField.h"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// class id of a PETSc vector in a binary file
+static const int32_t VEC_FILE_CLASSID = 1211214;
+
+/**
+ * \brief Reads a big-endian 32-bit integer.
+ */
+static int32_t readBigEndian(const unsigned char *bytes)
+{
+  return (int32_t)(((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | (uint32_t)bytes[3]);
+}
+
+/**
+ * \brief Constructor -- Checks the header of the vector, maps the file from
+ *        the page holding the header to the last value, and deduces the
+ *        number of points along each direction from the grid.
+ */
+MappedField::MappedField(const OutputGrid &grid, std::string fileName, std::string variable, long offset)
+  : dim(grid.dim), grid(grid), mapping(MAP_FAILED), mappingLength(0)
+{
+  unsigned char header[8];
+  struct stat   info;
+
+  normal = -1;
+  if(variable == "qx")
+    normal = 0;
+  else if(variable == "qy")
+    normal = 1;
+  else if(variable == "qz" && dim == 3)
+    normal = 2;
+
+  int file = open(fileName.c_str(), O_RDONLY);
+  if(file < 0)
+    throw std::runtime_error("unable to open " + fileName);
+  if(fstat(file, &info) != 0 || pread(file, header, sizeof(header), offset) != (ssize_t)sizeof(header))
+  {
+    close(file);
+    throw std::runtime_error("unable to read the header of the vector in " + fileName);
+  }
+  if(readBigEndian(header) != VEC_FILE_CLASSID)
+  {
+    close(file);
+    throw std::runtime_error(fileName + " does not hold a PETSc vector at the given offset");
+  }
+  numValues = readBigEndian(header+4);
+  if(offset + (long)sizeof(header) + 8*numValues > (long)info.st_size)
+  {
+    close(file);
+    throw std::runtime_error(fileName + " is truncated");
+  }
+
+  // the offset of a mapping is a multiple of the page size
+  long pageSize = sysconf(_SC_PAGESIZE),
+       start = (offset/pageSize)*pageSize;
+  mappingLength = offset - start + sizeof(header) + 8*numValues;
+  mapping = mmap(NULL, mappingLength, PROT_READ, MAP_SHARED, file, start);
+  close(file);
+  if(mapping == MAP_FAILED)
+    throw std::runtime_error("unable to map " + fileName);
+  values = (const unsigned char *)mapping + (offset - start) + sizeof(header);
+
+  long numOthers = 1;
+  for(int d=0; d<3; d++)
+  {
+    numPoints[d] = (d < dim)? grid.numCells(d) : 1;
+    if(d != normal)
+      numOthers *= numPoints[d];
+  }
+  if(normal >= 0)
+  {
+    numPoints[normal] = numValues/numOthers;
+    periodic = (numPoints[normal] == grid.numCells(normal));
+    if(numValues%numOthers != 0 || numPoints[normal] < grid.numCells(normal)-1 || numPoints[normal] > grid.numCells(normal))
+    {
+      munmap(mapping, mappingLength);
+      throw std::runtime_error("the size of " + variable + " in " + fileName + " does not match the grid");
+    }
+  }
+  else
+  {
+    periodic = false;
+    if(numValues != numOthers)
+    {
+      munmap(mapping, mappingLength);
+      throw std::runtime_error("the size of " + variable + " in " + fileName + " does not match the grid");
+    }
+  }
+  for(int d=0; d<3; d++)
+    grid.positions(d, normal, numPoints[d], positions[d]);
+}
+
+/**
+ * \brief Destructor -- Unmaps the file.
+ */
+MappedField::~MappedField()
+{
+  if(mapping != MAP_FAILED)
+    munmap(mapping, mappingLength);
+}
+
+/**
+ * \brief Area of the face of a flux (1 for a cell-centred variable).
+ *
+ * In two dimensions, the faces have a unit depth.
+ */
+double MappedField::area(int i, int j, int k) const
+{
+  int    index[3] = {i, j, k};
+  double a = 1.0;
+
+  if(normal < 0)
+    return a;
+  for(int d=0; d<dim; d++)
+  {
+    if(d != normal)
+      a *= grid.nodes[d][index[d]+1] - grid.nodes[d][index[d]];
+  }
+  return a;
+}
+
+/**
+ * \brief Finds where a variable of a save point is stored.
+ *
+ * The variable is read from the file `<name>.dat` of the folder of the save
+ * point if it exists, otherwise from the container listed in the index
+ * `fields.index` of the case. A save point written again after a restart
+ * is listed more than once: the last entry is used, as the solver does.
+ */
+void locateField(std::string caseFolder, int timeStep, std::string variable, std::string &fileName, long &offset)
+{
+  std::stringstream ss;
+  ss << caseFolder << "/" << std::setfill('0') << std::setw(7) << timeStep << "/" << variable << ".dat";
+  fileName = ss.str();
+  offset = 0;
+  if(std::ifstream(fileName.c_str()).good())
+    return;
+
+  std::ifstream index((caseFolder + "/fields.index").c_str());
+  std::string   line, name, container;
+  int           step;
+  long          position, size;
+  bool          found = false;
+  while(std::getline(index, line))
+  {
+    if(line.empty() || line[0] == '#')
+      continue;
+    std::istringstream entry(line);
+    if(entry >> step >> name >> container >> position >> size && step == timeStep && name == variable)
+    {
+      fileName = caseFolder + "/" + container;
+      offset = position;
+      found = true;
+    }
+  }
+  if(found)
+    return;
+  std::stringstream message;
+  message << "no output of " << variable << " at time step " << timeStep;
+  throw std::runtime_error(message.str());
+}
+
+/**
+ * \brief Keeps the points of the view located in the box [lower, upper].
+ */
+FieldView FieldView::subBox(const double lower[3], const double upper[3]) const
+{
+  FieldView box(*this);
+  for(int d=0; d<field->dim; d++)
+  {
+    int begin = 0, end = size[d];
+    while(begin < size[d] && coordinate(d, begin) < lower[d])
+      begin++;
+    while(end > begin && coordinate(d, end-1) > upper[d])
+      end--;
+    if(begin == end)
+      throw std::runtime_error("the box holds no point of the variable");
+    box.first[d] = first[d] + begin*step[d];
+    box.size[d] = end - begin;
+  }
+  return box;
+}
+
+/**
+ * \brief Keeps the plane of points nearest to a coordinate along a direction.
+ */
+FieldView FieldView::slice(int d, double x) const
+{
+  if(d < 0 || d >= field->dim)
+    throw std::runtime_error("invalid direction of the plane");
+
+  FieldView plane(*this);
+  int       nearest = 0;
+  for(int i=1; i<size[d]; i++)
+  {
+    if(fabs(coordinate(d, i) - x) < fabs(coordinate(d, nearest) - x))
+      nearest = i;
+  }
+  plane.first[d] = first[d] + nearest*step[d];
+  plane.size[d] = 1;
+  return plane;
+}
+
+/**
+ * \brief Keeps every `steps[d]` points of the view along each direction.
+ */
+FieldView FieldView::strided(const int steps[3]) const
+{
+  FieldView coarse(*this);
+  for(int d=0; d<3; d++)
+  {
+    if(steps[d] < 1)
+      throw std::runtime_error("the steps of a strided view are positive");
+    coarse.size[d] = (size[d] + steps[d] - 1)/steps[d];
+    coarse.step[d] = step[d]*steps[d];
+  }
+  return coarse;
+}
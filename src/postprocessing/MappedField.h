@@ -0,0 +1,156 @@
+/***************************************************************************//**
+ * \file MappedField.h
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Definition of the classes \c MappedField and \c FieldView.
+ */
+
+
+#if !defined(MAPPED_FIELD_H)
+#define MAPPED_FIELD_H
+
+#include "OutputGrid.h"
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include <stdint.h>
+
+
+class MappedField;
+
+/**
+ * \brief Strided view of the values of a mapped flow variable.
+ *
+ * A view is a box of points of the variable, taken every `step` points along
+ * each direction. It only holds indices: the values are read from the
+ * mapping of the file when accessed, and extracting a sub-box, a plane or a
+ * coarser view copies nothing.
+ */
+class FieldView
+{
+public:
+  int size[3];  ///< number of points of the view along each direction
+  int first[3]; ///< index, in the variable, of the first point of the view
+  int step[3];  ///< distance between two points of the view, in points of the variable
+
+  FieldView(const MappedField *field);
+
+  // value at a point of the view
+  double operator()(int i, int j, int k=0) const;
+
+  // velocity at a point of the view (flux divided by the area of the face)
+  double velocity(int i, int j, int k=0) const;
+
+  // coordinate of a point of the view along a direction
+  double coordinate(int d, int i) const;
+
+  // total number of points
+  long numPoints() const
+  {
+    return (long)size[0]*size[1]*size[2];
+  }
+
+  // points located in the box [lower, upper]
+  FieldView subBox(const double lower[3], const double upper[3]) const;
+
+  // plane of points nearest to a coordinate along a direction
+  FieldView slice(int d, double coordinate) const;
+
+  // every steps[d] points along each direction
+  FieldView strided(const int steps[3]) const;
+
+private:
+  const MappedField *field;
+};
+
+/**
+ * \brief Flow variable of a save point, mapped in memory from a PETSc binary
+ *        file.
+ *
+ * The file holds the class id and the number of values of the vector (both
+ * 32-bit integers), followed by the values in the natural ordering, as
+ * big-endian doubles. `offset` is the position of the vector in the file
+ * (non-zero in the containers of the output format `CONTAINER`). Only the
+ * pages of the values actually read are loaded by the system.
+ *
+ * The layout of the variable is deduced from its name: the fluxes `qx`, `qy`
+ * and `qz` are located on the faces normal to x, y and z, the other
+ * variables at the cell centres. A flux has one more point along its normal
+ * direction when the direction is periodic.
+ */
+class MappedField
+{
+public:
+  int    dim;          ///< number of dimensions
+  int    normal;       ///< direction normal to the faces of a flux (-1 for a cell-centred variable)
+  int    numPoints[3]; ///< number of points of the variable along each direction
+  long   numValues;    ///< total number of values
+  bool   periodic;     ///< is the direction normal to the flux periodic?
+
+  std::vector<double> positions[3]; ///< coordinates of the points along each direction
+
+  MappedField(const OutputGrid &grid, std::string fileName, std::string variable, long offset=0);
+  ~MappedField();
+
+  // view of all the points of the variable
+  FieldView view() const
+  {
+    return FieldView(this);
+  }
+
+  // value at a position in the natural ordering
+  double value(long index) const
+  {
+    const unsigned char *bytes = values + 8*index;
+    uint64_t            bits = 0;
+    double              v;
+    for(int b=0; b<8; b++)
+      bits = (bits << 8) | bytes[b];
+    memcpy(&v, &bits, sizeof(double));
+    return v;
+  }
+
+  // area of the face of a flux at a point of the variable
+  double area(int i, int j, int k) const;
+
+private:
+  const OutputGrid     &grid;
+  void                 *mapping;
+  size_t               mappingLength;
+  const unsigned char  *values;
+
+  MappedField(const MappedField&);
+  MappedField& operator=(const MappedField&);
+};
+
+// finds the file and the offset of a variable at a save point of a case
+void locateField(std::string caseFolder, int timeStep, std::string variable, std::string &fileName, long &offset);
+
+inline FieldView::FieldView(const MappedField *field) : field(field)
+{
+  for(int d=0; d<3; d++)
+  {
+    size[d] = field->numPoints[d];
+    first[d] = 0;
+    step[d] = 1;
+  }
+}
+
+inline double FieldView::operator()(int i, int j, int k) const
+{
+  const int *n = field->numPoints;
+  return field->value(first[0]+i*step[0] + (long)n[0]*((first[1]+j*step[1]) + (long)n[1]*(first[2]+k*step[2])));
+}
+
+inline double FieldView::velocity(int i, int j, int k) const
+{
+  return (*this)(i, j, k)/field->area(first[0]+i*step[0], first[1]+j*step[1], first[2]+k*step[2]);
+}
+
+inline double FieldView::coordinate(int d, int i) const
+{
+  return field->positions[d][first[d]+i*step[d]];
+}
+
+#endif
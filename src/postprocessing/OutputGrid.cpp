@@ -0,0 +1,69 @@
+/***************************************************************************//**
+ * \file OutputGrid.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the class \c OutputGrid.
+ */
+
+
+#include "OutputGrid.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+/**
+ * \brief Constructor -- Reads the number of cells along each direction (first
+ *        line), then the coordinates of the nodes, direction after direction.
+ */
+OutputGrid::OutputGrid(std::string fileName)
+{
+  std::ifstream file(fileName.c_str());
+  std::string   line;
+  int           numCells[3];
+
+  if(!file.good())
+    throw std::runtime_error("unable to open the grid " + fileName);
+
+  std::getline(file, line);
+  std::istringstream ss(line);
+  dim = 0;
+  while(dim < 3 && ss >> numCells[dim])
+    dim++;
+  if(dim < 2)
+    throw std::runtime_error("invalid number of cells in " + fileName);
+
+  for(int d=0; d<dim; d++)
+  {
+    nodes[d].resize(numCells[d]+1);
+    for(int i=0; i<=numCells[d]; i++)
+      file >> nodes[d][i];
+  }
+  if(!file)
+    throw std::runtime_error("unable to read the nodes of " + fileName);
+  if(dim == 2)
+    nodes[2].assign(1, 0.0);
+}
+
+/**
+ * \brief Computes the positions of the `count` points of a variable along a
+ *        direction.
+ *
+ * Along the direction `normal` of a flux, the points are the faces between
+ * the cells (the first face of the domain is only stored with periodic
+ * boundaries, at the end); along the other directions, and for the
+ * cell-centred variables (`normal` = -1), they are the centres of the cells.
+ */
+void OutputGrid::positions(int d, int normal, int count, std::vector<double> &x) const
+{
+  x.resize(count);
+  for(int i=0; i<count; i++)
+  {
+    if(d >= dim)
+      x[i] = 0.0;
+    else if(d == normal)
+      x[i] = nodes[d][i+1];
+    else
+      x[i] = 0.5*(nodes[d][i] + nodes[d][i+1]);
+  }
+}
@@ -0,0 +1,37 @@
+/***************************************************************************//**
+ * \file OutputGrid.h
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Definition of the class \c OutputGrid.
+ */
+
+
+#if !defined(OUTPUT_GRID_H)
+#define OUTPUT_GRID_H
+
+#include <string>
+#include <vector>
+
+
+/**
+ * \brief Grid of a simulation, read from the file `grid.txt` of the case.
+ */
+class OutputGrid
+{
+public:
+  int dim; ///< number of dimensions
+
+  std::vector<double> nodes[3]; ///< coordinates of the nodes along each direction
+
+  OutputGrid(std::string fileName);
+
+  // number of cells along a direction
+  int numCells(int d) const
+  {
+    return nodes[d].size()-1;
+  }
+
+  // positions of a variable along a direction (faces or cell centres)
+  void positions(int d, int normal, int count, std::vector<double> &x) const;
+};
+
+#endif
@@ -0,0 +1,165 @@
+/***************************************************************************//**
+ * \file extractField.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Command-line tool that extracts a box, a plane or a coarser sampling
+ *        of a flow variable from the output of a simulation.
+ *
+ * Usage:
+ *
+ *     extractField -caseFolder <folder> -timeStep <n> -variable <qx|qy|qz|phi|...>
+ *                  [-box <xmin> <xmax> <ymin> <ymax> [<zmin> <zmax>]]
+ *                  [-plane <x|y|z> <coordinate>] [-stride <sx> <sy> [<sz>]]
+ *                  [-velocity] [-output <file>]
+ *
+ * The points are written one per line (coordinates, then value), x varying
+ * fastest. Only the pages of the file holding the extracted points are read.
+ */
+
+
+#include "MappedField.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+
+/**
+ * \brief Prints the usage of the tool.
+ */
+static void usage(const char *program)
+{
+  std::cerr << "usage: " << program << " -caseFolder <folder> -timeStep <n> -variable <name>\n"
+            << "       [-box <xmin> <xmax> <ymin> <ymax> [<zmin> <zmax>]]\n"
+            << "       [-plane <x|y|z> <coordinate>] [-stride <sx> <sy> [<sz>]]\n"
+            << "       [-velocity] [-output <file>]\n";
+}
+
+/**
+ * \brief Is a command-line argument a number (and not the next option)?
+ */
+static bool isNumber(const char *argument)
+{
+  char *end;
+  strtod(argument, &end);
+  return end != argument && *end == '\0';
+}
+
+int main(int argc, char **argv)
+{
+  std::string caseFolder = ".", variable, outputName;
+  int         timeStep = -1,
+              planeDirection = -1,
+              steps[3] = {1, 1, 1},
+              numBoxBounds = 0,
+              numSteps = 0;
+  double      lower[3], upper[3],
+              planeCoordinate = 0.0;
+  bool        velocity = false;
+
+  for(int d=0; d<3; d++)
+  {
+    lower[d] = -std::numeric_limits<double>::max();
+    upper[d] = std::numeric_limits<double>::max();
+  }
+
+  for(int i=1; i<argc; i++)
+  {
+    std::string option(argv[i]);
+    if(option == "-caseFolder" && i+1 < argc)
+      caseFolder = argv[++i];
+    else if(option == "-timeStep" && i+1 < argc)
+      timeStep = atoi(argv[++i]);
+    else if(option == "-variable" && i+1 < argc)
+      variable = argv[++i];
+    else if(option == "-output" && i+1 < argc)
+      outputName = argv[++i];
+    else if(option == "-velocity")
+      velocity = true;
+    else if(option == "-plane" && i+2 < argc)
+    {
+      std::string direction(argv[++i]);
+      planeDirection = (direction == "x")? 0 : (direction == "y")? 1 : (direction == "z")? 2 : -1;
+      planeCoordinate = atof(argv[++i]);
+      if(planeDirection < 0)
+      {
+        usage(argv[0]);
+        return 1;
+      }
+    }
+    else if(option == "-box")
+    {
+      while(numBoxBounds < 6 && i+1 < argc && isNumber(argv[i+1]))
+      {
+        double bound = atof(argv[++i]);
+        if(numBoxBounds%2 == 0)
+          lower[numBoxBounds/2] = bound;
+        else
+          upper[numBoxBounds/2] = bound;
+        numBoxBounds++;
+      }
+    }
+    else if(option == "-stride")
+    {
+      while(numSteps < 3 && i+1 < argc && isNumber(argv[i+1]))
+        steps[numSteps++] = atoi(argv[++i]);
+    }
+    else
+    {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if(variable.empty() || timeStep < 0 || numBoxBounds%2 != 0)
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try
+  {
+    OutputGrid  grid(caseFolder + "/grid.txt");
+    std::string fileName;
+    long        offset;
+    locateField(caseFolder, timeStep, variable, fileName, offset);
+    MappedField field(grid, fileName, variable, offset);
+
+    FieldView view = field.view().subBox(lower, upper);
+    if(planeDirection >= 0)
+      view = view.slice(planeDirection, planeCoordinate);
+    view = view.strided(steps);
+
+    std::ofstream outputFile;
+    if(!outputName.empty())
+    {
+      outputFile.open(outputName.c_str());
+      if(!outputFile.good())
+        throw std::runtime_error("unable to open " + outputName);
+    }
+    std::ostream &output = (outputName.empty())? std::cout : outputFile;
+    output.precision(16);
+    output << "# x\ty" << ((grid.dim == 3)? "\tz" : "") << '\t' << variable << '\n';
+    output << "# size: " << view.size[0] << ' ' << view.size[1] << ' ' << view.size[2] << '\n';
+    for(int k=0; k<view.size[2]; k++)
+    {
+      for(int j=0; j<view.size[1]; j++)
+      {
+        for(int i=0; i<view.size[0]; i++)
+        {
+          output << view.coordinate(0, i) << '\t' << view.coordinate(1, j);
+          if(grid.dim == 3)
+            output << '\t' << view.coordinate(2, k);
+          output << '\t' << ((velocity)? view.velocity(i, j, k) : view(i, j, k)) << '\n';
+        }
+      }
+    }
+  }
+  catch(const std::exception &e)
+  {
+    std::cerr << argv[0] << ": " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
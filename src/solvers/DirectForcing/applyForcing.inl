@@ -0,0 +1,112 @@
+/***************************************************************************//**
+ * \file applyForcing.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c DirectForcingSolver
+ *        that compute and apply the forcing of the bodies.
+ */
+
+
+/**
+ * \brief Forces the intermediate fluxes to satisfy the no-slip condition
+ *        at the body points.
+ *
+ * At each forcing iteration, the velocity is interpolated at the body points
+ * and the forcing \f$ F = (U_B - E q^*) / \mathrm{diag}(E E^T) \f$ is spread
+ * back onto the fluxes: \f$ q^* \leftarrow q^* + E^T F \f$. One iteration is
+ * the direct forcing method; more iterations (`forcingIterations`) account
+ * for the overlap between the stencils of neighbouring points (multi-direct
+ * forcing). The forcing is accumulated over the iterations to compute the
+ * force on the bodies.
+ *
+ * The projection step that follows slightly modifies the velocity at the
+ * body points: the no-slip condition is only satisfied up to the splitting
+ * error.
+ */
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::applyForcing()
+{
+	PetscErrorCode ierr;
+	PetscInt       rank, fStart, idx;
+	PetscReal      *U, *dF, UB;
+	Mat            ET = TairaColoniusSolver<dim>::ET;
+	Vec            qStar = NavierStokesSolver<dim>::qStar;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+	std::vector<PetscInt> &points = TairaColoniusSolver<dim>::boundaryPointIndices[rank];
+
+	ierr = VecSet(forcing, 0.0); CHKERRQ(ierr);
+	ierr = VecGetOwnershipRange(forcing, &fStart, NULL); CHKERRQ(ierr);
+
+	for(PetscInt k=0; k<NavierStokesSolver<dim>::simParams->forcingIterations; k++)
+	{
+		ierr = MatMultTranspose(ET, qStar, interpolatedVelocity); CHKERRQ(ierr);
+
+		ierr = VecGetArray(interpolatedVelocity, &U); CHKERRQ(ierr);
+		ierr = VecGetArray(forcingIncrement, &dF); CHKERRQ(ierr);
+		for(auto l=points.begin(); l!=points.end(); l++)
+		{
+			for(PetscInt d=0; d<dim; d++)
+			{
+				idx = TairaColoniusSolver<dim>::forceIndexMapping[*l] - fStart + d;
+				UB = (TairaColoniusSolver<dim>::movingBodies)? TairaColoniusSolver<dim>::bodyVelocities[dim*(*l)+d] : 0.0;
+				dF[idx] = (forcingDiagonal[dim*(*l)+d] > 0.0)? (UB - U[idx])/forcingDiagonal[dim*(*l)+d] : 0.0;
+			}
+		}
+		ierr = VecRestoreArray(forcingIncrement, &dF); CHKERRQ(ierr);
+		ierr = VecRestoreArray(interpolatedVelocity, &U); CHKERRQ(ierr);
+
+		ierr = VecAXPY(forcing, 1.0, forcingIncrement); CHKERRQ(ierr);
+		ierr = MatMultAdd(ET, forcingIncrement, qStar, qStar); CHKERRQ(ierr);
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Integrates the force and the moment acting on each body.
+ *
+ * The momentum added to the fluid by the forcing of a point is the forcing
+ * times its volume; the force on the body is the opposite of the rate at
+ * which that momentum is added.
+ */
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::calculateForce()
+{
+	PetscErrorCode ierr;
+
+	ierr = PetscLogEventBegin(TairaColoniusSolver<dim>::eventCalculateForce, 0, 0, 0, 0); CHKERRQ(ierr);
+	ierr = TairaColoniusSolver<dim>::integrateForce(forcing, forcingVolumes, -1.0/NavierStokesSolver<dim>::simParams->dt); CHKERRQ(ierr);
+	ierr = PetscLogEventEnd(TairaColoniusSolver<dim>::eventCalculateForce, 0, 0, 0, 0); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Moves the bodies to their position at the next time step and
+ *        regenerates the regularization matrix.
+ *
+ * Only \f$ E^T \f$ depends on the position of the bodies: the Poisson system
+ * is not modified.
+ */
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::updateImmersedBoundary()
+{
+	PetscErrorCode ierr;
+
+	if(!TairaColoniusSolver<dim>::movingBodies)
+		return 0;
+
+	ierr = TairaColoniusSolver<dim>::moveBodies((NavierStokesSolver<dim>::timeStep+1)*NavierStokesSolver<dim>::simParams->dt); CHKERRQ(ierr);
+	ierr = TairaColoniusSolver<dim>::calculateCellIndices(); CHKERRQ(ierr);
+
+	// lay out the stencils around the current cells of the points
+	TairaColoniusSolver<dim>::anchorI.clear();
+	TairaColoniusSolver<dim>::anchorJ.clear();
+	TairaColoniusSolver<dim>::anchorK.clear();
+	ierr = MatDestroy(&(TairaColoniusSolver<dim>::ET)); CHKERRQ(ierr);
+	ierr = TairaColoniusSolver<dim>::generateStencils(); CHKERRQ(ierr);
+	ierr = computeForcingWeights(); CHKERRQ(ierr);
+	ierr = generateET(); CHKERRQ(ierr);
+
+	return 0;
+}
@@ -0,0 +1,95 @@
+/***************************************************************************//**
+ * \file generateET.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods `generateET` and
+ *        `computeForcingWeights` of \c DirectForcingSolver.
+ */
+
+
+/**
+ * \brief Assembles the regularization matrix \f$ E^T \f$ from the weights of
+ *        the discrete delta function.
+ *
+ * The rows are distributed like the fluxes and the columns like the body
+ * points. \f$ E \f$, applied with `MatMultTranspose`, interpolates the
+ * velocity at the body points.
+ */
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::generateET()
+{
+	PetscErrorCode ierr;
+	PetscInt       qStart, qEnd, fStart, fEnd, col;
+
+	std::vector<PetscInt> &stencilRows = TairaColoniusSolver<dim>::stencilRows;
+	std::vector<PetscInt> &stencilPoints = TairaColoniusSolver<dim>::stencilPoints;
+	std::vector<PetscInt> &stencilComponents = TairaColoniusSolver<dim>::stencilComponents;
+	std::vector<PetscInt> &forceIndexMapping = TairaColoniusSolver<dim>::forceIndexMapping;
+	Mat                   *ET = &(TairaColoniusSolver<dim>::ET);
+
+	ierr = VecGetOwnershipRange(NavierStokesSolver<dim>::q, &qStart, &qEnd); CHKERRQ(ierr);
+	ierr = VecGetOwnershipRange(forcing, &fStart, &fEnd); CHKERRQ(ierr);
+
+	// number of non-zeros in the diagonal and off-diagonal portions
+	std::vector<PetscInt> d_nnz(qEnd-qStart, 0),
+	                      o_nnz(qEnd-qStart, 0);
+	for(size_t e=0; e<stencilRows.size(); e++)
+	{
+		col = forceIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		(col>=fStart && col<fEnd)? d_nnz[stencilRows[e]-qStart]++ : o_nnz[stencilRows[e]-qStart]++;
+	}
+
+	ierr = MatCreate(PETSC_COMM_WORLD, ET); CHKERRQ(ierr);
+	ierr = MatSetSizes(*ET, qEnd-qStart, fEnd-fStart, PETSC_DETERMINE, PETSC_DETERMINE); CHKERRQ(ierr);
+	ierr = MatSetFromOptions(*ET); CHKERRQ(ierr);
+	ierr = MatSeqAIJSetPreallocation(*ET, 0, &d_nnz.front()); CHKERRQ(ierr);
+	ierr = MatMPIAIJSetPreallocation(*ET, 0, &d_nnz.front(), 0, &o_nnz.front()); CHKERRQ(ierr);
+
+	for(size_t e=0; e<stencilRows.size(); e++)
+	{
+		col = forceIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		ierr = MatSetValue(*ET, stencilRows[e], col, TairaColoniusSolver<dim>::stencilWeights[e], INSERT_VALUES); CHKERRQ(ierr);
+	}
+	ierr = MatAssemblyBegin(*ET, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+	ierr = MatAssemblyEnd(*ET, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Computes, for each component of each body point, the diagonal entry
+ *        of \f$ E E^T \f$ and the volume over which its forcing is spread.
+ *
+ * Spreading a forcing \f$ F \f$ from an isolated point changes the velocity
+ * interpolated at that point by \f$ (E E^T) F \f$: dividing the velocity
+ * defect by the diagonal entry enforces the no-slip condition in one
+ * iteration for well-separated points. The volume is \f$ E \hat{M} \f$, so
+ * that the momentum added to the fluid is the forcing times the volume.
+ */
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::computeForcingWeights()
+{
+	PetscErrorCode ierr;
+	PetscInt       qStart, idx;
+	PetscReal      *MHat, weight;
+
+	size_t numPoints = TairaColoniusSolver<dim>::x.size();
+	forcingDiagonal.assign(dim*numPoints, 0.0);
+	forcingVolumes.assign(dim*numPoints, 0.0);
+
+	ierr = VecGetOwnershipRange(NavierStokesSolver<dim>::q, &qStart, NULL); CHKERRQ(ierr);
+	ierr = VecGetArray(NavierStokesSolver<dim>::MHat, &MHat); CHKERRQ(ierr);
+	for(size_t e=0; e<TairaColoniusSolver<dim>::stencilRows.size(); e++)
+	{
+		idx = dim*TairaColoniusSolver<dim>::stencilPoints[e] + TairaColoniusSolver<dim>::stencilComponents[e];
+		weight = TairaColoniusSolver<dim>::stencilWeights[e];
+		forcingDiagonal[idx] += weight*weight;
+		forcingVolumes[idx] += weight*MHat[TairaColoniusSolver<dim>::stencilRows[e]-qStart];
+	}
+	ierr = VecRestoreArray(NavierStokesSolver<dim>::MHat, &MHat); CHKERRQ(ierr);
+
+	// the stencil of a body point can span several processes
+	ierr = MPI_Allreduce(MPI_IN_PLACE, &forcingDiagonal.front(), dim*numPoints, MPIU_REAL, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	ierr = MPI_Allreduce(MPI_IN_PLACE, &forcingVolumes.front(), dim*numPoints, MPIU_REAL, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+/***************************************************************************//**
+ * \file DirectForcingSolver.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of the class \c DirectForcingSolver.
+ */
+
+
+#include "DirectForcingSolver.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <iomanip>
+#include <algorithm>
+
+#include <petscdmcomposite.h>
+
+
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::initialize()
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageInitialize); CHKERRQ(ierr);
+  ierr = TairaColoniusSolver<dim>::initializeBodies(); CHKERRQ(ierr);
+  if(TairaColoniusSolver<dim>::movingBodies)
+  {
+    TairaColoniusSolver<dim>::x0 = TairaColoniusSolver<dim>::x;
+    TairaColoniusSolver<dim>::y0 = TairaColoniusSolver<dim>::y;
+    TairaColoniusSolver<dim>::z0 = TairaColoniusSolver<dim>::z;
+    TairaColoniusSolver<dim>::bodyCenters0 = TairaColoniusSolver<dim>::bodyCenters;
+    ierr = TairaColoniusSolver<dim>::moveBodies(NavierStokesSolver<dim>::timeStep*NavierStokesSolver<dim>::simParams->dt); CHKERRQ(ierr);
+  }
+  ierr = createDMs(); CHKERRQ(ierr);
+  ierr = TairaColoniusSolver<dim>::calculateCellIndices(); CHKERRQ(ierr);
+  ierr = TairaColoniusSolver<dim>::createGlobalMappingBodies(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::initializeCommon(); CHKERRQ(ierr);
+  if(NavierStokesSolver<dim>::simParams->decomposition == BODY_WEIGHTED)
+  {
+    ierr = TairaColoniusSolver<dim>::writeLoadBalance(); CHKERRQ(ierr);
+  }
+  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+
+  return 0;
+}
+
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::finalize()
+{
+  PetscErrorCode ierr;
+
+  ierr = TairaColoniusSolver<dim>::finalize(); CHKERRQ(ierr);
+
+  // Vecs
+  if(forcing!=PETSC_NULL)             {ierr = VecDestroy(&forcing); CHKERRQ(ierr);}
+  if(interpolatedVelocity!=PETSC_NULL){ierr = VecDestroy(&interpolatedVelocity); CHKERRQ(ierr);}
+  if(forcingIncrement!=PETSC_NULL)    {ierr = VecDestroy(&forcingIncrement); CHKERRQ(ierr);}
+
+  return 0;
+}
+
+/**
+ * \brief Creates the distributed arrays.
+ *
+ * The distributed array of the body points is not added to `lambdaPack`:
+ * the Poisson system only involves the pressure.
+ */
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::createDMs()
+{
+  PetscErrorCode ierr;
+  if(NavierStokesSolver<dim>::simParams->decomposition == BODY_WEIGHTED)
+  {
+    // cells of all the points (the distributed arrays do not exist yet)
+    ierr = TairaColoniusSolver<dim>::calculateCellIndices(); CHKERRQ(ierr);
+    ierr = TairaColoniusSolver<dim>::computeOwnershipRanges(); CHKERRQ(ierr);
+  }
+  ierr = NavierStokesSolver<dim>::createDMs(); CHKERRQ(ierr);
+  ierr = TairaColoniusSolver<dim>::generateBodyInfo(); CHKERRQ(ierr);
+  ierr = DMDACreate1d(PETSC_COMM_WORLD, DM_BOUNDARY_NONE, TairaColoniusSolver<dim>::x.size(), dim, 0, &TairaColoniusSolver<dim>::numBoundaryPointsOnProcess.front(), &TairaColoniusSolver<dim>::bda); CHKERRQ(ierr);
+
+  return 0;
+}
+
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::createVecs()
+{
+  PetscErrorCode ierr;
+
+  ierr = NavierStokesSolver<dim>::createVecs(); CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(TairaColoniusSolver<dim>::bda, &forcing); CHKERRQ(ierr);
+  ierr = VecDuplicate(forcing, &interpolatedVelocity); CHKERRQ(ierr);
+  ierr = VecDuplicate(forcing, &forcingIncrement); CHKERRQ(ierr);
+
+  return 0;
+}
+
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::setNullSpace()
+{
+  return NavierStokesSolver<dim>::setNullSpace();
+}
+
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::initializeLambda()
+{
+  return NavierStokesSolver<dim>::initializeLambda();
+}
+
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::writeLambda()
+{
+  return NavierStokesSolver<dim>::writeLambda();
+}
+
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::generateR2()
+{
+  return NavierStokesSolver<dim>::generateR2();
+}
+
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::solvePoissonSystem()
+{
+  return NavierStokesSolver<dim>::solvePoissonSystem();
+}
+
+/**
+ * \brief Assembles the matrices \f$ B^N Q \f$ (gradient only) and \f$ E^T \f$.
+ */
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::generateBNQ()
+{
+  PetscErrorCode ierr;
+
+  ierr = NavierStokesSolver<dim>::generateBNQ(); CHKERRQ(ierr);
+  ierr = TairaColoniusSolver<dim>::generateStencils(); CHKERRQ(ierr);
+  ierr = computeForcingWeights(); CHKERRQ(ierr);
+  ierr = generateET(); CHKERRQ(ierr);
+
+  return 0;
+}
+
+/**
+ * \brief Solves for the intermediate fluxes, then forces them to satisfy
+ *        the no-slip condition at the body points.
+ */
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::solveIntermediateVelocity()
+{
+  PetscErrorCode ierr;
+
+  ierr = NavierStokesSolver<dim>::solveIntermediateVelocity(); CHKERRQ(ierr);
+  ierr = applyForcing(); CHKERRQ(ierr);
+
+  return 0;
+}
+
+template <PetscInt dim>
+PetscErrorCode DirectForcingSolver<dim>::writeData()
+{
+  PetscErrorCode ierr;
+
+  ierr = calculateForce(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::writeData(); CHKERRQ(ierr);
+  ierr = TairaColoniusSolver<dim>::writeForces(); CHKERRQ(ierr);
+
+  return 0;
+}
+
+#include "DirectForcing/generateET.inl"
+#include "DirectForcing/applyForcing.inl"
+
+template class DirectForcingSolver<2>;
+template class DirectForcingSolver<3>;
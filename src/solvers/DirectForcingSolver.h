@@ -0,0 +1,75 @@
+/***************************************************************************//**
+ * \file DirectForcingSolver.h
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Definition of the class \c DirectForcingSolver.
+ */
+
+
+#if !defined(DIRECT_FORCING_SOLVER_H)
+#define DIRECT_FORCING_SOLVER_H
+
+#include "TairaColoniusSolver.h"
+
+
+/**
+ * \class DirectForcingSolver
+ * \brief Solves the Navier-Stokes equations with an explicit (multi-)direct
+ *        forcing immersed boundary method.
+ *
+ * The bodies, the discrete delta functions and the outputs are those of
+ * \c TairaColoniusSolver, but the body forces are not unknowns of the Poisson
+ * system: they are computed explicitly from the velocity interpolated at the
+ * body points and spread onto the intermediate velocity. The Poisson system
+ * is the plain pressure Laplacian of \c NavierStokesSolver.
+ */
+template <PetscInt dim>
+class DirectForcingSolver : public TairaColoniusSolver<dim>
+{
+public:
+  // forcing accumulated over the forcing iterations of the time step,
+  // velocity interpolated at the body points and forcing of one iteration
+  // (distributed like the body points)
+  Vec forcing,
+      interpolatedVelocity,
+      forcingIncrement;
+
+  // diagonal of E E^T and volume over which the forcing of each component
+  // of each body point is spread
+  std::vector<PetscReal> forcingDiagonal,
+                         forcingVolumes;
+
+  PetscErrorCode createDMs();
+  PetscErrorCode createVecs();
+  PetscErrorCode setNullSpace();
+  PetscErrorCode initializeLambda();
+  PetscErrorCode generateBNQ();
+  PetscErrorCode generateET();
+  PetscErrorCode computeForcingWeights();
+  PetscErrorCode generateR2();
+  PetscErrorCode solveIntermediateVelocity();
+  PetscErrorCode applyForcing();
+  PetscErrorCode solvePoissonSystem();
+  PetscErrorCode updateImmersedBoundary();
+  PetscErrorCode calculateForce();
+  PetscErrorCode writeLambda();
+
+public:
+  PetscErrorCode initialize();
+  PetscErrorCode finalize();
+  PetscErrorCode writeData();
+
+  DirectForcingSolver(std::string folder, FlowDescription *FD, SimulationParameters *SP, CartesianMesh *CM) : TairaColoniusSolver<dim>::TairaColoniusSolver(folder, FD, SP, CM)
+  {
+    forcing = PETSC_NULL;
+    interpolatedVelocity = PETSC_NULL;
+    forcingIncrement = PETSC_NULL;
+  }
+
+  // name of the solver
+  virtual std::string name()
+  {
+    return "Direct forcing";
+  }
+};
+
+#endif
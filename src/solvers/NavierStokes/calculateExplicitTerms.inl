@@ -43,6 +43,7 @@ PetscErrorCode NavierStokesSolver<2>::calculateExplicitTerms()
 	               gamma = simParams->gamma,
 	               zeta  = simParams->zeta;
 	PetscReal      dt = simParams->dt;
+	PetscLogDouble numNodes = 0.0;
 
 	// copy fluxes to local vectors
 	ierr = DMCompositeScatter(qPack, q, qxLocal, qyLocal); CHKERRQ(ierr);
@@ -59,6 +60,7 @@ PetscErrorCode NavierStokesSolver<2>::calculateExplicitTerms()
 	ierr = DMDAVecGetArray(uda, rxGlobal, &rx); CHKERRQ(ierr);
 	ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
 	ierr = DMDAGetInfo(uda, NULL, &M, &N, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+	numNodes += m*n;
 	for(j=nstart; j<nstart+n; j++)
 	{
 		for(i=mstart; i<mstart+m; i++)
@@ -101,6 +103,7 @@ PetscErrorCode NavierStokesSolver<2>::calculateExplicitTerms()
 	ierr = DMDAVecGetArray(vda, ryGlobal, &ry); CHKERRQ(ierr);
 	ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
 	ierr = DMDAGetInfo(vda, NULL, &M, &N, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+	numNodes += m*n;
 	for(j=nstart; j<nstart+n; j++)
 	{
 		for(i=mstart; i<mstart+m; i++)
@@ -145,6 +148,13 @@ PetscErrorCode NavierStokesSolver<2>::calculateExplicitTerms()
 	ierr = DMCompositeRestoreAccess(qPack, H,  &HxGlobal, &HyGlobal); CHKERRQ(ierr);
 	ierr = DMCompositeRestoreAccess(qPack, rn, &rxGlobal, &ryGlobal); CHKERRQ(ierr);
 
+	// operations per interior velocity node (boundary nodes are counted alike):
+	// 35 for the convection term (velocities at the faces, products and
+	// differences of Hx, combination with the previous time-step),
+	// 29 for the diffusion term (neighbouring velocities and 11 per call of du2dx2)
+	// and 3 for the time-derivative and the sum of the terms
+	ierr = PetscLogFlops(67*numNodes); CHKERRQ(ierr);
+
 	return 0;
 }
 
@@ -167,6 +177,7 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
 	               gamma = simParams->gamma,
 	               zeta  = simParams->zeta;
 	PetscReal      dt = simParams->dt;
+	PetscLogDouble numNodes = 0.0;
 
 	// copy fluxes to local vectors
 	ierr = DMCompositeScatter(qPack, q, qxLocal, qyLocal, qzLocal); CHKERRQ(ierr);
@@ -184,6 +195,7 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
 	ierr = DMDAVecGetArray(uda, rxGlobal, &rx); CHKERRQ(ierr);
 	ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
 	ierr = DMDAGetInfo(uda, NULL, &M, &N, &P, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+	numNodes += m*n*p;
 	for(k=pstart; k<pstart+p; k++)
 	{
 		for(j=nstart; j<nstart+n; j++)
@@ -242,6 +254,7 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
 	ierr = DMDAVecGetArray(vda, ryGlobal, &ry); CHKERRQ(ierr);
 	ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
 	ierr = DMDAGetInfo(vda, NULL, &M, &N, &P, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+	numNodes += m*n*p;
 	for(k=pstart; k<pstart+p; k++)
 	{
 		for(j=nstart; j<nstart+n; j++)
@@ -300,6 +313,7 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
 	ierr = DMDAVecGetArray(wda, rzGlobal, &rz); CHKERRQ(ierr);
 	ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
 	ierr = DMDAGetInfo(wda, NULL, &M, &N, &P, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+	numNodes += m*n*p;
 	for(k=pstart; k<pstart+p; k++)
 	{
 		for(j=nstart; j<nstart+n; j++)
@@ -360,5 +374,12 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
 	ierr = DMCompositeRestoreAccess(qPack, H,  &HxGlobal, &HyGlobal, &HzGlobal); CHKERRQ(ierr);
 	ierr = DMCompositeRestoreAccess(qPack, rn, &rxGlobal, &ryGlobal, &rzGlobal); CHKERRQ(ierr);
 
+	// operations per interior velocity node (boundary nodes are counted alike):
+	// 69 for the convection term (velocities at the faces, products and
+	// differences of Hx, combination with the previous time-step),
+	// 49 for the diffusion term (neighbouring velocities and 11 per call of du2dx2)
+	// and 3 for the time-derivative and the sum of the terms
+	ierr = PetscLogFlops(121*numNodes); CHKERRQ(ierr);
+
 	return 0;
 }
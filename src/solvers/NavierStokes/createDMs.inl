@@ -16,6 +16,10 @@
 *
 * The vector used to store the velocity fluxes is a composite of the individual 
 * vectors that store the fluxes in each cartesian direction.
+*
+* If the ownership ranges `lx`, `ly` (and `lz`) have been set, they are used to
+* distribute the cells of the pressure grid. Otherwise, PETSc splits the cells
+* evenly among the processes.
 */
 template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::createDMs()
@@ -41,7 +45,14 @@ PetscErrorCode NavierStokesSolver<2>::createDMs()
 	// pressure
 	numX = mesh->nx;
 	numY = mesh->ny;
-	ierr = DMDACreate2d(PETSC_COMM_WORLD, bx, by, DMDA_STENCIL_STAR, numX, numY, PETSC_DECIDE, PETSC_DECIDE, 1, 1, NULL, NULL, &pda); CHKERRQ(ierr);
+	if(lx.empty())
+	{
+		ierr = DMDACreate2d(PETSC_COMM_WORLD, bx, by, DMDA_STENCIL_STAR, numX, numY, PETSC_DECIDE, PETSC_DECIDE, 1, 1, NULL, NULL, &pda); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = DMDACreate2d(PETSC_COMM_WORLD, bx, by, DMDA_STENCIL_STAR, numX, numY, lx.size(), ly.size(), 1, 1, &lx.front(), &ly.front(), &pda); CHKERRQ(ierr);
+	}
 	ierr = DMDAGetOwnershipRanges(pda, &lxp, &lyp, NULL); CHKERRQ(ierr);
 	ierr = DMDAGetInfo(pda, NULL, NULL, NULL, NULL, &m, &n, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
 	
@@ -110,7 +121,14 @@ PetscErrorCode NavierStokesSolver<3>::createDMs()
 	numX = mesh->nx;
 	numY = mesh->ny;
 	numZ = mesh->nz;
-	ierr = DMDACreate3d(PETSC_COMM_WORLD, bx, by, bz, DMDA_STENCIL_STAR, numX, numY, numZ, PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE, 1, 1, NULL, NULL, NULL, &pda); CHKERRQ(ierr);
+	if(lx.empty())
+	{
+		ierr = DMDACreate3d(PETSC_COMM_WORLD, bx, by, bz, DMDA_STENCIL_STAR, numX, numY, numZ, PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE, 1, 1, NULL, NULL, NULL, &pda); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = DMDACreate3d(PETSC_COMM_WORLD, bx, by, bz, DMDA_STENCIL_STAR, numX, numY, numZ, lx.size(), ly.size(), lz.size(), 1, 1, &lx.front(), &ly.front(), &lz.front(), &pda); CHKERRQ(ierr);
+	}
 	ierr = DMDAGetOwnershipRanges(pda, &lxp, &lyp, &lzp); CHKERRQ(ierr);
 	ierr = DMDAGetInfo(pda, NULL, NULL, NULL, NULL, &m, &n, &p, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
 	
@@ -0,0 +1,290 @@
+/***************************************************************************//**
+ * \file derivedFields.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c NavierStokesSolver that compute
+ *        the vorticity, the Q-criterion and the divergence of saved time
+ *        steps.
+ */
+
+
+/**
+ * \brief Creates the distributed arrays, the vectors and the mesh spacings
+ *        needed to read the fluxes of saved time steps.
+ *
+ * No matrix or linear solver is created.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::initializePostProcessing()
+{
+	PetscErrorCode ierr;
+
+	ierr = createDMs(); CHKERRQ(ierr);
+	ierr = createVecs(); CHKERRQ(ierr);
+	initializeMeshSpacings();
+
+	return 0;
+}
+
+/**
+ * \brief Destroys the objects created by \c initializePostProcessing.
+ *
+ * Unlike \c finalize, the performance summary of the case is not
+ * overwritten with that of the post-processing.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::finalizePostProcessing()
+{
+	return destroyObjects();
+}
+
+/**
+ * \brief Reads the fluxes of a saved time step, updates the boundary ghosts
+ *        and writes the derived fields of the time step.
+ *
+ * The boundary ghosts are set as at the first time step of a run (a
+ * convective boundary copies the values next to the boundary).
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::postProcess(PetscInt step)
+{
+	PetscErrorCode ierr;
+
+	timeStep = step;
+	simParams->startStep = step;
+	ierr = readFluxes(); CHKERRQ(ierr);
+	if(dim == 2)
+	{
+		ierr = DMCompositeScatter(qPack, q, qxLocal, qyLocal); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = DMCompositeScatter(qPack, q, qxLocal, qyLocal, qzLocal); CHKERRQ(ierr);
+	}
+	ierr = updateBoundaryGhosts(); CHKERRQ(ierr);
+	ierr = writeDerivedFields(); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Gives the neighbours of a cell centre along a direction and the
+ *        distance between them.
+ *
+ * Next to a non-periodic boundary, the cell itself replaces the missing
+ * neighbour (one-sided difference). With periodic boundaries, the neighbours
+ * are the ghost cells -1 and n of the distributed array.
+ */
+template <PetscInt dim>
+void NavierStokesSolver<dim>::centredNeighbours(PetscInt c, PetscInt n, PetscBool periodic, const std::vector<PetscReal> &widths, PetscInt &minus, PetscInt &plus, PetscReal &distance)
+{
+	minus = (c > 0 || periodic)? c-1 : c;
+	plus = (c < n-1 || periodic)? c+1 : c;
+	distance = 0.0;
+	if(minus != c)
+		distance += 0.5*(widths[(minus+n)%n] + widths[c]);
+	if(plus != c)
+		distance += 0.5*(widths[c] + widths[plus%n]);
+}
+
+/**
+ * \brief Computes the vorticity, the Q-criterion and the divergence at the
+ *        centres of the cells owned by the process.
+ *
+ * The derivatives of each velocity component along its own direction come
+ * from the fluxes through the faces of the cell (staggered stencil), so that
+ * the divergence is the one the projection step cancels. The other
+ * derivatives are centred differences of the cell-centred velocity. With the
+ * velocity gradient \f$ G \f$, \f$ Q = -\frac{1}{2} \mathrm{tr}(G G) \f$.
+ *
+ * `derived` holds three vectors of the pressure grid: the vorticity (its z
+ * component in 2-D, its magnitude in 3-D), Q and the divergence.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::computeDerivedFields(Vec *derived)
+{
+	return 0;
+}
+
+template <>
+PetscErrorCode NavierStokesSolver<2>::computeDerivedFields(Vec *derived)
+{
+	PetscErrorCode         ierr;
+	PetscInt               mstart, nstart, m, n, i, j, row, im, ip, jm, jp;
+	PetscReal              **u, **v, **vorticity, **Q, **divergence, *values, dx, dy;
+	PetscReal              G[2][2];
+	PetscBool              periodic[2];
+	Vec                    velocity[2], velocityLocal[2];
+	std::vector<PetscReal> fields[3], diagonal[2];
+
+	periodic[0] = (flowDesc->bc[0][XPLUS].type == PERIODIC)? PETSC_TRUE : PETSC_FALSE;
+	periodic[1] = (flowDesc->bc[0][YPLUS].type == PERIODIC)? PETSC_TRUE : PETSC_FALSE;
+
+	ierr = computeCellCentredFields(fields, diagonal); CHKERRQ(ierr);
+
+	// cell-centred velocity with the values of the neighbouring cells
+	for(PetscInt d=0; d<2; d++)
+	{
+		ierr = DMGetGlobalVector(pda, &velocity[d]); CHKERRQ(ierr);
+		ierr = VecGetArray(velocity[d], &values); CHKERRQ(ierr);
+		std::copy(fields[d].begin(), fields[d].end(), values);
+		ierr = VecRestoreArray(velocity[d], &values); CHKERRQ(ierr);
+		ierr = DMGetLocalVector(pda, &velocityLocal[d]); CHKERRQ(ierr);
+		ierr = DMGlobalToLocalBegin(pda, velocity[d], INSERT_VALUES, velocityLocal[d]); CHKERRQ(ierr);
+		ierr = DMGlobalToLocalEnd(pda, velocity[d], INSERT_VALUES, velocityLocal[d]); CHKERRQ(ierr);
+	}
+
+	ierr = DMDAVecGetArray(pda, velocityLocal[0], &u); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(pda, velocityLocal[1], &v); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(pda, derived[0], &vorticity); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(pda, derived[1], &Q); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(pda, derived[2], &divergence); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(pda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+	for(j=nstart; j<nstart+n; j++)
+	{
+		centredNeighbours(j, mesh->ny, periodic[1], mesh->dy, jm, jp, dy);
+		for(i=mstart; i<mstart+m; i++)
+		{
+			centredNeighbours(i, mesh->nx, periodic[0], mesh->dx, im, ip, dx);
+			row = (i-mstart) + m*(j-nstart);
+			G[0][0] = diagonal[0][row];
+			G[0][1] = (u[jp][i] - u[jm][i])/dy;
+			G[1][0] = (v[j][ip] - v[j][im])/dx;
+			G[1][1] = diagonal[1][row];
+			vorticity[j][i] = G[1][0] - G[0][1];
+			Q[j][i] = -0.5*(G[0][0]*G[0][0] + 2.0*G[0][1]*G[1][0] + G[1][1]*G[1][1]);
+			divergence[j][i] = G[0][0] + G[1][1];
+		}
+	}
+	ierr = DMDAVecRestoreArray(pda, derived[2], &divergence); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(pda, derived[1], &Q); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(pda, derived[0], &vorticity); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(pda, velocityLocal[1], &v); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(pda, velocityLocal[0], &u); CHKERRQ(ierr);
+
+	for(PetscInt d=0; d<2; d++)
+	{
+		ierr = DMRestoreLocalVector(pda, &velocityLocal[d]); CHKERRQ(ierr);
+		ierr = DMRestoreGlobalVector(pda, &velocity[d]); CHKERRQ(ierr);
+	}
+
+	return 0;
+}
+
+template <>
+PetscErrorCode NavierStokesSolver<3>::computeDerivedFields(Vec *derived)
+{
+	PetscErrorCode         ierr;
+	PetscInt               mstart, nstart, pstart, m, n, p, i, j, k, row, im, ip, jm, jp, km, kp;
+	PetscReal              ***u[3], ***vorticity, ***Q, ***divergence, *values, dx, dy, dz;
+	PetscReal              G[3][3], omega[3], trace;
+	PetscBool              periodic[3];
+	Vec                    velocity[3], velocityLocal[3];
+	std::vector<PetscReal> fields[4], diagonal[3];
+
+	periodic[0] = (flowDesc->bc[0][XPLUS].type == PERIODIC)? PETSC_TRUE : PETSC_FALSE;
+	periodic[1] = (flowDesc->bc[0][YPLUS].type == PERIODIC)? PETSC_TRUE : PETSC_FALSE;
+	periodic[2] = (flowDesc->bc[0][ZPLUS].type == PERIODIC)? PETSC_TRUE : PETSC_FALSE;
+
+	ierr = computeCellCentredFields(fields, diagonal); CHKERRQ(ierr);
+
+	// cell-centred velocity with the values of the neighbouring cells
+	for(PetscInt d=0; d<3; d++)
+	{
+		ierr = DMGetGlobalVector(pda, &velocity[d]); CHKERRQ(ierr);
+		ierr = VecGetArray(velocity[d], &values); CHKERRQ(ierr);
+		std::copy(fields[d].begin(), fields[d].end(), values);
+		ierr = VecRestoreArray(velocity[d], &values); CHKERRQ(ierr);
+		ierr = DMGetLocalVector(pda, &velocityLocal[d]); CHKERRQ(ierr);
+		ierr = DMGlobalToLocalBegin(pda, velocity[d], INSERT_VALUES, velocityLocal[d]); CHKERRQ(ierr);
+		ierr = DMGlobalToLocalEnd(pda, velocity[d], INSERT_VALUES, velocityLocal[d]); CHKERRQ(ierr);
+		ierr = DMDAVecGetArray(pda, velocityLocal[d], &u[d]); CHKERRQ(ierr);
+	}
+
+	ierr = DMDAVecGetArray(pda, derived[0], &vorticity); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(pda, derived[1], &Q); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(pda, derived[2], &divergence); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(pda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+	for(k=pstart; k<pstart+p; k++)
+	{
+		centredNeighbours(k, mesh->nz, periodic[2], mesh->dz, km, kp, dz);
+		for(j=nstart; j<nstart+n; j++)
+		{
+			centredNeighbours(j, mesh->ny, periodic[1], mesh->dy, jm, jp, dy);
+			for(i=mstart; i<mstart+m; i++)
+			{
+				centredNeighbours(i, mesh->nx, periodic[0], mesh->dx, im, ip, dx);
+				row = (i-mstart) + m*((j-nstart) + n*(k-pstart));
+				for(PetscInt d=0; d<3; d++)
+				{
+					G[d][0] = (u[d][k][j][ip] - u[d][k][j][im])/dx;
+					G[d][1] = (u[d][k][jp][i] - u[d][k][jm][i])/dy;
+					G[d][2] = (u[d][kp][j][i] - u[d][km][j][i])/dz;
+					G[d][d] = diagonal[d][row];
+				}
+				omega[0] = G[2][1] - G[1][2];
+				omega[1] = G[0][2] - G[2][0];
+				omega[2] = G[1][0] - G[0][1];
+				vorticity[k][j][i] = sqrt(omega[0]*omega[0] + omega[1]*omega[1] + omega[2]*omega[2]);
+				trace = 0.0;
+				for(PetscInt a=0; a<3; a++)
+				{
+					for(PetscInt b=0; b<3; b++)
+						trace += G[a][b]*G[b][a];
+				}
+				Q[k][j][i] = -0.5*trace;
+				divergence[k][j][i] = G[0][0] + G[1][1] + G[2][2];
+			}
+		}
+	}
+	ierr = DMDAVecRestoreArray(pda, derived[2], &divergence); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(pda, derived[1], &Q); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(pda, derived[0], &vorticity); CHKERRQ(ierr);
+
+	for(PetscInt d=0; d<3; d++)
+	{
+		ierr = DMDAVecRestoreArray(pda, velocityLocal[d], &u[d]); CHKERRQ(ierr);
+		ierr = DMRestoreLocalVector(pda, &velocityLocal[d]); CHKERRQ(ierr);
+		ierr = DMRestoreGlobalVector(pda, &velocity[d]); CHKERRQ(ierr);
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Writes the derived fields of the current time step in the folder
+ *        of the save point, in the PETSc binary format: `vorticity` (2-D) or
+ *        `vorticityMagnitude` (3-D), `Q` and `divergence`.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeDerivedFields()
+{
+	PetscErrorCode ierr;
+	Vec            derived[3];
+	PetscViewer    viewer;
+	const char     *names[3] = {(dim == 2)? "vorticity" : "vorticityMagnitude", "Q", "divergence"};
+	PetscReal      maxDivergence;
+
+	for(PetscInt v=0; v<3; v++)
+	{
+		ierr = DMGetGlobalVector(pda, &derived[v]); CHKERRQ(ierr);
+	}
+	ierr = computeDerivedFields(derived); CHKERRQ(ierr);
+
+	mkdir(savePointDirectory().c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+	for(PetscInt v=0; v<3; v++)
+	{
+		std::string fileName = savePointDirectory() + "/" + names[v] + ".dat";
+		ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_WRITE, &viewer); CHKERRQ(ierr);
+		ierr = VecView(derived[v], viewer); CHKERRQ(ierr);
+		ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+	}
+	ierr = VecNorm(derived[2], NORM_INFINITY, &maxDivergence); CHKERRQ(ierr);
+	ierr = PetscPrintf(PETSC_COMM_WORLD, "Derived fields of time step %d written (max |divergence| = %g).\n", timeStep, maxDivergence); CHKERRQ(ierr);
+
+	for(PetscInt v=0; v<3; v++)
+	{
+		ierr = DMRestoreGlobalVector(pda, &derived[v]); CHKERRQ(ierr);
+	}
+
+	return 0;
+}
@@ -0,0 +1,408 @@
+/***************************************************************************//**
+ * \file fieldIO.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c NavierStokesSolver that write
+ *        and read the flow variables of a save point.
+ */
+
+
+/**
+ * \brief Returns the folder of the save point of the current time step.
+ *
+ * The name of the folder is the time step, 7 characters long, with leading
+ * zeros.
+ */
+template <PetscInt dim>
+std::string NavierStokesSolver<dim>::savePointDirectory()
+{
+	std::stringstream ss;
+	ss << caseFolder << "/" << std::setfill('0') << std::setw(7) << timeStep;
+	return ss.str();
+}
+
+/**
+ * \brief Writes a flow variable at the current time step.
+ *
+ * At the save points (every `nsave` time steps), the variable is written with
+ * the encoding set in the simulation parameters. The exact values, needed to
+ * restart, are written at the save points for the variables in full
+ * precision, and at the restart points for all the variables. The
+ * number of bytes written and the time spent are accumulated.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeField(Vec v, std::string name)
+{
+	PetscErrorCode ierr;
+	PetscInt       N;
+	PetscLogDouble startTime, endTime;
+	FieldEncoding  encoding = simParams->fieldEncoding(name);
+	PetscBool      saveStep = (timeStep % simParams->nsave == 0)? PETSC_TRUE : PETSC_FALSE,
+	               restartStep = restartPoint();
+
+	ierr = PetscTime(&startTime); CHKERRQ(ierr);
+	ierr = VecGetSize(v, &N); CHKERRQ(ierr);
+	fullPrecisionBytes += 2*sizeof(PetscInt) + N*sizeof(PetscScalar);
+	if(encoding != FULL_PRECISION && saveStep)
+	{
+		ierr = writeEncodedField(v, name, encoding); CHKERRQ(ierr);
+	}
+	if(encoding == FULL_PRECISION || restartStep)
+	{
+		ierr = writeExactField(v, name); CHKERRQ(ierr);
+		outputBytes += 2*sizeof(PetscInt) + N*sizeof(PetscScalar);
+	}
+	ierr = PetscTime(&endTime); CHKERRQ(ierr);
+	outputTime += endTime - startTime;
+
+	return 0;
+}
+
+/**
+ * \brief Writes the exact values of a flow variable at the current time step.
+ *
+ * With the output format `FOLDERS`, the vector is written in the file
+ * `<name>.dat` of the folder of the save point. With the format `CONTAINER`,
+ * it is appended to the container file `fieldsNNNNNNN.dat` (named after the
+ * first save point it holds), and a line is added to the index
+ * `fields.index`: time step, variable, container file, offset in bytes and
+ * number of values. A new container is started every `snapshotsPerFile`
+ * save points (never if 0). The container stays open between save points,
+ * so that a save point costs no file creation on the file system.
+ *
+ * With background output, the vector is only copied here (see `stageField`).
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeExactField(Vec v, std::string name)
+{
+	PetscErrorCode ierr;
+	PetscInt       rank, N;
+	PetscViewer    viewer;
+	std::string    fileName;
+	PetscInt64     offset;
+	PetscBool      newFile = PETSC_FALSE;
+
+	if(simParams->outputFormat == FOLDERS)
+	{
+		fileName = savePointDirectory() + "/" + name + ".dat";
+		if(asyncWriter != PETSC_NULL)
+		{
+			ierr = stageField(v, fileName, 0, PETSC_TRUE); CHKERRQ(ierr);
+			return 0;
+		}
+		ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_WRITE, &viewer); CHKERRQ(ierr);
+		ierr = VecView(v, viewer); CHKERRQ(ierr);
+		ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+		return 0;
+	}
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	// first variable of a new save point
+	if(timeStep != containerStep)
+	{
+		if(containerName.empty() || (simParams->snapshotsPerFile > 0 && containerSnapshots == simParams->snapshotsPerFile))
+		{
+			ierr = closeContainer(); CHKERRQ(ierr);
+			std::stringstream ss;
+			ss << "fields" << std::setfill('0') << std::setw(7) << timeStep << ".dat";
+			containerName = ss.str();
+			if(asyncWriter == PETSC_NULL)
+			{
+				fileName = caseFolder + "/" + containerName;
+				ierr = PetscViewerCreate(PETSC_COMM_WORLD, &containerViewer); CHKERRQ(ierr);
+				ierr = PetscViewerSetType(containerViewer, PETSCVIEWERBINARY); CHKERRQ(ierr);
+				ierr = PetscViewerFileSetMode(containerViewer, FILE_MODE_WRITE); CHKERRQ(ierr);
+				ierr = PetscViewerBinarySkipInfo(containerViewer); CHKERRQ(ierr);
+				ierr = PetscViewerFileSetName(containerViewer, fileName.c_str()); CHKERRQ(ierr);
+			}
+			else
+			{
+				newFile = PETSC_TRUE;
+			}
+			containerSnapshots = 0;
+			containerOffset = 0;
+		}
+		containerSnapshots++;
+		containerStep = timeStep;
+	}
+
+	ierr = VecGetSize(v, &N); CHKERRQ(ierr);
+	if(rank == 0)
+	{
+		if(!containerIndex.is_open())
+		{
+			std::string indexName = caseFolder + "/fields.index";
+			PetscBool   exists = (std::ifstream(indexName.c_str()).good())? PETSC_TRUE : PETSC_FALSE;
+			containerIndex.open(indexName.c_str(), std::ios::out | std::ios::app);
+			if(!exists)
+				containerIndex << "# time-step\tvariable\tfile\toffset\tsize\n";
+		}
+		containerIndex << timeStep << '\t' << name << '\t' << containerName << '\t' << containerOffset << '\t' << N << std::endl;
+	}
+	offset = containerOffset;
+	if(asyncWriter == PETSC_NULL)
+	{
+		ierr = VecView(v, containerViewer); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = stageField(v, caseFolder + "/" + containerName, offset, newFile); CHKERRQ(ierr);
+	}
+
+	// a vector is stored as its class id and size, followed by its values
+	containerOffset += 2*sizeof(PetscInt) + N*sizeof(PetscScalar);
+
+	return 0;
+}
+
+/**
+ * \brief Copies the local values of a vector in the ordering of the output
+ *        files.
+ *
+ * The values of a DMDA vector are copied in the natural ordering, which is
+ * the ordering `VecView` uses in the files. `start` is the global index of
+ * the first local value and `size` the global size of the vector.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::copyNaturalValues(Vec v, std::vector<PetscScalar> &values, PetscInt &start, PetscInt &size)
+{
+	PetscErrorCode    ierr;
+	PetscInt          end;
+	DM                da;
+	PetscBool         isDA = PETSC_FALSE;
+	Vec               natural;
+	const PetscScalar *array;
+
+	ierr = VecGetDM(v, &da); CHKERRQ(ierr);
+	if(da != PETSC_NULL)
+	{
+		ierr = PetscObjectTypeCompare((PetscObject)da, DMDA, &isDA); CHKERRQ(ierr);
+	}
+	natural = v;
+	if(isDA)
+	{
+		ierr = DMDACreateNaturalVector(da, &natural); CHKERRQ(ierr);
+		ierr = DMDAGlobalToNaturalBegin(da, v, INSERT_VALUES, natural); CHKERRQ(ierr);
+		ierr = DMDAGlobalToNaturalEnd(da, v, INSERT_VALUES, natural); CHKERRQ(ierr);
+	}
+
+	ierr = VecGetSize(natural, &size); CHKERRQ(ierr);
+	ierr = VecGetOwnershipRange(natural, &start, &end); CHKERRQ(ierr);
+	ierr = VecGetArrayRead(natural, &array); CHKERRQ(ierr);
+	values.assign(array, array + (end-start));
+	ierr = VecRestoreArrayRead(natural, &array); CHKERRQ(ierr);
+	if(isDA)
+	{
+		ierr = VecDestroy(&natural); CHKERRQ(ierr);
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Writes a flow variable in reduced or compressed form in the file
+ *        `<name>.enc` of the folder of the save point.
+ *
+ * Each process encodes its own values (see \c encodeValues) and writes them
+ * at its position in the file with MPI-IO. The file starts with the header
+ * (native byte order):
+ * - the 8 characters `PETIBMEF`;
+ * - the encoding and the number of chunks (32-bit integers);
+ * - the number of values (64-bit integer) and the error bound (double);
+ * - for each chunk (one per process, in the natural ordering), the number of
+ *   values and the number of bytes (64-bit integers);
+ *
+ * followed by the encoded chunks.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeEncodedField(Vec v, std::string name, FieldEncoding encoding)
+{
+	PetscErrorCode           ierr;
+	PetscMPIInt              rank, numProcs;
+	PetscInt                 start, size;
+	PetscReal                tolerance = simParams->fieldTolerances[name];
+	std::vector<PetscScalar> values;
+	std::vector<char>        bytes;
+	std::string              fileName = savePointDirectory() + "/" + name + ".enc";
+	MPI_File                 file;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
+
+	if(encoding == ERROR_BOUNDED && tolerance <= 0.0)
+	{
+		SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "The error bound of %s must be positive", name.c_str());
+	}
+
+	ierr = copyNaturalValues(v, values, start, size); CHKERRQ(ierr);
+	encodeValues(encoding, tolerance, (values.empty())? NULL : &values[0], values.size(), bytes);
+
+	// sizes of the chunks of all the processes
+	long long              chunk[2] = {(long long)values.size(), (long long)bytes.size()};
+	std::vector<long long> chunks(2*numProcs);
+	ierr = MPI_Allgather(chunk, 2, MPI_LONG_LONG, &chunks[0], 2, MPI_LONG_LONG, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	// header
+	std::vector<char> header(8 + 2*sizeof(int) + sizeof(long long) + sizeof(double));
+	int               info[2] = {(int)encoding, numProcs};
+	long long         numValues = size;
+	double            bound = tolerance;
+	memcpy(&header[0], "PETIBMEF", 8);
+	memcpy(&header[8], info, 2*sizeof(int));
+	memcpy(&header[8 + 2*sizeof(int)], &numValues, sizeof(long long));
+	memcpy(&header[8 + 2*sizeof(int) + sizeof(long long)], &bound, sizeof(double));
+	header.insert(header.end(), reinterpret_cast<char *>(&chunks[0]), reinterpret_cast<char *>(&chunks[0] + 2*numProcs));
+
+	MPI_Offset offset = header.size();
+	for(PetscMPIInt i=0; i<rank; i++)
+		offset += chunks[2*i+1];
+
+	ierr = MPI_File_open(PETSC_COMM_WORLD, const_cast<char *>(fileName.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file); CHKERRQ(ierr);
+	ierr = MPI_File_set_size(file, 0); CHKERRQ(ierr);
+	if(rank == 0)
+	{
+		ierr = MPI_File_write_at(file, 0, &header[0], header.size(), MPI_CHAR, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+	}
+	ierr = MPI_File_write_at_all(file, offset, (bytes.empty())? NULL : &bytes[0], bytes.size(), MPI_CHAR, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+	ierr = MPI_File_close(&file); CHKERRQ(ierr);
+
+	outputBytes += header.size();
+	for(PetscMPIInt i=0; i<numProcs; i++)
+		outputBytes += chunks[2*i+1];
+
+	return 0;
+}
+
+/**
+ * \brief Copies the local values of a flow variable into a record of the
+ *        save point written in the background.
+ *
+ * When the vector starts a new file, the first process creates it empty
+ * before any process hands its record over to its writing thread.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::stageField(Vec v, std::string fileName, PetscInt64 offset, PetscBool newFile)
+{
+	PetscErrorCode ierr;
+	PetscInt       rank;
+	AsyncRecord    record;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	record.fileName = fileName;
+	record.offset = offset;
+	record.header = (rank == 0)? PETSC_TRUE : PETSC_FALSE;
+	ierr = copyNaturalValues(v, record.values, record.start, record.size); CHKERRQ(ierr);
+
+	if(newFile)
+	{
+		if(rank == 0)
+		{
+			std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+			if(!file.good())
+			{
+				SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Unable to create the file %s", fileName.c_str());
+			}
+		}
+		ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
+	}
+	asyncWriter->add(record);
+
+	return 0;
+}
+
+/**
+ * \brief Reads a flow variable saved at the current time step.
+ *
+ * With the format `CONTAINER`, the last entry of the index for the time step
+ * and the variable gives the container and the offset at which the vector
+ * is read.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::readField(Vec v, std::string name)
+{
+	PetscErrorCode ierr;
+	PetscInt       rank, found = 0, length = 0;
+	PetscInt64     offset = 0;
+	PetscViewer    viewer;
+	std::string    fileName;
+
+	if(simParams->outputFormat == FOLDERS)
+	{
+		fileName = savePointDirectory() + "/" + name + ".dat";
+		ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_READ, &viewer); CHKERRQ(ierr);
+		ierr = VecLoad(v, viewer); CHKERRQ(ierr);
+		ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+		return 0;
+	}
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	if(rank == 0)
+	{
+		std::string   indexName = caseFolder + "/fields.index", line, variable, file;
+		std::ifstream index(indexName.c_str());
+		PetscInt      step, size;
+		PetscInt64    position;
+		while(std::getline(index, line))
+		{
+			if(line.empty() || line[0] == '#')
+				continue;
+			std::istringstream entry(line);
+			entry >> step >> variable >> file >> position >> size;
+			if(step == timeStep && variable == name)
+			{
+				found = 1;
+				fileName = file;
+				offset = position;
+			}
+		}
+		length = fileName.size();
+	}
+	ierr = MPI_Bcast(&found, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	if(!found)
+	{
+		SETERRQ2(PETSC_COMM_WORLD, PETSC_ERR_FILE_OPEN, "Variable %s of time step %d not found in fields.index", name.c_str(), timeStep);
+	}
+	ierr = MPI_Bcast(&length, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	fileName.resize(length);
+	ierr = MPI_Bcast(&fileName[0], length, MPI_CHAR, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	fileName = caseFolder + "/" + fileName;
+
+	ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr);
+	ierr = PetscViewerSetType(viewer, PETSCVIEWERBINARY); CHKERRQ(ierr);
+	ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
+	ierr = PetscViewerBinarySkipInfo(viewer); CHKERRQ(ierr);
+	ierr = PetscViewerFileSetName(viewer, fileName.c_str()); CHKERRQ(ierr);
+	// the vector is read by the first process
+	if(rank == 0)
+	{
+		int   fd;
+		off_t position;
+		ierr = PetscViewerBinaryGetDescriptor(viewer, &fd); CHKERRQ(ierr);
+		ierr = PetscBinarySeek(fd, offset, PETSC_BINARY_SEEK_SET, &position); CHKERRQ(ierr);
+	}
+	ierr = VecLoad(v, viewer); CHKERRQ(ierr);
+	ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Closes the current container and the index.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::closeContainer()
+{
+	PetscErrorCode ierr;
+
+	if(containerViewer != PETSC_NULL)
+	{
+		ierr = PetscViewerDestroy(&containerViewer); CHKERRQ(ierr);
+		containerViewer = PETSC_NULL;
+	}
+	if(containerIndex.is_open())
+		containerIndex.close();
+
+	return 0;
+}
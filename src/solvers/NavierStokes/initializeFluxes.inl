@@ -26,6 +26,10 @@
 * in the input file `simulationParameters.yaml`. The option `restart` is set to 
 * `true`, and the option `startStep` specifies the time step from which the 
 * simulation needs to be restarted.
+*
+* A simulation can also start from the data saved by another case, on another
+* grid (option `interpolateFrom`): the fluxes are then interpolated onto the
+* current grid.
 */
 template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::initializeFluxes()
@@ -42,6 +46,10 @@ PetscErrorCode NavierStokesSolver<2>::initializeFluxes()
   {
     ierr = readFluxes(); CHKERRQ(ierr);
   }
+  else if(!simParams->interpolationFolder.empty())
+  {
+    ierr = interpolateFluxes(); CHKERRQ(ierr);
+  }
   else
   {
     PetscInt  mstart, nstart, m, n;
@@ -108,6 +116,10 @@ PetscErrorCode NavierStokesSolver<3>::initializeFluxes()
   {
     ierr = readFluxes(); CHKERRQ(ierr);
   }
+  else if(!simParams->interpolationFolder.empty())
+  {
+    ierr = interpolateFluxes(); CHKERRQ(ierr);
+  }
   else
   {
     PetscInt  mstart, nstart, pstart, m, n, p;
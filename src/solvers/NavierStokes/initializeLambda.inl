@@ -8,19 +8,11 @@ PetscErrorCode NavierStokesSolver<dim>::initializeLambda()
 
 	if(simParams->restart)
 	{
-		PetscViewer       viewer;
-		std::stringstream ss;
-		std::string       savePointDir, fileName;
-
-		// the name of the folder is the time step at which data is saved
-		// 7 characters long, with leading zeros
-		ss << caseFolder << "/" << std::setfill('0') << std::setw(7) << timeStep;
-		savePointDir = ss.str();
-
-		fileName = savePointDir + "/phi.dat";
-		ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_READ, &viewer); CHKERRQ(ierr);
-		ierr = VecLoad(phi, viewer); CHKERRQ(ierr);
-		ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+		ierr = readField(phi, "phi"); CHKERRQ(ierr);
+	}
+	else if(!simParams->interpolationFolder.empty() && simParams->interpolationPressure)
+	{
+		ierr = interpolatePressure(phi); CHKERRQ(ierr);
 	}
 	
 	ierr = DMCompositeRestoreAccess(lambdaPack, lambda, &phi); CHKERRQ(ierr);
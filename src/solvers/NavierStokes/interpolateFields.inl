@@ -0,0 +1,270 @@
+/***************************************************************************//**
+ * \file interpolateFields.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c NavierStokesSolver that start a
+ *        simulation from the data of another case, saved on a different grid.
+ */
+
+
+/**
+ * \brief Reads the coordinates of the nodes of the grid of another case
+ *        (file `grid.txt` written by `writeGrid`).
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::readSourceGrid(std::string folder, std::vector<PetscReal> *nodes)
+{
+	PetscInt      numCells[3] = {0, 0, 0};
+	std::string   fileName = folder + "/grid.txt";
+	std::ifstream file(fileName.c_str());
+
+	if(!file.good())
+	{
+		SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Unable to open the file %s", fileName.c_str());
+	}
+	for(PetscInt d=0; d<dim; d++)
+		file >> numCells[d];
+	for(PetscInt d=0; d<dim; d++)
+	{
+		nodes[d].resize(numCells[d]+1);
+		for(PetscInt i=0; i<=numCells[d]; i++)
+			file >> nodes[d][i];
+	}
+	if(!file)
+	{
+		SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_READ, "Unable to read the grid in %s", fileName.c_str());
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Computes the weights of the linear interpolation at `x` of values
+ *        located at the positions `positions` (sorted).
+ *
+ * Outside the positions, the closest value is used, or, along a periodic
+ * direction of length `length`, the interpolation wraps around.
+ */
+template <PetscInt dim>
+void NavierStokesSolver<dim>::linearStencil(const std::vector<PetscReal> &positions, PetscBool periodic, PetscReal length, PetscReal x, std::vector< std::pair<PetscInt, PetscReal> > &stencil)
+{
+	PetscInt  n = positions.size();
+	PetscReal left, right, w;
+
+	stencil.clear();
+	if(x < positions[0] || x >= positions[n-1])
+	{
+		if(!periodic || n == 1)
+		{
+			stencil.push_back(std::make_pair((x < positions[0])? 0 : n-1, 1.0));
+			return;
+		}
+		left = (x < positions[0])? positions[n-1]-length : positions[n-1];
+		right = (x < positions[0])? positions[0] : positions[0]+length;
+		w = (x-left)/(right-left);
+		stencil.push_back(std::make_pair(n-1, 1.0-w));
+		stencil.push_back(std::make_pair(0, w));
+		return;
+	}
+	PetscInt k = std::upper_bound(positions.begin(), positions.end(), x) - positions.begin() - 1;
+	w = (x-positions[k])/(positions[k+1]-positions[k]);
+	stencil.push_back(std::make_pair(k, 1.0-w));
+	stencil.push_back(std::make_pair(k+1, w));
+}
+
+/**
+ * \brief Computes the weights of the average over `[a, b]` of values that
+ *        are constant in the cells of the nodes `nodes`; each weight is the
+ *        overlap with a cell divided by the width of the cell.
+ */
+template <PetscInt dim>
+void NavierStokesSolver<dim>::overlapStencil(const std::vector<PetscReal> &nodes, PetscReal a, PetscReal b, std::vector< std::pair<PetscInt, PetscReal> > &stencil)
+{
+	PetscInt first = std::upper_bound(nodes.begin(), nodes.end(), a) - nodes.begin() - 1;
+
+	stencil.clear();
+	first = std::max<PetscInt>(0, first);
+	for(PetscInt J=first; J<(PetscInt)nodes.size()-1 && nodes[J]<b; J++)
+	{
+		PetscReal overlap = std::min(b, nodes[J+1]) - std::max(a, nodes[J]);
+		if(overlap > 0.0)
+			stencil.push_back(std::make_pair(J, overlap/(nodes[J+1]-nodes[J])));
+	}
+}
+
+/**
+ * \brief Interpolates a flow variable saved on the grid of another case
+ *        onto the local portion of a distributed vector.
+ *
+ * `normal` is the direction of the flux stored in the vector, or -1 for the
+ * pressure. A flux is linearly interpolated along its direction, and
+ * integrated over the face of the cell in the other directions: the source
+ * flux divided by the area of its face is constant over the face, and the
+ * flux through the new face is the sum over the overlapping source faces.
+ * The flux through any plane normal to its direction is thus conserved.
+ * The pressure is linearly interpolated in all the directions.
+ *
+ * Every process reads the whole saved vector: the saved case is meant to be
+ * coarser than the current one.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::interpolateField(DM da, Vec v, std::string fileName, PetscInt normal, std::vector<PetscReal> *sourceNodes)
+{
+	PetscErrorCode ierr;
+	PetscViewer    viewer;
+	Vec            source;
+	PetscInt       sourceSize[3] = {1, 1, 1}, size, start[3] = {0, 0, 0}, width[3] = {1, 1, 1};
+	PetscReal      *values, length;
+	const PetscReal *sourceValues;
+	PetscBool      periodic;
+	Boundary       plus[3] = {XPLUS, YPLUS, ZPLUS};
+	const std::vector<PetscReal> *nodes[3] = {&mesh->x, &mesh->y, &mesh->z};
+	std::vector< std::vector< std::vector< std::pair<PetscInt, PetscReal> > > > stencils(3);
+
+	// saved vector
+	ierr = PetscViewerBinaryOpen(PETSC_COMM_SELF, fileName.c_str(), FILE_MODE_READ, &viewer); CHKERRQ(ierr);
+	ierr = VecCreate(PETSC_COMM_SELF, &source); CHKERRQ(ierr);
+	ierr = VecSetType(source, VECSEQ); CHKERRQ(ierr);
+	ierr = VecLoad(source, viewer); CHKERRQ(ierr);
+	ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+
+	for(PetscInt d=0; d<dim; d++)
+	{
+		periodic = (flowDesc->bc[0][plus[d]].type == PERIODIC)? PETSC_TRUE : PETSC_FALSE;
+		sourceSize[d] = sourceNodes[d].size()-1;
+		if(d == normal && !periodic)
+			sourceSize[d]--;
+	}
+	ierr = VecGetSize(source, &size); CHKERRQ(ierr);
+	if(size != sourceSize[0]*sourceSize[1]*sourceSize[2])
+	{
+		SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED, "The size of %s does not match its grid (%d values)", fileName.c_str(), size);
+	}
+
+	// one-dimensional stencils along each direction
+	ierr = DMDAGetCorners(da, &start[0], &start[1], &start[2], &width[0], &width[1], &width[2]); CHKERRQ(ierr);
+	for(PetscInt d=0; d<dim; d++)
+	{
+		const std::vector<PetscReal> &x = *nodes[d], &xs = sourceNodes[d];
+		std::vector<PetscReal> positions(sourceSize[d]);
+		periodic = (flowDesc->bc[0][plus[d]].type == PERIODIC)? PETSC_TRUE : PETSC_FALSE;
+		length = xs.back() - xs.front();
+		for(PetscInt I=0; I<sourceSize[d]; I++)
+			positions[I] = (d == normal)? xs[I+1] : 0.5*(xs[I]+xs[I+1]);
+		stencils[d].resize(width[d]);
+		for(PetscInt i=start[d]; i<start[d]+width[d]; i++)
+		{
+			if(d == normal)
+				linearStencil(positions, periodic, length, x[i+1], stencils[d][i-start[d]]);
+			else if(normal >= 0)
+				overlapStencil(xs, x[i], x[i+1], stencils[d][i-start[d]]);
+			else
+				linearStencil(positions, periodic, length, 0.5*(x[i]+x[i+1]), stencils[d][i-start[d]]);
+		}
+	}
+	if(dim == 2)
+		stencils[2].assign(1, std::vector< std::pair<PetscInt, PetscReal> >(1, std::make_pair(0, 1.0)));
+
+	// tensor product of the stencils (local values are ordered with i fastest)
+	ierr = VecGetArrayRead(source, &sourceValues); CHKERRQ(ierr);
+	ierr = VecGetArray(v, &values); CHKERRQ(ierr);
+	PetscInt row = 0;
+	for(PetscInt k=0; k<((dim == 3)? width[2] : 1); k++)
+	{
+		for(PetscInt j=0; j<width[1]; j++)
+		{
+			for(PetscInt i=0; i<width[0]; i++)
+			{
+				PetscReal value = 0.0;
+				for(size_t c=0; c<stencils[2][k].size(); c++)
+					for(size_t b=0; b<stencils[1][j].size(); b++)
+						for(size_t a=0; a<stencils[0][i].size(); a++)
+						{
+							PetscInt I = stencils[0][i][a].first,
+							         J = stencils[1][j][b].first,
+							         K = stencils[2][k][c].first;
+							value += stencils[0][i][a].second*stencils[1][j][b].second*stencils[2][k][c].second
+							         *sourceValues[I + sourceSize[0]*(J + sourceSize[1]*K)];
+						}
+				values[row++] = value;
+			}
+		}
+	}
+	ierr = VecRestoreArray(v, &values); CHKERRQ(ierr);
+	ierr = VecRestoreArrayRead(source, &sourceValues); CHKERRQ(ierr);
+	ierr = VecDestroy(&source); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Returns the folder of the case whose data are interpolated.
+ *
+ * A relative path is relative to the current case.
+ */
+template <PetscInt dim>
+std::string NavierStokesSolver<dim>::interpolationCaseFolder()
+{
+	std::string folder = simParams->interpolationFolder;
+
+	return (folder[0] == '/')? folder : caseFolder + "/" + folder;
+}
+
+/**
+ * \brief Returns the folder of the saved data to interpolate.
+ */
+template <PetscInt dim>
+std::string NavierStokesSolver<dim>::interpolationDirectory()
+{
+	std::stringstream ss;
+
+	ss << interpolationCaseFolder() << "/" << std::setfill('0') << std::setw(7) << simParams->interpolationStep;
+	return ss.str();
+}
+
+/**
+ * \brief Initializes the fluxes with those saved by another case, on another
+ *        grid, interpolated onto the current grid.
+ *
+ * The interpolated fluxes are not exactly divergence-free on the new grid:
+ * the projection step of the first time step makes them so.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::interpolateFluxes()
+{
+	PetscErrorCode         ierr;
+	DM                     das[3];
+	Vec                    vecs[3];
+	std::vector<PetscReal> sourceNodes[3];
+	std::string            dataFolder = interpolationDirectory();
+	const char             *names[3] = {"qx", "qy", "qz"};
+
+	ierr = PetscPrintf(PETSC_COMM_WORLD, "\nInterpolating the fluxes from %s.\n", dataFolder.c_str()); CHKERRQ(ierr);
+	ierr = readSourceGrid(interpolationCaseFolder(), sourceNodes); CHKERRQ(ierr);
+
+	ierr = DMCompositeGetEntriesArray(qPack, das); CHKERRQ(ierr);
+	ierr = DMCompositeGetAccessArray(qPack, q, dim, NULL, vecs); CHKERRQ(ierr);
+	for(PetscInt d=0; d<dim; d++)
+	{
+		ierr = interpolateField(das[d], vecs[d], dataFolder + "/" + names[d] + ".dat", d, sourceNodes); CHKERRQ(ierr);
+	}
+	ierr = DMCompositeRestoreAccessArray(qPack, q, dim, NULL, vecs); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Initializes the pressure with that saved by another case, on
+ *        another grid, interpolated onto the current grid.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::interpolatePressure(Vec phi)
+{
+	PetscErrorCode         ierr;
+	std::vector<PetscReal> sourceNodes[3];
+
+	ierr = PetscPrintf(PETSC_COMM_WORLD, "Interpolating the pressure from %s.\n", interpolationDirectory().c_str()); CHKERRQ(ierr);
+	ierr = readSourceGrid(interpolationCaseFolder(), sourceNodes); CHKERRQ(ierr);
+	ierr = interpolateField(pda, phi, interpolationDirectory() + "/phi.dat", -1, sourceNodes); CHKERRQ(ierr);
+
+	return 0;
+}
@@ -0,0 +1,165 @@
+/***************************************************************************//**
+ * \file outputRegions.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c NavierStokesSolver that write
+ *        the flow variables in regions of the domain.
+ */
+
+
+/**
+ * \brief Creates the scatters that extract the flow variables of the output
+ *        regions, and writes the grid of each region.
+ *
+ * For each region and each variable (`qx`, `qy`, `qz` and `phi`), the grid
+ * lines of the variable inside the bounding box are selected, one out of
+ * `stride` in each direction. The selected values form a new vector,
+ * distributed evenly among the processes, filled by a scatter from the
+ * global vector of the variable. The file `<region>/grid.txt` gives, for each
+ * variable, its name and number of points in each direction, followed by the
+ * coordinates of the points along each direction.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::createOutputRegions()
+{
+	PetscErrorCode ierr;
+	PetscInt       rank, size[3], start, end;
+	DM             das[4];
+	Vec            global;
+	AO             ao;
+	IS             is;
+	const char     *names[4] = {"qx", "qy", "qz", "phi"};
+	const std::vector<PetscReal> *nodes[3] = {&mesh->x, &mesh->y, &mesh->z};
+
+	std::vector<OutputRegion> &regions = simParams->outputRegions;
+
+	if(regions.empty())
+		return 0;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+	ierr = DMCompositeGetEntriesArray(qPack, das); CHKERRQ(ierr);
+	das[dim] = pda;
+
+	regionScatters.resize(regions.size());
+	regionVecs.resize(regions.size());
+	for(size_t r=0; r<regions.size(); r++)
+	{
+		std::string   folder = caseFolder + "/" + regions[r].name;
+		std::ofstream gridFile;
+
+		mkdir(folder.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+		if(rank == 0)
+			gridFile.open((folder + "/grid.txt").c_str());
+
+		regionScatters[r].assign(dim+1, PETSC_NULL);
+		regionVecs[r].assign(dim+1, PETSC_NULL);
+		for(PetscInt v=0; v<=dim; v++)
+		{
+			ierr = DMDAGetInfo(das[v], NULL, &size[0], &size[1], &size[2], NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+
+			// selected grid lines and their coordinates along each direction
+			std::vector<PetscInt>  lines[3];
+			std::vector<PetscReal> coords[3];
+			PetscInt               numPoints = 1;
+			for(PetscInt d=0; d<dim; d++)
+			{
+				for(PetscInt i=0; i<size[d]; i++)
+				{
+					// fluxes are at the faces normal to their direction, the rest at the cell centres
+					PetscReal x = (v == d)? (*nodes[d])[i+1] : 0.5*((*nodes[d])[i] + (*nodes[d])[i+1]);
+					if(x < regions[r].lower[d] || x > regions[r].upper[d])
+						continue;
+					if(lines[d].empty() || i - lines[d].front() == regions[r].stride*(PetscInt)lines[d].size())
+					{
+						lines[d].push_back(i);
+						coords[d].push_back(x);
+					}
+				}
+				numPoints *= lines[d].size();
+			}
+			if(rank == 0)
+			{
+				gridFile << names[(v == dim)? 3 : v];
+				for(PetscInt d=0; d<dim; d++)
+					gridFile << '\t' << lines[d].size();
+				gridFile << '\n';
+				gridFile.precision(16);
+				for(PetscInt d=0; d<dim; d++)
+				{
+					for(size_t i=0; i<coords[d].size(); i++)
+						gridFile << coords[d][i] << '\n';
+				}
+			}
+			if(numPoints == 0)
+				continue;
+
+			// indices of the selected points owned by the process (natural ordering, then PETSc ordering)
+			ierr = VecCreateMPI(PETSC_COMM_WORLD, PETSC_DECIDE, numPoints, &regionVecs[r][v]); CHKERRQ(ierr);
+			ierr = VecGetOwnershipRange(regionVecs[r][v], &start, &end); CHKERRQ(ierr);
+			std::vector<PetscInt> indices(end-start);
+			for(PetscInt m=start; m<end; m++)
+			{
+				PetscInt a = m%lines[0].size(),
+				         b = (m/lines[0].size())%lines[1].size(),
+				         c = (dim == 3)? m/(lines[0].size()*lines[1].size()) : 0;
+				indices[m-start] = lines[0][a] + size[0]*(lines[1][b] + ((dim == 3)? size[1]*lines[2][c] : 0));
+			}
+			ierr = DMDAGetAO(das[v], &ao); CHKERRQ(ierr);
+			ierr = AOApplicationToPetsc(ao, end-start, (indices.empty())? NULL : &indices[0]); CHKERRQ(ierr);
+			ierr = ISCreateGeneral(PETSC_COMM_WORLD, end-start, (indices.empty())? NULL : &indices[0], PETSC_COPY_VALUES, &is); CHKERRQ(ierr);
+			ierr = DMGetGlobalVector(das[v], &global); CHKERRQ(ierr);
+			ierr = VecScatterCreate(global, is, regionVecs[r][v], NULL, &regionScatters[r][v]); CHKERRQ(ierr);
+			ierr = DMRestoreGlobalVector(das[v], &global); CHKERRQ(ierr);
+			ierr = ISDestroy(&is); CHKERRQ(ierr);
+		}
+		if(rank == 0)
+			gridFile.close();
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Writes the flow variables of the regions whose output interval
+ *        divides the current time step, in the folders
+ *        `<region>/<time step>/`.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeOutputRegions()
+{
+	PetscErrorCode ierr;
+	Vec            vecs[4];
+	PetscInt       wanted = 0;
+	PetscViewer    viewer;
+	const char     *names[4] = {"qx", "qy", "qz", "phi"};
+
+	std::vector<OutputRegion> &regions = simParams->outputRegions;
+
+	for(size_t r=0; r<regions.size(); r++)
+	{
+		if(timeStep % regions[r].interval != 0)
+			continue;
+
+		std::stringstream ss;
+		ss << caseFolder << "/" << regions[r].name << "/" << std::setfill('0') << std::setw(7) << timeStep;
+		std::string folder = ss.str();
+		mkdir(folder.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+
+		ierr = DMCompositeGetAccessArray(qPack, q, dim, NULL, vecs); CHKERRQ(ierr);
+		ierr = DMCompositeGetAccessArray(lambdaPack, lambda, 1, &wanted, &vecs[dim]); CHKERRQ(ierr);
+		for(PetscInt v=0; v<=dim; v++)
+		{
+			if(regionScatters[r][v] == PETSC_NULL)
+				continue;
+			ierr = VecScatterBegin(regionScatters[r][v], vecs[v], regionVecs[r][v], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+			ierr = VecScatterEnd(regionScatters[r][v], vecs[v], regionVecs[r][v], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+			std::string fileName = folder + "/" + names[(v == dim)? 3 : v] + ".dat";
+			ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_WRITE, &viewer); CHKERRQ(ierr);
+			ierr = VecView(regionVecs[r][v], viewer); CHKERRQ(ierr);
+			ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+		}
+		ierr = DMCompositeRestoreAccessArray(lambdaPack, lambda, 1, &wanted, &vecs[dim]); CHKERRQ(ierr);
+		ierr = DMCompositeRestoreAccessArray(qPack, q, dim, NULL, vecs); CHKERRQ(ierr);
+	}
+
+	return 0;
+}
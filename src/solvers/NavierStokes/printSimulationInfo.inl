@@ -32,10 +32,46 @@ PetscErrorCode NavierStokesSolver<dim>::printSimulationInfo()
 		case TAIRA_COLONIUS: 
 			ierr = PetscPrintf(PETSC_COMM_WORLD, "Taira & Colonius (2007)\n"); CHKERRQ(ierr);
 			break;
+		case DIRECT_FORCING:
+			ierr = PetscPrintf(PETSC_COMM_WORLD, "direct forcing (%d forcing iteration(s))\n", simParams->forcingIterations); CHKERRQ(ierr);
+			break;
+		case NULL_SPACE:
+			ierr = PetscPrintf(PETSC_COMM_WORLD, "discrete streamfunction (null-space) formulation\n"); CHKERRQ(ierr);
+			break;
 		default:
 			ierr = PetscPrintf(PETSC_COMM_WORLD, "Unrecognized solver!\n"); CHKERRQ(ierr);
 			break;
 	}
+	if(simParams->solverType == TAIRA_COLONIUS || simParams->solverType == DIRECT_FORCING || simParams->solverType == NULL_SPACE)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "delta function: "); CHKERRQ(ierr);
+		switch (simParams->deltaFunction)
+		{
+			case ROMA_ET_AL:
+				ierr = PetscPrintf(PETSC_COMM_WORLD, "Roma et al. (1999), 3-point\n"); CHKERRQ(ierr);
+				break;
+			case PESKIN_4:
+				ierr = PetscPrintf(PETSC_COMM_WORLD, "Peskin (2002), 4-point\n"); CHKERRQ(ierr);
+				break;
+			case BSPLINE_6:
+				ierr = PetscPrintf(PETSC_COMM_WORLD, "quintic B-spline, 6-point\n"); CHKERRQ(ierr);
+				break;
+			default:
+				break;
+		}
+		if(simParams->decomposition == BODY_WEIGHTED)
+		{
+			ierr = PetscPrintf(PETSC_COMM_WORLD, "decomposition: body-weighted (body cost weight: %g)\n", simParams->bodyCostWeight); CHKERRQ(ierr);
+		}
+		if(simParams->solverType == TAIRA_COLONIUS && simParams->forceSolver == SCHUR_COMPLEMENT)
+		{
+			ierr = PetscPrintf(PETSC_COMM_WORLD, "force solver: precomputed Schur complement (at most %d force components)\n", simParams->schurMaxForces); CHKERRQ(ierr);
+		}
+		if(simParams->solverType == TAIRA_COLONIUS && simParams->forceScaling)
+		{
+			ierr = PetscPrintf(PETSC_COMM_WORLD, "force scaling: symmetric diagonal\n"); CHKERRQ(ierr);
+		}
+	}
 	ierr = PetscPrintf(PETSC_COMM_WORLD, "viscosity: %g\n", flowDesc->nu); CHKERRQ(ierr);
 	
 	ierr = PetscPrintf(PETSC_COMM_WORLD, "\n---------------------------------------\n"); CHKERRQ(ierr);
@@ -82,8 +118,76 @@ PetscErrorCode NavierStokesSolver<dim>::printSimulationInfo()
 	}
 	ierr = PetscPrintf(PETSC_COMM_WORLD, "time-increment      : %g\n", simParams->dt); CHKERRQ(ierr);
 	ierr = PetscPrintf(PETSC_COMM_WORLD, "starting time-step  : %d\n", simParams->startStep); CHKERRQ(ierr);
+	if(!simParams->interpolationFolder.empty())
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "initial conditions  : time step %d of %s (interpolated)\n", simParams->interpolationStep, simParams->interpolationFolder.c_str()); CHKERRQ(ierr);
+	}
 	ierr = PetscPrintf(PETSC_COMM_WORLD, "number of time-steps: %d\n", simParams->nt); CHKERRQ(ierr);
 	ierr = PetscPrintf(PETSC_COMM_WORLD, "saving-interval     : %d\n", simParams->nsave); CHKERRQ(ierr);
+	if(simParams->outputFormat == CONTAINER)
+	{
+		if(simParams->snapshotsPerFile > 0)
+		{
+			ierr = PetscPrintf(PETSC_COMM_WORLD, "output format       : container (%d save points per file)\n", simParams->snapshotsPerFile); CHKERRQ(ierr);
+		}
+		else
+		{
+			ierr = PetscPrintf(PETSC_COMM_WORLD, "output format       : container (single file)\n"); CHKERRQ(ierr);
+		}
+	}
+	if(simParams->encodedOutput())
+	{
+		if(simParams->nrestart > 0)
+		{
+			ierr = PetscPrintf(PETSC_COMM_WORLD, "restart-interval    : %d\n", simParams->nrestart); CHKERRQ(ierr);
+		}
+		else
+		{
+			ierr = PetscPrintf(PETSC_COMM_WORLD, "restart-interval    : last time step\n"); CHKERRQ(ierr);
+		}
+	}
+	for(std::map<std::string, FieldEncoding>::iterator it=simParams->fieldEncodings.begin(); it!=simParams->fieldEncodings.end(); ++it)
+	{
+		switch(it->second)
+		{
+			case SINGLE_PRECISION:
+				ierr = PetscPrintf(PETSC_COMM_WORLD, "output of %-10s: single precision\n", it->first.c_str()); CHKERRQ(ierr);
+				break;
+			case LOSSLESS:
+				ierr = PetscPrintf(PETSC_COMM_WORLD, "output of %-10s: lossless compression\n", it->first.c_str()); CHKERRQ(ierr);
+				break;
+			case ERROR_BOUNDED:
+				ierr = PetscPrintf(PETSC_COMM_WORLD, "output of %-10s: error-bounded compression (%g)\n", it->first.c_str(), simParams->fieldTolerances[it->first]); CHKERRQ(ierr);
+				break;
+			default:
+				break;
+		}
+	}
+	for(size_t r=0; r<simParams->outputRegions.size(); r++)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "output region       : %s (every %d time steps, stride %d)\n", simParams->outputRegions[r].name.c_str(), simParams->outputRegions[r].interval, simParams->outputRegions[r].stride); CHKERRQ(ierr);
+	}
+	if(simParams->asyncSnapshots > 0)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "background output   : up to %d save points in flight\n", simParams->asyncSnapshots); CHKERRQ(ierr);
+	}
+	if(simParams->visualizationFormat == XDMF)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "visualization       : XDMF (cell-centred)\n"); CHKERRQ(ierr);
+	}
+	else if(simParams->visualizationFormat == VTK_RECTILINEAR)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "visualization       : VTK rectilinear grid (cell-centred)\n"); CHKERRQ(ierr);
+	}
+	ierr = PetscPrintf(PETSC_COMM_WORLD, "telemetry-interval  : %d%s\n", simParams->telemetryInterval, (simParams->legacyLogs)? "" : " (no text logs)"); CHKERRQ(ierr);
+	for(size_t s=0; s<simParams->probes.size(); s++)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "probes              : %s (%d points, every %d time steps)\n", simParams->probes[s].name.c_str(), (PetscInt)(simParams->probes[s].points.size()/3), simParams->probes[s].interval); CHKERRQ(ierr);
+	}
+	if(simParams->statisticsStart >= 0)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "statistics          : mean and RMS after time step %d\n", simParams->statisticsStart); CHKERRQ(ierr);
+	}
 
 	ierr = PetscPrintf(PETSC_COMM_WORLD, "\n---------------------------------------\n"); CHKERRQ(ierr);
 	ierr = PetscPrintf(PETSC_COMM_WORLD, "Linear system for intermediate velocity\n"); CHKERRQ(ierr);
@@ -0,0 +1,315 @@
+/***************************************************************************//**
+ * \file probes.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c NavierStokesSolver that sample
+ *        the flow variables at probe points during the simulation.
+ */
+
+
+/**
+ * \brief Precomputes the interpolation of the flow variables at the probe
+ *        points located in the cells owned by the process.
+ *
+ * Each variable is linearly interpolated from the 2 (3D: 4) closest grid
+ * points of its staggered grid along each direction (the closest value is
+ * used beyond the first or last point, except along periodic directions).
+ * For each set and each variable, a scatter gathers the values of the
+ * interpolation stencils from the global vector, and the weights, which
+ * include the conversion of the fluxes into velocities, are stored. Process
+ * 0 writes the header of the file `probes/<name>.txt`: the coordinates of
+ * the points and the names of the columns.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::createProbes()
+{
+	PetscErrorCode ierr;
+	PetscInt       rank, size[3] = {1, 1, 1}, start[3] = {0, 0, 0}, width[3] = {1, 1, 1};
+	PetscInt       stencilSize = (dim == 3)? 8 : 4;
+	DM             das[4];
+	Vec            global;
+	AO             ao;
+	IS             is;
+	Boundary       plus[3] = {XPLUS, YPLUS, ZPLUS};
+	const char     *names[4] = {"u", "v", "w", "p"};
+	const std::vector<PetscReal> *nodes[3] = {&mesh->x, &mesh->y, &mesh->z},
+	                             *widths[3] = {&mesh->dx, &mesh->dy, &mesh->dz};
+
+	std::vector<ProbeSet> &sets = simParams->probes;
+
+	if(sets.empty())
+		return 0;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+	ierr = DMCompositeGetEntriesArray(qPack, das); CHKERRQ(ierr);
+	das[dim] = pda;
+	ierr = DMDAGetCorners(pda, &start[0], &start[1], &start[2], &width[0], &width[1], &width[2]); CHKERRQ(ierr);
+	mkdir((caseFolder + "/probes").c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+
+	probePoints.resize(sets.size());
+	probeWeights.resize(sets.size());
+	probeScatters.resize(sets.size());
+	probeStencilValues.resize(sets.size());
+	probeSamples.resize(sets.size());
+	probeTimes.resize(sets.size());
+	for(size_t s=0; s<sets.size(); s++)
+	{
+		PetscInt numPoints = sets[s].points.size()/3;
+
+		// points located in the cells owned by the process
+		for(PetscInt p=0; p<numPoints; p++)
+		{
+			PetscBool owned = PETSC_TRUE;
+			for(PetscInt d=0; d<dim; d++)
+			{
+				PetscInt numCells = nodes[d]->size()-1,
+				         cell = std::upper_bound(nodes[d]->begin(), nodes[d]->end(), sets[s].points[3*p+d]) - nodes[d]->begin() - 1;
+				cell = std::min(std::max<PetscInt>(cell, 0), numCells-1);
+				if(cell < start[d] || cell >= start[d]+width[d])
+					owned = PETSC_FALSE;
+			}
+			if(owned)
+				probePoints[s].push_back(p);
+		}
+		PetscInt numLocal = probePoints[s].size();
+
+		probeWeights[s].resize(dim+1);
+		probeScatters[s].assign(dim+1, PETSC_NULL);
+		probeStencilValues[s].assign(dim+1, PETSC_NULL);
+		for(PetscInt v=0; v<=dim; v++)
+		{
+			// positions of the variable along each direction
+			std::vector<PetscReal> positions[3];
+			ierr = DMDAGetInfo(das[v], NULL, &size[0], &size[1], &size[2], NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+			for(PetscInt d=0; d<dim; d++)
+			{
+				const std::vector<PetscReal> &x = *nodes[d];
+				positions[d].resize(size[d]);
+				for(PetscInt i=0; i<size[d]; i++)
+					positions[d][i] = (v == d)? x[i+1] : 0.5*(x[i]+x[i+1]);
+			}
+
+			// interpolation stencils (natural ordering) and weights
+			std::vector<PetscInt>  indices(numLocal*stencilSize);
+			std::vector<PetscReal> &weights = probeWeights[s][v];
+			weights.resize(numLocal*stencilSize);
+			for(PetscInt l=0; l<numLocal; l++)
+			{
+				std::vector< std::pair<PetscInt, PetscReal> > stencils[3];
+				const PetscReal *point = &sets[s].points[3*probePoints[s][l]];
+				for(PetscInt d=0; d<dim; d++)
+				{
+					PetscBool periodic = (flowDesc->bc[0][plus[d]].type == PERIODIC)? PETSC_TRUE : PETSC_FALSE;
+					linearStencil(positions[d], periodic, nodes[d]->back()-nodes[d]->front(), point[d], stencils[d]);
+					if(stencils[d].size() == 1)
+						stencils[d].push_back(std::make_pair(stencils[d][0].first, 0.0));
+				}
+				if(dim == 2)
+				{
+					stencils[2].push_back(std::make_pair(0, 1.0));
+					stencils[2].push_back(std::make_pair(0, 0.0));
+				}
+				PetscInt n = l*stencilSize;
+				for(PetscInt c=0; c<((dim == 3)? 2 : 1); c++)
+				{
+					for(PetscInt b=0; b<2; b++)
+					{
+						for(PetscInt a=0; a<2; a++)
+						{
+							PetscInt  index[3] = {stencils[0][a].first, stencils[1][b].first, stencils[2][c].first};
+							PetscReal weight = stencils[0][a].second*stencils[1][b].second*stencils[2][c].second;
+							// flux to velocity: divide by the area of the face
+							for(PetscInt d=0; d<dim && v<dim; d++)
+							{
+								if(d != v)
+									weight /= (*widths[d])[index[d]];
+							}
+							indices[n] = index[0] + size[0]*(index[1] + size[1]*index[2]);
+							weights[n] = weight;
+							n++;
+						}
+					}
+				}
+			}
+
+			// scatter of the values of the stencils
+			ierr = DMDAGetAO(das[v], &ao); CHKERRQ(ierr);
+			ierr = AOApplicationToPetsc(ao, indices.size(), (indices.empty())? NULL : &indices[0]); CHKERRQ(ierr);
+			ierr = ISCreateGeneral(PETSC_COMM_SELF, indices.size(), (indices.empty())? NULL : &indices[0], PETSC_COPY_VALUES, &is); CHKERRQ(ierr);
+			ierr = VecCreateSeq(PETSC_COMM_SELF, indices.size(), &probeStencilValues[s][v]); CHKERRQ(ierr);
+			ierr = DMGetGlobalVector(das[v], &global); CHKERRQ(ierr);
+			ierr = VecScatterCreate(global, is, probeStencilValues[s][v], NULL, &probeScatters[s][v]); CHKERRQ(ierr);
+			ierr = DMRestoreGlobalVector(das[v], &global); CHKERRQ(ierr);
+			ierr = ISDestroy(&is); CHKERRQ(ierr);
+		}
+
+		// header of the output file (kept when the simulation is restarted)
+		if(rank == 0 && !simParams->restart)
+		{
+			std::ofstream file((caseFolder + "/probes/" + sets[s].name + ".txt").c_str());
+			file.precision(10);
+			for(PetscInt p=0; p<numPoints; p++)
+			{
+				file << "# point " << p << ":";
+				for(PetscInt d=0; d<dim; d++)
+					file << ' ' << sets[s].points[3*p+d];
+				file << '\n';
+			}
+			file << "# time";
+			for(PetscInt v=0; v<=dim; v++)
+			{
+				for(PetscInt p=0; p<numPoints; p++)
+					file << ' ' << names[(v == dim)? 3 : v] << p;
+			}
+			file << '\n';
+			file.close();
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Is any set of probes sampled at the current time step?
+ */
+template <PetscInt dim>
+PetscBool NavierStokesSolver<dim>::probeStep()
+{
+	for(size_t s=0; s<simParams->probes.size(); s++)
+	{
+		if(timeStep % simParams->probes[s].interval == 0)
+			return PETSC_TRUE;
+	}
+	return PETSC_FALSE;
+}
+
+/**
+ * \brief Samples the flow variables at the probe points of the sets whose
+ *        interval divides the current time step.
+ *
+ * The samples are kept in memory and written every `telemetryInterval`
+ * samples.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::sampleProbes()
+{
+	PetscErrorCode  ierr;
+	Vec             vecs[4];
+	PetscInt        wanted = 0, stencilSize = (dim == 3)? 8 : 4;
+	const PetscReal *values;
+
+	std::vector<ProbeSet> &sets = simParams->probes;
+
+	for(size_t s=0; s<sets.size(); s++)
+	{
+		if(timeStep % sets[s].interval != 0)
+			continue;
+
+		ierr = DMCompositeGetAccessArray(qPack, q, dim, NULL, vecs); CHKERRQ(ierr);
+		ierr = DMCompositeGetAccessArray(lambdaPack, lambda, 1, &wanted, &vecs[dim]); CHKERRQ(ierr);
+		for(PetscInt v=0; v<=dim; v++)
+		{
+			ierr = VecScatterBegin(probeScatters[s][v], vecs[v], probeStencilValues[s][v], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+			ierr = VecScatterEnd(probeScatters[s][v], vecs[v], probeStencilValues[s][v], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+		}
+		ierr = DMCompositeRestoreAccessArray(lambdaPack, lambda, 1, &wanted, &vecs[dim]); CHKERRQ(ierr);
+		ierr = DMCompositeRestoreAccessArray(qPack, q, dim, NULL, vecs); CHKERRQ(ierr);
+
+		// samples ordered by variable, then by point
+		for(PetscInt v=0; v<=dim; v++)
+		{
+			const std::vector<PetscReal> &weights = probeWeights[s][v];
+			ierr = VecGetArrayRead(probeStencilValues[s][v], &values); CHKERRQ(ierr);
+			for(size_t l=0; l<probePoints[s].size(); l++)
+			{
+				PetscReal sample = 0.0;
+				for(PetscInt n=l*stencilSize; n<(PetscInt)(l+1)*stencilSize; n++)
+					sample += weights[n]*values[n];
+				probeSamples[s].push_back(sample);
+			}
+			ierr = VecRestoreArrayRead(probeStencilValues[s][v], &values); CHKERRQ(ierr);
+		}
+		probeTimes[s].push_back(timeStep*simParams->dt);
+
+		if((PetscInt)probeTimes[s].size() >= simParams->telemetryInterval)
+		{
+			ierr = flushProbes(s); CHKERRQ(ierr);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Gathers the buffered samples of a set of probes on process 0, which
+ *        appends them to the file of the set (one line per sample).
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::flushProbes(size_t s)
+{
+	PetscErrorCode ierr;
+	PetscInt       rank, numProcs, numLocal = probePoints[s].size(), numSamples = probeTimes[s].size();
+	PetscInt       numPoints = simParams->probes[s].points.size()/3, numValues = dim+1;
+	std::vector<PetscInt>  counts, offsets, valueCounts, valueOffsets, points;
+	std::vector<PetscReal> samples;
+
+	if(numSamples == 0)
+		return 0;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
+
+	// points of each process, then their samples
+	if(rank == 0)
+	{
+		counts.resize(numProcs);
+		offsets.resize(numProcs);
+		valueCounts.resize(numProcs);
+		valueOffsets.resize(numProcs);
+	}
+	ierr = MPI_Gather(&numLocal, 1, MPIU_INT, (rank == 0)? &counts[0] : NULL, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	if(rank == 0)
+	{
+		for(PetscInt r=0; r<numProcs; r++)
+		{
+			offsets[r] = (r == 0)? 0 : offsets[r-1] + counts[r-1];
+			valueCounts[r] = counts[r]*numValues*numSamples;
+			valueOffsets[r] = (r == 0)? 0 : valueOffsets[r-1] + valueCounts[r-1];
+		}
+		points.resize(numPoints);
+		samples.resize(numPoints*numValues*numSamples);
+	}
+	ierr = MPI_Gatherv((numLocal > 0)? &probePoints[s][0] : NULL, numLocal, MPIU_INT, (rank == 0)? &points[0] : NULL, (rank == 0)? &counts[0] : NULL, (rank == 0)? &offsets[0] : NULL, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	ierr = MPI_Gatherv((numLocal > 0)? &probeSamples[s][0] : NULL, numLocal*numValues*numSamples, MPIU_REAL, (rank == 0)? &samples[0] : NULL, (rank == 0)? &valueCounts[0] : NULL, (rank == 0)? &valueOffsets[0] : NULL, MPIU_REAL, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	if(rank == 0)
+	{
+		std::vector<PetscReal> line(numValues*numPoints, 0.0);
+		std::ofstream          file((caseFolder + "/probes/" + simParams->probes[s].name + ".txt").c_str(), std::ios::out | std::ios::app);
+		file.precision(10);
+		for(PetscInt t=0; t<numSamples; t++)
+		{
+			// the samples of a process are ordered by time step, variable and point
+			for(PetscInt r=0; r<numProcs; r++)
+			{
+				for(PetscInt v=0; v<numValues; v++)
+				{
+					for(PetscInt l=0; l<counts[r]; l++)
+						line[v*numPoints + points[offsets[r]+l]] = samples[valueOffsets[r] + (t*numValues + v)*counts[r] + l];
+				}
+			}
+			file << probeTimes[s][t];
+			for(size_t k=0; k<line.size(); k++)
+				file << ' ' << line[k];
+			file << '\n';
+		}
+		file.close();
+		if(!file)
+		{
+			SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Unable to write the probes %s", simParams->probes[s].name.c_str());
+		}
+	}
+	probeSamples[s].clear();
+	probeTimes[s].clear();
+
+	return 0;
+}
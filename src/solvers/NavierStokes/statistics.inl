@@ -0,0 +1,133 @@
+/***************************************************************************//**
+ * \file statistics.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c NavierStokesSolver that compute
+ *        the mean and the root-mean-square fluctuation of the flow variables
+ *        during the simulation.
+ */
+
+
+/**
+ * \brief Is the time step being computed sampled for the statistics?
+ *
+ * The time steps after `statisticsStart` are sampled.
+ */
+template <PetscInt dim>
+PetscBool NavierStokesSolver<dim>::statisticsStep()
+{
+	return (simParams->statisticsStart >= 0 && timeStep >= simParams->statisticsStart)? PETSC_TRUE : PETSC_FALSE;
+}
+
+/**
+ * \brief Creates the accumulators of the statistics: the mean and the sum of
+ *        the squared deviations from the mean of the cell-centred velocity
+ *        components and of the pressure.
+ *
+ * When the simulation is restarted after `statisticsStart`, the accumulators
+ * are read from the save point (the sum of the squared deviations is
+ * recovered from the RMS fluctuation).
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::createStatistics()
+{
+	PetscErrorCode ierr;
+	const char     *names[4] = {"u", "v", "w", "p"};
+
+	if(simParams->statisticsStart < 0)
+		return 0;
+
+	statisticsMean.assign(dim+1, PETSC_NULL);
+	statisticsM2.assign(dim+1, PETSC_NULL);
+	for(PetscInt v=0; v<=dim; v++)
+	{
+		ierr = DMCreateGlobalVector(pda, &statisticsMean[v]); CHKERRQ(ierr);
+		ierr = DMCreateGlobalVector(pda, &statisticsM2[v]); CHKERRQ(ierr);
+	}
+	numSamples = 0;
+	if(simParams->restart && simParams->startStep > simParams->statisticsStart)
+	{
+		numSamples = simParams->startStep - simParams->statisticsStart;
+		for(PetscInt v=0; v<=dim; v++)
+		{
+			std::string name = names[(v == dim)? 3 : v];
+			ierr = readField(statisticsMean[v], name + "Mean"); CHKERRQ(ierr);
+			ierr = readField(statisticsM2[v], name + "RMS"); CHKERRQ(ierr);
+			ierr = VecPointwiseMult(statisticsM2[v], statisticsM2[v], statisticsM2[v]); CHKERRQ(ierr);
+			ierr = VecScale(statisticsM2[v], numSamples); CHKERRQ(ierr);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Adds the flow variables of the time step to the statistics.
+ *
+ * Welford's update: with the new value \f$ x \f$ and \f$ \delta = x -
+ * \bar{x}_{n-1} \f$, \f$ \bar{x}_n = \bar{x}_{n-1} + \delta/n \f$ and
+ * \f$ M_{2,n} = M_{2,n-1} + \delta (x - \bar{x}_n) \f$. Called right after
+ * the projection step, while the new fluxes are still in cache.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::updateStatistics()
+{
+	PetscErrorCode ierr;
+	PetscReal      *mean, *m2, delta;
+
+	if(!statisticsStep())
+		return 0;
+
+	ierr = computeCellCentredFields(statisticsSamples); CHKERRQ(ierr);
+	numSamples++;
+	for(PetscInt v=0; v<=dim; v++)
+	{
+		const std::vector<PetscReal> &x = statisticsSamples[v];
+		ierr = VecGetArray(statisticsMean[v], &mean); CHKERRQ(ierr);
+		ierr = VecGetArray(statisticsM2[v], &m2); CHKERRQ(ierr);
+		for(size_t i=0; i<x.size(); i++)
+		{
+			delta = x[i] - mean[i];
+			mean[i] += delta/numSamples;
+			m2[i] += delta*(x[i] - mean[i]);
+		}
+		ierr = VecRestoreArray(statisticsM2[v], &m2); CHKERRQ(ierr);
+		ierr = VecRestoreArray(statisticsMean[v], &mean); CHKERRQ(ierr);
+		ierr = PetscLogFlops(6.0*x.size()); CHKERRQ(ierr);
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Writes the mean (`uMean`, `vMean`, `wMean`, `pMean`) and the RMS
+ *        fluctuation (`uRMS`, ...) of the flow variables at the cell centres.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeStatistics()
+{
+	PetscErrorCode ierr;
+	Vec            rms;
+	const char     *names[4] = {"u", "v", "w", "p"};
+
+	if(simParams->statisticsStart < 0 || numSamples == 0)
+		return 0;
+
+	if(simParams->outputFormat == FOLDERS || !simParams->fieldEncodings.empty())
+	{
+		mkdir(savePointDirectory().c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+	}
+	ierr = DMGetGlobalVector(pda, &rms); CHKERRQ(ierr);
+	for(PetscInt v=0; v<=dim; v++)
+	{
+		std::string name = names[(v == dim)? 3 : v];
+		ierr = writeField(statisticsMean[v], name + "Mean"); CHKERRQ(ierr);
+		ierr = VecCopy(statisticsM2[v], rms); CHKERRQ(ierr);
+		ierr = VecScale(rms, 1.0/numSamples); CHKERRQ(ierr);
+		ierr = VecSqrtAbs(rms); CHKERRQ(ierr);
+		ierr = writeField(rms, name + "RMS"); CHKERRQ(ierr);
+	}
+	ierr = DMRestoreGlobalVector(pda, &rms); CHKERRQ(ierr);
+	ierr = PetscPrintf(PETSC_COMM_WORLD, "Statistics of %d time steps written.\n", numSamples); CHKERRQ(ierr);
+
+	return 0;
+}
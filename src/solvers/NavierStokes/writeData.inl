@@ -8,27 +8,109 @@ PetscErrorCode NavierStokesSolver<dim>::writeData()
 
 	if(rank==0)
 	{
-		PetscInt its1, its2;
-		std::string filename = caseFolder + "/iterationCount.txt";
-		if(timeStep==1)
-		{
-			iterationsFile.open(filename.c_str());
-		}
-		else
+		PetscInt          its1, its2;
+		PetscReal         res1, res2;
+		std::stringstream record;
+
+		// the files are created at the first time step, and appended to after a restart
+		if(telemetryLog == PETSC_NULL)
 		{
-			iterationsFile.open(filename.c_str(), std::ios::out | std::ios::app);
+			PetscBool append = (timeStep==1)? PETSC_FALSE : PETSC_TRUE;
+			telemetryLog = new BufferedLog(caseFolder + "/telemetry.jsonl", simParams->telemetryInterval, append);
+			if(simParams->legacyLogs)
+				iterationsLog = new BufferedLog(caseFolder + "/iterationCount.txt", simParams->telemetryInterval, append);
 		}
 		ierr = KSPGetIterationNumber(ksp1, &its1); CHKERRQ(ierr);
 		ierr = KSPGetIterationNumber(ksp2, &its2); CHKERRQ(ierr);
-		iterationsFile << timeStep << '\t' << its1 << '\t' << its2 << std::endl;
-		iterationsFile.close();
+		ierr = KSPGetResidualNorm(ksp1, &res1); CHKERRQ(ierr);
+		ierr = KSPGetResidualNorm(ksp2, &res2); CHKERRQ(ierr);
+
+		// one JSON object per time step; the wall times are those of process 0
+		record.precision(10);
+		record << "{\"step\": " << timeStep << ", \"time\": " << timeStep*simParams->dt
+		       << ", \"ksp1\": {\"iterations\": " << its1 << ", \"residual\": " << res1 << "}"
+		       << ", \"ksp2\": {\"iterations\": " << its2 << ", \"residual\": " << res2 << "}"
+		       << ", \"wallTime\": {\"solveIntermediateVelocity\": " << stageTimes[0]
+		       << ", \"solvePoissonSystem\": " << stageTimes[1]
+		       << ", \"projectionStep\": " << stageTimes[2] << "}";
+		addTelemetry(record);
+		record << "}";
+		ierr = telemetryLog->addLine(record.str()); CHKERRQ(ierr);
+
+		if(iterationsLog != PETSC_NULL)
+		{
+			std::stringstream line;
+			line << timeStep << '\t' << its1 << '\t' << its2;
+			ierr = iterationsLog->addLine(line.str()); CHKERRQ(ierr);
+		}
 	}
 
-	if(timeStep%simParams->nsave == 0)
+	ierr = PetscLogEventBegin(eventProbes, 0, 0, 0, 0); CHKERRQ(ierr);
+	ierr = sampleProbes(); CHKERRQ(ierr);
+	ierr = PetscLogEventEnd(eventProbes, 0, 0, 0, 0); CHKERRQ(ierr);
+
+	if(savePoint())
 	{
+		PetscInt64     bytes = outputBytes, fullBytes = fullPrecisionBytes;
+		PetscLogDouble time = outputTime;
+
+		ierr = PetscLogEventBegin(eventWriteFluxes, 0, 0, 0, 0); CHKERRQ(ierr);
 		ierr = writeFluxes(); CHKERRQ(ierr);
+		ierr = PetscLogEventEnd(eventWriteFluxes, 0, 0, 0, 0); CHKERRQ(ierr);
+		ierr = PetscLogEventBegin(eventWriteLambda, 0, 0, 0, 0); CHKERRQ(ierr);
 		ierr = writeLambda(); CHKERRQ(ierr);
+		ierr = PetscLogEventEnd(eventWriteLambda, 0, 0, 0, 0); CHKERRQ(ierr);
+		ierr = PetscLogEventBegin(eventWriteStatistics, 0, 0, 0, 0); CHKERRQ(ierr);
+		ierr = writeStatistics(); CHKERRQ(ierr);
+		ierr = PetscLogEventEnd(eventWriteStatistics, 0, 0, 0, 0); CHKERRQ(ierr);
+		if(asyncWriter != PETSC_NULL)
+		{
+			ierr = asyncWriter->submit(); CHKERRQ(ierr);
+		}
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "Output: %.3f MB (%.1f%% of double precision) in %.3f s.\n", (outputBytes-bytes)/1048576.0, 100.0*(outputBytes-bytes)/(fullPrecisionBytes-fullBytes), outputTime-time); CHKERRQ(ierr);
 	}
+	else if(finished())
+	{
+		// the statistics are also written at the end of the simulation
+		ierr = PetscLogEventBegin(eventWriteStatistics, 0, 0, 0, 0); CHKERRQ(ierr);
+		ierr = writeStatistics(); CHKERRQ(ierr);
+		ierr = PetscLogEventEnd(eventWriteStatistics, 0, 0, 0, 0); CHKERRQ(ierr);
+		if(asyncWriter != PETSC_NULL)
+		{
+			ierr = asyncWriter->submit(); CHKERRQ(ierr);
+		}
+	}
+	ierr = PetscLogEventBegin(eventWriteRegions, 0, 0, 0, 0); CHKERRQ(ierr);
+	ierr = writeOutputRegions(); CHKERRQ(ierr);
+	ierr = PetscLogEventEnd(eventWriteRegions, 0, 0, 0, 0); CHKERRQ(ierr);
+	ierr = PetscLogEventBegin(eventWriteVisualization, 0, 0, 0, 0); CHKERRQ(ierr);
+	ierr = writeVisualization(); CHKERRQ(ierr);
+	ierr = PetscLogEventEnd(eventWriteVisualization, 0, 0, 0, 0); CHKERRQ(ierr);
 	
 	return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * \brief Writes the lines of the logs and the samples of the probes that are
+ *        still buffered (for instance, before stopping a diverged simulation).
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::flushLogs()
+{
+	PetscErrorCode ierr;
+
+	if(telemetryLog != PETSC_NULL)
+	{
+		ierr = telemetryLog->flush(); CHKERRQ(ierr);
+	}
+	if(iterationsLog != PETSC_NULL)
+	{
+		ierr = iterationsLog->flush(); CHKERRQ(ierr);
+	}
+	for(size_t s=0; s<probeScatters.size(); s++)
+	{
+		ierr = flushProbes(s); CHKERRQ(ierr);
+	}
+
+	return 0;
+}
@@ -3,37 +3,28 @@ PetscErrorCode NavierStokesSolver<2>::writeFluxes()
 {
 	PetscErrorCode  ierr;
 	Vec             qxGlobal, qyGlobal;
-	std::string     savePointDir, fileName;
-	PetscViewer     viewer;
+	std::string     savePointDir = savePointDirectory();
 	
-	// create output folder
-	std::stringstream ss;
-	ss << caseFolder << "/" << std::setfill('0') << std::setw(7) << timeStep;
-	savePointDir = ss.str();
-	
-	mkdir(savePointDir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+	// create output folder (also holds the encoded variables)
+	if(simParams->outputFormat == FOLDERS || (!simParams->fieldEncodings.empty() && timeStep%simParams->nsave == 0))
+	{
+		mkdir(savePointDir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+	}
 	
 	ierr = DMCompositeGetAccess(qPack, q, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
 	
-	// print qx to file
-	ss.str("");
-	ss.clear();
-	ss << savePointDir << "/qx.dat";
-	fileName = ss.str();
-	ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_WRITE, &viewer); CHKERRQ(ierr);
-	ierr = VecView(qxGlobal, viewer); CHKERRQ(ierr);
-	ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
-
-	// print qy to file
-	ss.str("");
-	ss.clear();
-	ss << savePointDir << "/qy.dat";
-	fileName = ss.str();
-	ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_WRITE, &viewer); CHKERRQ(ierr);
-	ierr = VecView(qyGlobal, viewer); CHKERRQ(ierr);
-	ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+	// print qx and qy to file
+	ierr = writeField(qxGlobal, "qx"); CHKERRQ(ierr);
+	ierr = writeField(qyGlobal, "qy"); CHKERRQ(ierr);
 
-	ierr = PetscPrintf(PETSC_COMM_WORLD, "Data written to folder %s.\n", savePointDir.c_str()); CHKERRQ(ierr);
+	if(simParams->outputFormat == FOLDERS)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "Data written to folder %s.\n", savePointDir.c_str()); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "Data written to file %s/%s.\n", caseFolder.c_str(), containerName.c_str()); CHKERRQ(ierr);
+	}
 	
 	ierr = DMCompositeRestoreAccess(qPack, q, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
 
@@ -45,46 +36,29 @@ PetscErrorCode NavierStokesSolver<3>::writeFluxes()
 {
 	PetscErrorCode  ierr;
 	Vec             qxGlobal, qyGlobal, qzGlobal;
-	std::string     savePointDir, fileName;
-	PetscViewer     viewer;
+	std::string     savePointDir = savePointDirectory();
 
-	// create output folder
-	std::stringstream ss;
-	ss << caseFolder << "/" << std::setfill('0') << std::setw(7) << timeStep;
-	savePointDir = ss.str();
-	
-	mkdir(savePointDir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+	// create output folder (also holds the encoded variables)
+	if(simParams->outputFormat == FOLDERS || (!simParams->fieldEncodings.empty() && timeStep%simParams->nsave == 0))
+	{
+		mkdir(savePointDir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+	}
 	
 	ierr = DMCompositeGetAccess(qPack, q, &qxGlobal, &qyGlobal, &qzGlobal); CHKERRQ(ierr);
 	
-	// print qx to file
-	ss.str("");
-	ss.clear();
-	ss << savePointDir << "/qx.dat";
-	fileName = ss.str();
-	ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_WRITE, &viewer); CHKERRQ(ierr);
-	ierr = VecView(qxGlobal, viewer); CHKERRQ(ierr);
-	ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
-
-	// print qy to file
-	ss.str("");
-	ss.clear();
-	ss << savePointDir << "/qy.dat";
-	fileName = ss.str();
-	ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_WRITE, &viewer); CHKERRQ(ierr);
-	ierr = VecView(qyGlobal, viewer); CHKERRQ(ierr);
-	ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
-
-	// print qz to file
-	ss.str("");
-	ss.clear();
-	ss << savePointDir << "/qz.dat";
-	fileName = ss.str();
-	ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName.c_str(), FILE_MODE_WRITE, &viewer); CHKERRQ(ierr);
-	ierr = VecView(qzGlobal, viewer); CHKERRQ(ierr);
-	ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+	// print qx, qy and qz to file
+	ierr = writeField(qxGlobal, "qx"); CHKERRQ(ierr);
+	ierr = writeField(qyGlobal, "qy"); CHKERRQ(ierr);
+	ierr = writeField(qzGlobal, "qz"); CHKERRQ(ierr);
 
-	ierr = PetscPrintf(PETSC_COMM_WORLD, "Data written to folder %s.\n", savePointDir.c_str()); CHKERRQ(ierr);
+	if(simParams->outputFormat == FOLDERS)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "Data written to folder %s.\n", savePointDir.c_str()); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "Data written to file %s/%s.\n", caseFolder.c_str(), containerName.c_str()); CHKERRQ(ierr);
+	}
 	
 	ierr = DMCompositeRestoreAccess(qPack, q, &qxGlobal, &qyGlobal, &qzGlobal); CHKERRQ(ierr);
 
@@ -0,0 +1,410 @@
+/***************************************************************************//**
+ * \file writeVisualization.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c NavierStokesSolver that write the
+ *        cell-centred velocity and pressure in a format read by visualization
+ *        tools (XDMF or VTK).
+ */
+
+
+#if defined(PETSC_WORDS_BIGENDIAN)
+#define VISUALIZATION_BYTE_ORDER "Big"
+#else
+#define VISUALIZATION_BYTE_ORDER "Little"
+#endif
+
+/**
+ * \brief Computes the velocity at the centres of the cells owned by the
+ *        process, and copies the pressure there.
+ *
+ * The velocity in a cell is the average of the fluxes through its two faces
+ * normal to the direction, divided by the area of the faces. On the domain
+ * boundaries, the fluxes are those stored in the ghost cells of the local
+ * vectors of the fluxes. The values are ordered with i fastest.
+ *
+ * If `diagonal` is given, it receives the derivatives of each velocity
+ * component along its own direction (du/dx, dv/dy, dw/dz), computed from the
+ * fluxes through the two faces of the cell.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::computeCellCentredFields(std::vector<PetscReal> *fields, std::vector<PetscReal> *diagonal)
+{
+	return 0;
+}
+
+template <>
+PetscErrorCode NavierStokesSolver<2>::computeCellCentredFields(std::vector<PetscReal> *fields, std::vector<PetscReal> *diagonal)
+{
+	PetscErrorCode ierr;
+	PetscInt       mstart, nstart, m, n, i, j, row, wanted = 0;
+	Vec            qxGlobal, qyGlobal, qxGhosted, qyGhosted, phi;
+	PetscReal      **qx, **qy, **p;
+
+	// fluxes with up-to-date ghost cells (the boundary ghosts are not touched by the scatter)
+	ierr = DMGetLocalVector(uda, &qxGhosted); CHKERRQ(ierr);
+	ierr = DMGetLocalVector(vda, &qyGhosted); CHKERRQ(ierr);
+	ierr = VecCopy(qxLocal, qxGhosted); CHKERRQ(ierr);
+	ierr = VecCopy(qyLocal, qyGhosted); CHKERRQ(ierr);
+	ierr = DMCompositeGetAccess(qPack, q, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalBegin(uda, qxGlobal, INSERT_VALUES, qxGhosted); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalEnd(uda, qxGlobal, INSERT_VALUES, qxGhosted); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalBegin(vda, qyGlobal, INSERT_VALUES, qyGhosted); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalEnd(vda, qyGlobal, INSERT_VALUES, qyGhosted); CHKERRQ(ierr);
+	ierr = DMCompositeRestoreAccess(qPack, q, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
+	ierr = DMCompositeGetAccessArray(lambdaPack, lambda, 1, &wanted, &phi); CHKERRQ(ierr);
+
+	ierr = DMDAVecGetArray(uda, qxGhosted, &qx); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(vda, qyGhosted, &qy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(pda, phi, &p); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(pda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+	for(PetscInt v=0; v<3; v++)
+		fields[v].resize(m*n);
+	for(PetscInt v=0; diagonal!=PETSC_NULL && v<2; v++)
+		diagonal[v].resize(m*n);
+	for(j=nstart; j<nstart+n; j++)
+	{
+		for(i=mstart; i<mstart+m; i++)
+		{
+			row = (i-mstart) + m*(j-nstart);
+			fields[0][row] = 0.5*(qx[j][i-1] + qx[j][i])/mesh->dy[j];
+			fields[1][row] = 0.5*(qy[j-1][i] + qy[j][i])/mesh->dx[i];
+			fields[2][row] = p[j][i];
+			if(diagonal != PETSC_NULL)
+			{
+				diagonal[0][row] = (qx[j][i] - qx[j][i-1])/(mesh->dx[i]*mesh->dy[j]);
+				diagonal[1][row] = (qy[j][i] - qy[j-1][i])/(mesh->dx[i]*mesh->dy[j]);
+			}
+		}
+	}
+	ierr = DMDAVecRestoreArray(pda, phi, &p); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(vda, qyGhosted, &qy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(uda, qxGhosted, &qx); CHKERRQ(ierr);
+
+	ierr = DMCompositeRestoreAccessArray(lambdaPack, lambda, 1, &wanted, &phi); CHKERRQ(ierr);
+	ierr = DMRestoreLocalVector(vda, &qyGhosted); CHKERRQ(ierr);
+	ierr = DMRestoreLocalVector(uda, &qxGhosted); CHKERRQ(ierr);
+
+	return 0;
+}
+
+template <>
+PetscErrorCode NavierStokesSolver<3>::computeCellCentredFields(std::vector<PetscReal> *fields, std::vector<PetscReal> *diagonal)
+{
+	PetscErrorCode ierr;
+	PetscInt       mstart, nstart, pstart, m, n, p, i, j, k, row, wanted = 0;
+	Vec            qxGlobal, qyGlobal, qzGlobal, qxGhosted, qyGhosted, qzGhosted, phi;
+	PetscReal      ***qx, ***qy, ***qz, ***pressure;
+
+	// fluxes with up-to-date ghost cells (the boundary ghosts are not touched by the scatter)
+	ierr = DMGetLocalVector(uda, &qxGhosted); CHKERRQ(ierr);
+	ierr = DMGetLocalVector(vda, &qyGhosted); CHKERRQ(ierr);
+	ierr = DMGetLocalVector(wda, &qzGhosted); CHKERRQ(ierr);
+	ierr = VecCopy(qxLocal, qxGhosted); CHKERRQ(ierr);
+	ierr = VecCopy(qyLocal, qyGhosted); CHKERRQ(ierr);
+	ierr = VecCopy(qzLocal, qzGhosted); CHKERRQ(ierr);
+	ierr = DMCompositeGetAccess(qPack, q, &qxGlobal, &qyGlobal, &qzGlobal); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalBegin(uda, qxGlobal, INSERT_VALUES, qxGhosted); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalEnd(uda, qxGlobal, INSERT_VALUES, qxGhosted); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalBegin(vda, qyGlobal, INSERT_VALUES, qyGhosted); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalEnd(vda, qyGlobal, INSERT_VALUES, qyGhosted); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalBegin(wda, qzGlobal, INSERT_VALUES, qzGhosted); CHKERRQ(ierr);
+	ierr = DMGlobalToLocalEnd(wda, qzGlobal, INSERT_VALUES, qzGhosted); CHKERRQ(ierr);
+	ierr = DMCompositeRestoreAccess(qPack, q, &qxGlobal, &qyGlobal, &qzGlobal); CHKERRQ(ierr);
+	ierr = DMCompositeGetAccessArray(lambdaPack, lambda, 1, &wanted, &phi); CHKERRQ(ierr);
+
+	ierr = DMDAVecGetArray(uda, qxGhosted, &qx); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(vda, qyGhosted, &qy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(wda, qzGhosted, &qz); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(pda, phi, &pressure); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(pda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+	for(PetscInt v=0; v<4; v++)
+		fields[v].resize(m*n*p);
+	for(PetscInt v=0; diagonal!=PETSC_NULL && v<3; v++)
+		diagonal[v].resize(m*n*p);
+	for(k=pstart; k<pstart+p; k++)
+	{
+		for(j=nstart; j<nstart+n; j++)
+		{
+			for(i=mstart; i<mstart+m; i++)
+			{
+				row = (i-mstart) + m*((j-nstart) + n*(k-pstart));
+				fields[0][row] = 0.5*(qx[k][j][i-1] + qx[k][j][i])/(mesh->dy[j]*mesh->dz[k]);
+				fields[1][row] = 0.5*(qy[k][j-1][i] + qy[k][j][i])/(mesh->dx[i]*mesh->dz[k]);
+				fields[2][row] = 0.5*(qz[k-1][j][i] + qz[k][j][i])/(mesh->dx[i]*mesh->dy[j]);
+				fields[3][row] = pressure[k][j][i];
+				if(diagonal != PETSC_NULL)
+				{
+					PetscReal volume = mesh->dx[i]*mesh->dy[j]*mesh->dz[k];
+					diagonal[0][row] = (qx[k][j][i] - qx[k][j][i-1])/volume;
+					diagonal[1][row] = (qy[k][j][i] - qy[k][j-1][i])/volume;
+					diagonal[2][row] = (qz[k][j][i] - qz[k-1][j][i])/volume;
+				}
+			}
+		}
+	}
+	ierr = DMDAVecRestoreArray(pda, phi, &pressure); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(wda, qzGhosted, &qz); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(vda, qyGhosted, &qy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(uda, qxGhosted, &qx); CHKERRQ(ierr);
+
+	ierr = DMCompositeRestoreAccessArray(lambdaPack, lambda, 1, &wanted, &phi); CHKERRQ(ierr);
+	ierr = DMRestoreLocalVector(wda, &qzGhosted); CHKERRQ(ierr);
+	ierr = DMRestoreLocalVector(vda, &qyGhosted); CHKERRQ(ierr);
+	ierr = DMRestoreLocalVector(uda, &qxGhosted); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Writes the cell-centred fields as raw binary arrays, one file per
+ *        variable, described by an XDMF file `<name>.xmf`.
+ *
+ * Each process writes its block of cells into the shared file of each
+ * variable (collective MPI-IO, natural ordering with i fastest). The
+ * coordinates of the nodes are written in the XDMF file.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeXDMF(std::string name, const PetscInt *start, const PetscInt *width, std::vector<PetscReal> *fields)
+{
+	PetscErrorCode ierr;
+	PetscInt       rank;
+	int            sizes[3], subSizes[3], starts[3];
+	MPI_Datatype   fileType;
+	MPI_File       file;
+	const char     *names[4] = {"u", "v", "w", "p"};
+	const std::vector<PetscReal> *nodes[3] = {&mesh->x, &mesh->y, &mesh->z};
+	PetscInt       numCells[3] = {mesh->nx, mesh->ny, mesh->nz};
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	// block of the process in the global array (slowest direction first)
+	for(PetscInt d=0; d<dim; d++)
+	{
+		sizes[dim-1-d] = numCells[d];
+		subSizes[dim-1-d] = width[d];
+		starts[dim-1-d] = start[d];
+	}
+	ierr = MPI_Type_create_subarray(dim, sizes, subSizes, starts, MPI_ORDER_C, MPIU_REAL, &fileType); CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&fileType); CHKERRQ(ierr);
+	for(PetscInt v=0; v<=dim; v++)
+	{
+		std::string fileName = name + "_" + names[(v == dim)? 3 : v] + ".raw";
+		ierr = MPI_File_open(PETSC_COMM_WORLD, const_cast<char *>(fileName.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file); CHKERRQ(ierr);
+		ierr = MPI_File_set_size(file, 0); CHKERRQ(ierr);
+		ierr = MPI_File_set_view(file, 0, MPIU_REAL, fileType, const_cast<char *>("native"), MPI_INFO_NULL); CHKERRQ(ierr);
+		ierr = MPI_File_write_all(file, (fields[v].empty())? NULL : &fields[v][0], fields[v].size(), MPIU_REAL, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+		ierr = MPI_File_close(&file); CHKERRQ(ierr);
+	}
+	ierr = MPI_Type_free(&fileType); CHKERRQ(ierr);
+
+	if(rank == 0)
+	{
+		std::string       baseName = name.substr(name.rfind('/')+1);
+		std::stringstream cellDims, nodeDims;
+		std::ofstream     xdmf((name + ".xmf").c_str());
+
+		for(PetscInt d=dim-1; d>=0; d--)
+		{
+			cellDims << numCells[d] << ((d > 0)? " " : "");
+			nodeDims << numCells[d]+1 << ((d > 0)? " " : "");
+		}
+		xdmf.precision(16);
+		xdmf << "<?xml version=\"1.0\" ?>\n";
+		xdmf << "<Xdmf Version=\"2.0\">\n";
+		xdmf << "  <Domain>\n";
+		xdmf << "    <Grid Name=\"flow\" GridType=\"Uniform\">\n";
+		xdmf << "      <Time Value=\"" << timeStep*simParams->dt << "\"/>\n";
+		xdmf << "      <Topology TopologyType=\"" << dim << "DRectMesh\" Dimensions=\"" << nodeDims.str() << "\"/>\n";
+		xdmf << "      <Geometry GeometryType=\"" << ((dim == 3)? "VXVYVZ" : "VXVY") << "\">\n";
+		for(PetscInt d=0; d<dim; d++)
+		{
+			xdmf << "        <DataItem Dimensions=\"" << numCells[d]+1 << "\" NumberType=\"Float\" Precision=\"8\" Format=\"XML\">\n";
+			xdmf << "          ";
+			for(PetscInt i=0; i<=numCells[d]; i++)
+				xdmf << (*nodes[d])[i] << ((i < numCells[d])? " " : "\n");
+			xdmf << "        </DataItem>\n";
+		}
+		xdmf << "      </Geometry>\n";
+		for(PetscInt v=0; v<=dim; v++)
+		{
+			std::string variable = names[(v == dim)? 3 : v];
+			xdmf << "      <Attribute Name=\"" << variable << "\" AttributeType=\"Scalar\" Center=\"Cell\">\n";
+			xdmf << "        <DataItem Dimensions=\"" << cellDims.str() << "\" NumberType=\"Float\" Precision=\"" << sizeof(PetscReal) << "\" Endian=\"" << VISUALIZATION_BYTE_ORDER << "\" Format=\"Binary\">\n";
+			xdmf << "          " << baseName << "_" << variable << ".raw\n";
+			xdmf << "        </DataItem>\n";
+			xdmf << "      </Attribute>\n";
+		}
+		xdmf << "    </Grid>\n";
+		xdmf << "  </Domain>\n";
+		xdmf << "</Xdmf>\n";
+		xdmf.close();
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Writes the cell-centred fields as a VTK rectilinear grid: each
+ *        process writes its block of cells in the piece `<name>_<rank>.vtr`,
+ *        and process 0 writes the file `<name>.pvtr` that gathers the pieces.
+ *
+ * The velocity is a vector with three components (the third one is zero in
+ * 2D). The arrays are appended to the pieces in raw binary form.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeRectilinearPieces(std::string name, const PetscInt *start, const PetscInt *width, std::vector<PetscReal> *fields)
+{
+	PetscErrorCode ierr;
+	PetscInt       rank, numProcs, extent[6] = {0, 0, 0, 0, 0, 0}, numCells = fields[dim].size();
+	PetscInt       wholeExtent[6] = {0, mesh->nx, 0, mesh->ny, 0, (dim == 3)? mesh->nz : 0};
+	const std::vector<PetscReal> *nodes[3] = {&mesh->x, &mesh->y, &mesh->z};
+	std::vector<PetscInt>  extents;
+	std::vector<PetscReal> velocity(3*numCells, 0.0), coords[3];
+	const char     *byteOrder = VISUALIZATION_BYTE_ORDER "Endian";
+	const char     *coordNames[3] = {"x", "y", "z"};
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
+
+	// extent of the piece (indices of the nodes) and coordinates of its nodes
+	for(PetscInt d=0; d<dim; d++)
+	{
+		extent[2*d] = start[d];
+		extent[2*d+1] = start[d] + width[d];
+		coords[d].assign(nodes[d]->begin()+start[d], nodes[d]->begin()+start[d]+width[d]+1);
+	}
+	if(dim == 2)
+		coords[2].assign(1, 0.0);
+	for(PetscInt c=0; c<numCells; c++)
+	{
+		for(PetscInt d=0; d<dim; d++)
+			velocity[3*c+d] = fields[d][c];
+	}
+
+	// piece of the process
+	{
+		std::stringstream ss;
+		ss << name << "_" << rank << ".vtr";
+		std::ofstream vtr(ss.str().c_str(), std::ios::binary);
+		if(!vtr.good())
+		{
+			SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Unable to open the file %s", ss.str().c_str());
+		}
+
+		// arrays appended to the file, each preceded by its size in bytes
+		const std::vector<PetscReal> *arrays[5] = {&velocity, &fields[dim], &coords[0], &coords[1], &coords[2]};
+		uint64_t offsets[5], offset = 0;
+		for(PetscInt a=0; a<5; a++)
+		{
+			offsets[a] = offset;
+			offset += sizeof(uint64_t) + arrays[a]->size()*sizeof(PetscReal);
+		}
+
+		vtr << "<?xml version=\"1.0\"?>\n";
+		vtr << "<VTKFile type=\"RectilinearGrid\" version=\"1.0\" byte_order=\"" << byteOrder << "\" header_type=\"UInt64\">\n";
+		vtr << "  <RectilinearGrid WholeExtent=\"";
+		for(PetscInt e=0; e<6; e++)
+			vtr << wholeExtent[e] << ((e < 5)? " " : "\">\n");
+		vtr << "    <Piece Extent=\"";
+		for(PetscInt e=0; e<6; e++)
+			vtr << extent[e] << ((e < 5)? " " : "\">\n");
+		vtr << "      <CellData Scalars=\"p\" Vectors=\"velocity\">\n";
+		vtr << "        <DataArray type=\"Float64\" Name=\"velocity\" NumberOfComponents=\"3\" format=\"appended\" offset=\"" << offsets[0] << "\"/>\n";
+		vtr << "        <DataArray type=\"Float64\" Name=\"p\" format=\"appended\" offset=\"" << offsets[1] << "\"/>\n";
+		vtr << "      </CellData>\n";
+		vtr << "      <Coordinates>\n";
+		for(PetscInt d=0; d<3; d++)
+			vtr << "        <DataArray type=\"Float64\" Name=\"" << coordNames[d] << "\" format=\"appended\" offset=\"" << offsets[2+d] << "\"/>\n";
+		vtr << "      </Coordinates>\n";
+		vtr << "    </Piece>\n";
+		vtr << "  </RectilinearGrid>\n";
+		vtr << "  <AppendedData encoding=\"raw\">\n";
+		vtr << "_";
+		for(PetscInt a=0; a<5; a++)
+		{
+			uint64_t numBytes = arrays[a]->size()*sizeof(PetscReal);
+			vtr.write(reinterpret_cast<const char *>(&numBytes), sizeof(numBytes));
+			if(numBytes > 0)
+				vtr.write(reinterpret_cast<const char *>(&(*arrays[a])[0]), numBytes);
+		}
+		vtr << "\n  </AppendedData>\n";
+		vtr << "</VTKFile>\n";
+		vtr.close();
+	}
+
+	// file that gathers the pieces
+	if(rank == 0)
+		extents.resize(6*numProcs);
+	ierr = MPI_Gather(extent, 6, MPIU_INT, (rank == 0)? &extents[0] : NULL, 6, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	if(rank == 0)
+	{
+		std::string   baseName = name.substr(name.rfind('/')+1);
+		std::ofstream pvtr((name + ".pvtr").c_str());
+
+		pvtr << "<?xml version=\"1.0\"?>\n";
+		pvtr << "<VTKFile type=\"PRectilinearGrid\" version=\"1.0\" byte_order=\"" << byteOrder << "\" header_type=\"UInt64\">\n";
+		pvtr << "  <PRectilinearGrid WholeExtent=\"";
+		for(PetscInt e=0; e<6; e++)
+			pvtr << wholeExtent[e] << ((e < 5)? " " : "\" GhostLevel=\"0\">\n");
+		pvtr << "    <PCellData Scalars=\"p\" Vectors=\"velocity\">\n";
+		pvtr << "      <PDataArray type=\"Float64\" Name=\"velocity\" NumberOfComponents=\"3\"/>\n";
+		pvtr << "      <PDataArray type=\"Float64\" Name=\"p\"/>\n";
+		pvtr << "    </PCellData>\n";
+		pvtr << "    <PCoordinates>\n";
+		for(PetscInt d=0; d<3; d++)
+			pvtr << "      <PDataArray type=\"Float64\" Name=\"" << coordNames[d] << "\"/>\n";
+		pvtr << "    </PCoordinates>\n";
+		for(PetscInt r=0; r<numProcs; r++)
+		{
+			pvtr << "    <Piece Extent=\"";
+			for(PetscInt e=0; e<6; e++)
+				pvtr << extents[6*r+e] << ((e < 5)? " " : "\"");
+			pvtr << " Source=\"" << baseName << "_" << r << ".vtr\"/>\n";
+		}
+		pvtr << "  </PRectilinearGrid>\n";
+		pvtr << "</VTKFile>\n";
+		pvtr.close();
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Writes the cell-centred velocity and pressure at the save points,
+ *        in the folder `visualization` of the case, in the format given in
+ *        the simulation parameters.
+ *
+ * The files of the time step `n` are named `flow<n>` (7 digits), so that
+ * visualization tools load them as a time series.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeVisualization()
+{
+	PetscErrorCode         ierr;
+	PetscInt               start[3] = {0, 0, 0}, width[3] = {1, 1, 1};
+	std::vector<PetscReal> fields[4];
+	std::stringstream      ss;
+
+	if(simParams->visualizationFormat == NO_VISUALIZATION || timeStep % simParams->nsave != 0)
+		return 0;
+
+	std::string folder = caseFolder + "/visualization";
+	mkdir(folder.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+	ss << folder << "/flow" << std::setfill('0') << std::setw(7) << timeStep;
+
+	ierr = computeCellCentredFields(fields); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(pda, &start[0], &start[1], &start[2], &width[0], &width[1], &width[2]); CHKERRQ(ierr);
+	switch(simParams->visualizationFormat)
+	{
+		case XDMF:
+			ierr = writeXDMF(ss.str(), start, width, fields); CHKERRQ(ierr);
+			break;
+		case VTK_RECTILINEAR:
+			ierr = writeRectilinearPieces(ss.str(), start, width, fields); CHKERRQ(ierr);
+			break;
+		default:
+			break;
+	}
+
+	return 0;
+}
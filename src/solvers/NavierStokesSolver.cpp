@@ -6,15 +6,111 @@
 
 
 #include "NavierStokesSolver.h"
+#include "FieldEncoder.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <iomanip>
+#include <cstring>
 #include <sys/stat.h>
+#include <stdint.h>
 
 #include <petscdmcomposite.h>
 
+// log stages and events, shared by all the solvers
+template <PetscInt dim>
+PetscLogStage NavierStokesSolver<dim>::stageInitialize;
+template <PetscInt dim>
+PetscLogStage NavierStokesSolver<dim>::stageSolveIntermediateVelocity;
+template <PetscInt dim>
+PetscLogStage NavierStokesSolver<dim>::stageSolvePoissonSystem;
+template <PetscInt dim>
+PetscLogStage NavierStokesSolver<dim>::stageProjectionStep;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventGenerateA;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventGenerateBNQ;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventGenerateQTBNQ;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventUpdateBodies;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventExplicitTerms;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventBoundaryGhosts;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventGenerateBC1;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventGenerateRHS1;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventGenerateR2;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventGenerateRHS2;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventProjection;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventStatistics;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventProbes;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventWriteFluxes;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventWriteLambda;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventWriteStatistics;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventWriteRegions;
+template <PetscInt dim>
+PetscLogEvent NavierStokesSolver<dim>::eventWriteVisualization;
+
+/**
+ * \brief Registers the log stages and the log events of the solvers.
+ *
+ * Only the first call (for a given number of dimensions) registers them:
+ * the solvers created afterwards log into the same stages and events
+ * instead of registering duplicates.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::registerLogEvents()
+{
+  PetscErrorCode   ierr;
+  static PetscBool registered = PETSC_FALSE;
+
+  if(registered)
+    return 0;
+  registered = PETSC_TRUE;
+
+  // PetscLogStages
+  ierr = PetscLogStageRegister("initialize", &stageInitialize); CHKERRQ(ierr);
+  ierr = PetscLogStageRegister("solveIntVel", &stageSolveIntermediateVelocity); CHKERRQ(ierr);
+  ierr = PetscLogStageRegister("solvePoissSys", &stageSolvePoissonSystem); CHKERRQ(ierr);
+  ierr = PetscLogStageRegister("projectionStep", &stageProjectionStep); CHKERRQ(ierr);
+
+  // PetscLogEvents
+  ierr = PetscLogEventRegister("generateA", 0, &eventGenerateA); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("generateBNQ", 0, &eventGenerateBNQ); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("generateQTBNQ", 0, &eventGenerateQTBNQ); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("updateBodies", 0, &eventUpdateBodies); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("explicitTerms", 0, &eventExplicitTerms); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("boundaryGhosts", 0, &eventBoundaryGhosts); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("generateBC1", 0, &eventGenerateBC1); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("generateRHS1", 0, &eventGenerateRHS1); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("generateR2", 0, &eventGenerateR2); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("generateRHS2", 0, &eventGenerateRHS2); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("projection", 0, &eventProjection); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("statistics", 0, &eventStatistics); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("probes", 0, &eventProbes); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("writeFluxes", 0, &eventWriteFluxes); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("writeLambda", 0, &eventWriteLambda); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("writeStatistics", 0, &eventWriteStatistics); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("writeRegions", 0, &eventWriteRegions); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("writeVisualiz", 0, &eventWriteVisualization); CHKERRQ(ierr);
+
+  return 0;
+}
+
 /**
  * \brief Initializes the solver.
  */
@@ -50,22 +146,76 @@ PetscErrorCode NavierStokesSolver<dim>::initializeCommon()
   ierr = createLocalToGlobalMappingsLambda(); CHKERRQ(ierr);
 
   ierr = generateDiagonalMatrices(); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateA, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateA(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateA, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateBNQ(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateQTBNQ(); CHKERRQ(ierr);
   ierr = createKSPs(); CHKERRQ(ierr);
   ierr = setNullSpace(); CHKERRQ(ierr);
 
+  ierr = createOutputRegions(); CHKERRQ(ierr);
+  ierr = createStatistics(); CHKERRQ(ierr);
+  ierr = createProbes(); CHKERRQ(ierr);
+  if(simParams->asyncSnapshots > 0)
+  {
+    asyncWriter = new AsyncWriter(simParams->asyncSnapshots);
+  }
+
   return 0;
 }
 
 /**
- * \brief Deallocate memory to avoid memory leaks.
+ * \brief Deallocates memory to avoid memory leaks, and writes the volume of
+ *        the output, the peak memory and the performance summary.
  */
 template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::finalize()
 {
   PetscErrorCode ierr;
+
+  ierr = destroyObjects(); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "\nTotal output: %.3f MB in %.3f s.\n", outputBytes/1048576.0, outputTime); CHKERRQ(ierr);
+
+  // peak resident memory (zero if it is not tracked by the main program)
+  PetscLogDouble memory, maxMemory, totalMemory;
+  ierr = PetscMemoryGetMaximumUsage(&memory); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&memory, &maxMemory, 1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&memory, &totalMemory, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "Peak memory: %.3f MB (largest process), %.3f MB (all processes).\n", maxMemory/1048576.0, totalMemory/1048576.0); CHKERRQ(ierr);
+
+  // Print performance summary to file
+  PetscViewer viewer;
+  std::string performanceSummaryFileName = caseFolder + "/performanceSummary.txt";
+  ierr = PetscViewerASCIIOpen(PETSC_COMM_WORLD, performanceSummaryFileName.c_str(), &viewer); CHKERRQ(ierr);
+  ierr = PetscLogView(viewer); CHKERRQ(ierr);
+  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+
+  return 0;
+}
+
+/**
+ * \brief Waits for the outputs in progress, writes the buffered logs and
+ *        destroys the PETSc objects of the solver.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::destroyObjects()
+{
+  PetscErrorCode ierr;
+
+  // wait for the save points being written in the background
+  if(asyncWriter!=PETSC_NULL)
+  {
+    ierr = asyncWriter->drain(); CHKERRQ(ierr);
+    delete asyncWriter;
+    asyncWriter = PETSC_NULL;
+  }
+  
+  // logs (writes the buffered lines)
+  if(telemetryLog!=PETSC_NULL) {delete telemetryLog; telemetryLog = PETSC_NULL;}
+  if(iterationsLog!=PETSC_NULL){delete iterationsLog; iterationsLog = PETSC_NULL;}
   
   // DMs
   if(pda!=PETSC_NULL) {ierr = DMDestroy(&pda); CHKERRQ(ierr);}
@@ -111,12 +261,36 @@ PetscErrorCode NavierStokesSolver<dim>::finalize()
   if(ksp1!=PETSC_NULL){ierr = KSPDestroy(&ksp1); CHKERRQ(ierr);}
   if(ksp2!=PETSC_NULL){ierr = KSPDestroy(&ksp2); CHKERRQ(ierr);}
 
-  // Print performance summary to file
-  PetscViewer viewer;
-  std::string performanceSummaryFileName = caseFolder + "/performanceSummary.txt";
-  ierr = PetscViewerASCIIOpen(PETSC_COMM_WORLD, performanceSummaryFileName.c_str(), &viewer); CHKERRQ(ierr);
-  ierr = PetscLogView(viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  // output regions
+  for(size_t r=0; r<regionVecs.size(); r++)
+  {
+    for(size_t v=0; v<regionVecs[r].size(); v++)
+    {
+      if(regionVecs[r][v]!=PETSC_NULL)    {ierr = VecDestroy(&regionVecs[r][v]); CHKERRQ(ierr);}
+      if(regionScatters[r][v]!=PETSC_NULL){ierr = VecScatterDestroy(&regionScatters[r][v]); CHKERRQ(ierr);}
+    }
+  }
+
+  // probes (writes the buffered samples)
+  for(size_t s=0; s<probeScatters.size(); s++)
+  {
+    ierr = flushProbes(s); CHKERRQ(ierr);
+    for(size_t v=0; v<probeScatters[s].size(); v++)
+    {
+      if(probeStencilValues[s][v]!=PETSC_NULL){ierr = VecDestroy(&probeStencilValues[s][v]); CHKERRQ(ierr);}
+      if(probeScatters[s][v]!=PETSC_NULL)     {ierr = VecScatterDestroy(&probeScatters[s][v]); CHKERRQ(ierr);}
+    }
+  }
+
+  // statistics
+  for(size_t v=0; v<statisticsMean.size(); v++)
+  {
+    if(statisticsMean[v]!=PETSC_NULL){ierr = VecDestroy(&statisticsMean[v]); CHKERRQ(ierr);}
+    if(statisticsM2[v]!=PETSC_NULL)  {ierr = VecDestroy(&statisticsM2[v]); CHKERRQ(ierr);}
+  }
+
+  // output container
+  ierr = closeContainer(); CHKERRQ(ierr);
 
   return 0;
 }
@@ -154,29 +328,61 @@ template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::stepTime()
 {
   PetscErrorCode ierr;
+  PetscLogDouble start, end;
+
+  // move the immersed boundaries (if any)
+  ierr = PetscLogEventBegin(eventUpdateBodies, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = updateImmersedBoundary(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventUpdateBodies, 0, 0, 0, 0); CHKERRQ(ierr);
 
   // solve for the intermediate velocity
+  ierr = PetscTime(&start); CHKERRQ(ierr);
   ierr = PetscLogStagePush(stageSolveIntermediateVelocity); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventExplicitTerms, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = calculateExplicitTerms(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventExplicitTerms, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventBoundaryGhosts, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = updateBoundaryGhosts(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventBoundaryGhosts, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateBC1, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateBC1(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateBC1, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateRHS1, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateRHS1(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateRHS1, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = solveIntermediateVelocity(); CHKERRQ(ierr);
   ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = PetscTime(&end); CHKERRQ(ierr);
+  stageTimes[0] = end - start;
 
   // solve the Poisson system for the pressure
   // and body forces in the case of TairaColoniusSolver
+  start = end;
   ierr = PetscLogStagePush(stageSolvePoissonSystem); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateR2, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateR2(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateR2, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateRHS2, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateRHS2(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateRHS2, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = solvePoissonSystem(); CHKERRQ(ierr);
   ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = PetscTime(&end); CHKERRQ(ierr);
+  stageTimes[1] = end - start;
 
   // project the pressure field to satisfy continuity
   // and the body forces to satisfy the no-slip condition
+  start = end;
   ierr = PetscLogStagePush(stageProjectionStep); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventProjection, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = projectionStep(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventProjection, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventStatistics, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = updateStatistics(); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventStatistics, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = PetscTime(&end); CHKERRQ(ierr);
+  stageTimes[2] = end - start;
   timeStep++;
 
   return 0;
@@ -196,8 +402,8 @@ PetscErrorCode NavierStokesSolver<dim>::solveIntermediateVelocity()
   ierr = KSPGetConvergedReason(ksp1, &reason); CHKERRQ(ierr);
   if(reason < 0)
   {
-    ierr = PetscPrintf(PETSC_COMM_WORLD,"Velocity solve diverged due to reason: %d\n", reason); CHKERRQ(ierr);
-    exit(0);
+    ierr = flushLogs(); CHKERRQ(ierr);
+    SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_NOT_CONVERGED, "Velocity solve diverged due to reason: %d", reason);
   }
 
   return 0;
@@ -217,8 +423,8 @@ PetscErrorCode NavierStokesSolver<dim>::solvePoissonSystem()
   ierr = KSPGetConvergedReason(ksp2, &reason); CHKERRQ(ierr);
   if(reason < 0)
   {
-    ierr = PetscPrintf(PETSC_COMM_WORLD,"Poisson solve diverged due to reason: %d\n", reason); CHKERRQ(ierr);
-    exit(0);
+    ierr = flushLogs(); CHKERRQ(ierr);
+    SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_NOT_CONVERGED, "Poisson solve diverged due to reason: %d", reason);
   }
 
   return 0;
@@ -242,11 +448,32 @@ PetscErrorCode NavierStokesSolver<dim>::projectionStep()
 
 /**
  * \brief Do the data need to be saved at the current time-step?
+ *
+ * The flow variables are saved every `nsave` time steps, and at the restart
+ * points.
  */
 template <PetscInt dim>
 PetscBool NavierStokesSolver<dim>::savePoint()
 {
-  return (timeStep % simParams->nsave == 0)? PETSC_TRUE : PETSC_FALSE;
+  return (timeStep % simParams->nsave == 0 || restartPoint())? PETSC_TRUE : PETSC_FALSE;
+}
+
+/**
+ * \brief Are the exact values of all the flow variables (restart data) saved
+ *        at the current time-step?
+ *
+ * Only matters when a variable is encoded (the other ones are always saved
+ * exactly): the restart data are then written every `nrestart` time steps,
+ * or only at the last time step if `nrestart` is 0 (default).
+ */
+template <PetscInt dim>
+PetscBool NavierStokesSolver<dim>::restartPoint()
+{
+  if(!simParams->encodedOutput())
+    return PETSC_FALSE;
+  if(simParams->nrestart > 0)
+    return (timeStep % simParams->nrestart == 0)? PETSC_TRUE : PETSC_FALSE;
+  return finished();
 }
 
 /**
@@ -265,14 +492,12 @@ template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::generateQTBNQ()
 {
   PetscErrorCode ierr;
-  PetscLogEvent  GENERATE_QTBNQ;
   
-  ierr = PetscLogEventRegister("generateQTBNQ", 0, &GENERATE_QTBNQ); CHKERRQ(ierr);
-  ierr = PetscLogEventBegin(GENERATE_QTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateQTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
 
   ierr = MatMatMult(QT, BNQ, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &QTBNQ); CHKERRQ(ierr);
   
-  ierr = PetscLogEventEnd(GENERATE_QTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateQTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
 
   return 0;
 }
@@ -315,6 +540,7 @@ void NavierStokesSolver<dim>::countNumNonZeros(PetscInt *cols, size_t numCols, P
 #include "NavierStokes/initializeMeshSpacings.inl"
 #include "NavierStokes/initializeFluxes.inl"
 #include "NavierStokes/readFluxes.inl"
+#include "NavierStokes/interpolateFields.inl"
 #include "NavierStokes/initializeLambda.inl"
 #include "NavierStokes/updateBoundaryGhosts.inl"
 #include "NavierStokes/calculateExplicitTerms.inl"
@@ -325,7 +551,13 @@ void NavierStokesSolver<dim>::countNumNonZeros(PetscInt *cols, size_t numCols, P
 #include "NavierStokes/generateR2.inl"
 #include "NavierStokes/printSimulationInfo.inl"
 #include "NavierStokes/writeGrid.inl"
+#include "NavierStokes/fieldIO.inl"
 #include "NavierStokes/writeFluxes.inl"
+#include "NavierStokes/outputRegions.inl"
+#include "NavierStokes/writeVisualization.inl"
+#include "NavierStokes/derivedFields.inl"
+#include "NavierStokes/statistics.inl"
+#include "NavierStokes/probes.inl"
 #include "NavierStokes/writeLambda.inl"
 #include "NavierStokes/writeData.inl"
 
@@ -11,6 +11,8 @@
 #include "FlowDescription.h"
 #include "CartesianMesh.h"
 #include "SimulationParameters.h"
+#include "AsyncWriter.h"
+#include "BufferedLog.h"
 
 #include <fstream>
 
@@ -40,7 +42,16 @@ public:
                          dxV, dyV, dzV,
                          dxW, dyW, dzW;
 
-  std::ofstream iterationsFile;
+  // per-step telemetry (JSON lines) and iteration counts, written by blocks
+  BufferedLog *telemetryLog,
+              *iterationsLog;
+
+  // wall time of the stages of the last time step
+  PetscLogDouble stageTimes[3];
+
+  // number of cells owned by each process along each direction
+  // (left empty to let PETSc decide)
+  std::vector<PetscInt> lx, ly, lz;
   
   DM  pda,
       uda,
@@ -70,10 +81,70 @@ public:
   KSP ksp1, ksp2;
   PC  pc2;
 
-  PetscLogStage stageInitialize,
-                stageSolveIntermediateVelocity,
-                stageSolvePoissonSystem,
-                stageProjectionStep;
+  // container of the flow variables (output format CONTAINER)
+  PetscViewer   containerViewer;
+  std::string   containerName;
+  PetscInt      containerSnapshots,
+                containerStep;
+  PetscInt64    containerOffset;
+  std::ofstream containerIndex;
+
+  // background writing of the save points
+  AsyncWriter *asyncWriter;
+
+  // output regions: sub-vectors of each variable and scatters that fill them
+  std::vector< std::vector<Vec> >        regionVecs;
+  std::vector< std::vector<VecScatter> > regionScatters;
+
+  // probes: points of each set located in the cells owned by the process,
+  // interpolation weights and scatters of the stencil values of each
+  // variable, and buffered samples
+  std::vector< std::vector<PetscInt> >                probePoints;
+  std::vector< std::vector< std::vector<PetscReal> > > probeWeights;
+  std::vector< std::vector<VecScatter> >              probeScatters;
+  std::vector< std::vector<Vec> >                     probeStencilValues;
+  std::vector< std::vector<PetscReal> >               probeSamples,
+                                                      probeTimes;
+
+  // statistics: mean and sum of squared deviations of each cell-centred
+  // variable, and buffer of the values of the current time step
+  std::vector<Vec>       statisticsMean,
+                         statisticsM2;
+  std::vector<PetscReal> statisticsSamples[4];
+  PetscInt               numSamples;
+
+  // amount of output and time spent writing it
+  PetscInt64     outputBytes,
+                 fullPrecisionBytes;
+  PetscLogDouble outputTime;
+
+  // stages, and events of the assembly of the operators, of the kernels of a
+  // time step and of the output (registered once, by the first solver created)
+  static PetscLogStage stageInitialize,
+                       stageSolveIntermediateVelocity,
+                       stageSolvePoissonSystem,
+                       stageProjectionStep;
+  static PetscLogEvent eventGenerateA,
+                       eventGenerateBNQ,
+                       eventGenerateQTBNQ,
+                       eventUpdateBodies,
+                       eventExplicitTerms,
+                       eventBoundaryGhosts,
+                       eventGenerateBC1,
+                       eventGenerateRHS1,
+                       eventGenerateR2,
+                       eventGenerateRHS2,
+                       eventProjection,
+                       eventStatistics,
+                       eventProbes,
+                       eventWriteFluxes,
+                       eventWriteLambda,
+                       eventWriteStatistics,
+                       eventWriteRegions,
+                       eventWriteVisualization;
+
+  // register the stages and the events
+  static PetscErrorCode registerLogEvents();
 
   // initialize data common to NavierStokesSolver and derived classes
   PetscErrorCode initializeCommon();
@@ -85,7 +156,7 @@ public:
   virtual PetscErrorCode createVecs();
 
   // set up Krylov solvers used to solve linear systems
-  PetscErrorCode createKSPs();
+  virtual PetscErrorCode createKSPs();
 
   // initialize spaces between adjacent velocity nodes
   void initializeMeshSpacings();
@@ -96,6 +167,24 @@ public:
   // read fluxes from previously saved data
   PetscErrorCode readFluxes();
 
+  // folders of the case and of the saved data interpolated onto the grid
+  std::string interpolationCaseFolder();
+  std::string interpolationDirectory();
+
+  // read the grid of another case
+  PetscErrorCode readSourceGrid(std::string folder, std::vector<PetscReal> *nodes);
+
+  // weights of a linear interpolation and of an average over an interval
+  void linearStencil(const std::vector<PetscReal> &positions, PetscBool periodic, PetscReal length, PetscReal x, std::vector< std::pair<PetscInt, PetscReal> > &stencil);
+  void overlapStencil(const std::vector<PetscReal> &nodes, PetscReal a, PetscReal b, std::vector< std::pair<PetscInt, PetscReal> > &stencil);
+
+  // interpolate a variable saved on the grid of another case
+  PetscErrorCode interpolateField(DM da, Vec v, std::string fileName, PetscInt normal, std::vector<PetscReal> *sourceNodes);
+
+  // initialize the fluxes and the pressure from the data of another case
+  PetscErrorCode interpolateFluxes();
+  PetscErrorCode interpolatePressure(Vec phi);
+
   // initialize lambda vector with previously saved data
   virtual PetscErrorCode initializeLambda();
 
@@ -136,26 +225,115 @@ public:
   virtual PetscErrorCode generateBNQ();
 
   // compute matrix \f$ Q^T B^N Q \f$
-  PetscErrorCode generateQTBNQ();
+  virtual PetscErrorCode generateQTBNQ();
 
   // calculate and specify to the Krylov solver the null-space of the LHS matrix
   // in the pressure-force system
   virtual PetscErrorCode setNullSpace();
 
   // solve system for intermediate velocity fluxes \f$ q^* \f$
-  PetscErrorCode solveIntermediateVelocity();
+  virtual PetscErrorCode solveIntermediateVelocity();
 
   // solver Poisson system for pressure and body forces
-  PetscErrorCode solvePoissonSystem();
+  virtual PetscErrorCode solvePoissonSystem();
 
   // project velocity onto divergence-free field with satisfaction of the no-splip condition
-  PetscErrorCode projectionStep();
+  virtual PetscErrorCode projectionStep();
+
+  // move the immersed boundaries and update the operators that depend on them
+  virtual PetscErrorCode updateImmersedBoundary()
+  {
+    return 0;
+  }
+
+  // add the fields of the derived solvers to the telemetry record of the time step
+  virtual void addTelemetry(std::ostream &)
+  {
+  }
+
+  // write the buffered lines of the logs and the buffered samples of the probes
+  virtual PetscErrorCode flushLogs();
 
   // write fluxes into files
   PetscErrorCode writeFluxes();
 
+  // folder of the save point of the current time step
+  std::string savePointDirectory();
+
+  // write a flow variable at the current time step (folder or container)
+  PetscErrorCode writeField(Vec v, std::string name);
+
+  // write the exact (double precision) values of a flow variable
+  PetscErrorCode writeExactField(Vec v, std::string name);
+
+  // write a flow variable in reduced or compressed form
+  PetscErrorCode writeEncodedField(Vec v, std::string name, FieldEncoding encoding);
+
+  // copy the local values of a vector in the ordering of the output files
+  PetscErrorCode copyNaturalValues(Vec v, std::vector<PetscScalar> &values, PetscInt &start, PetscInt &size);
+
+  // copy a flow variable to be written in the background
+  PetscErrorCode stageField(Vec v, std::string fileName, PetscInt64 offset, PetscBool newFile);
+
+  // read a flow variable saved at the current time step (folder or container)
+  PetscErrorCode readField(Vec v, std::string name);
+
+  // close the container of the flow variables
+  PetscErrorCode closeContainer();
+
+  // flush the outputs and destroy the PETSc objects
+  PetscErrorCode destroyObjects();
+
+  // create the scatters of the output regions and write their grids
+  PetscErrorCode createOutputRegions();
+
+  // write the flow variables of the output regions
+  PetscErrorCode writeOutputRegions();
+
+  // velocity and pressure at the centres of the cells owned by the process
+  // (and the derivatives of the velocity components along their directions)
+  PetscErrorCode computeCellCentredFields(std::vector<PetscReal> *fields, std::vector<PetscReal> *diagonal=PETSC_NULL);
+
+  // write the cell-centred fields as XDMF and raw binary files, or as VTK pieces
+  PetscErrorCode writeXDMF(std::string name, const PetscInt *start, const PetscInt *width, std::vector<PetscReal> *fields);
+  PetscErrorCode writeRectilinearPieces(std::string name, const PetscInt *start, const PetscInt *width, std::vector<PetscReal> *fields);
+
+  // write the cell-centred velocity and pressure for visualization
+  PetscErrorCode writeVisualization();
+
+  // precompute the interpolation of the variables at the probes
+  PetscErrorCode createProbes();
+
+  // is a set of probes sampled at the current time step?
+  PetscBool probeStep();
+
+  // sample the variables at the probes, and write the buffered samples
+  PetscErrorCode sampleProbes();
+  PetscErrorCode flushProbes(size_t s);
+
+  // is the current time step added to the statistics?
+  PetscBool statisticsStep();
+
+  // create (or read) the accumulators of the statistics
+  PetscErrorCode createStatistics();
+
+  // add the current flow variables to the statistics
+  virtual PetscErrorCode updateStatistics();
+
+  // write the mean and RMS fluctuation of the flow variables
+  PetscErrorCode writeStatistics();
+
   // write pressure filed into file
   virtual PetscErrorCode writeLambda();
+
+  // neighbours of a cell centre used by the centred differences along a direction
+  void centredNeighbours(PetscInt c, PetscInt n, PetscBool periodic, const std::vector<PetscReal> &widths, PetscInt &minus, PetscInt &plus, PetscReal &distance);
+
+  // vorticity, Q-criterion and divergence at the cell centres
+  PetscErrorCode computeDerivedFields(Vec *derived);
+
+  // write the derived fields at the current time step
+  PetscErrorCode writeDerivedFields();
   
 public:
   // initial set-up of the system
@@ -170,6 +348,15 @@ public:
   // write flow variables into files
   virtual PetscErrorCode writeData();
 
+  // set up the grids and vectors needed to post-process saved time steps
+  PetscErrorCode initializePostProcessing();
+
+  // read the fluxes of a saved time step and write its derived fields
+  PetscErrorCode postProcess(PetscInt step);
+
+  // destroy the objects created for the post-processing
+  PetscErrorCode finalizePostProcessing();
+
   // write simulation parameters into file
   PetscErrorCode printSimulationInfo();
 
@@ -179,6 +366,9 @@ public:
   // specify if data needs to be saved at current time-step
   PetscBool savePoint();
 
+  // specify if the exact values of all the variables are saved at current time-step
+  PetscBool restartPoint();
+
   // evaluate if the simulation is completed
   PetscBool finished();
   
@@ -233,11 +423,20 @@ public:
     ksp2 = PETSC_NULL;
     // PCs
     pc2 = PETSC_NULL;
-    // PetscLogStages
-    PetscLogStageRegister("initialize", &stageInitialize);
-    PetscLogStageRegister("solveIntVel", &stageSolveIntermediateVelocity);
-    PetscLogStageRegister("solvePoissSys", &stageSolvePoissonSystem);
-    PetscLogStageRegister("projectionStep", &stageProjectionStep);
+    // output container
+    containerViewer = PETSC_NULL;
+    containerSnapshots = 0;
+    containerStep = -1;
+    containerOffset = 0;
+    asyncWriter = PETSC_NULL;
+    telemetryLog = PETSC_NULL;
+    iterationsLog = PETSC_NULL;
+    stageTimes[0] = stageTimes[1] = stageTimes[2] = 0.0;
+    numSamples = 0;
+    outputBytes = 0;
+    fullPrecisionBytes = 0;
+    outputTime = 0.0;
+    registerLogEvents();
   }
 };
 
@@ -0,0 +1,61 @@
+/***************************************************************************//**
+ * \file createKSPs.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the method `createKSPs` of \c NullSpaceSolver.
+ */
+
+
+/**
+ * \brief Assembles the discrete curl and sets up the Krylov solvers.
+ *
+ * `ksp1` solves for the intermediate velocity, as in \c NavierStokesSolver
+ * (options with prefix `sys1_`). `ksp2` solves the systems with
+ * \f$ K = C^T (B^N)^{-1} C \f$ (options with prefix `sys2_`), and
+ * `kspPressure` the pressure system \f$ G^T B^N G \f$, used when the data are
+ * saved (options with prefix `sys3_`). No solver is set up for
+ * \f$ Q^T B^N Q \f$.
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::createKSPs()
+{
+	PetscErrorCode ierr;
+	MatNullSpace   nsp;
+
+	KSP &ksp1 = NavierStokesSolver<dim>::ksp1,
+	    &ksp2 = NavierStokesSolver<dim>::ksp2;
+	SimulationParameters *simParams = NavierStokesSolver<dim>::simParams;
+
+	ierr = generateCurl(); CHKERRQ(ierr);
+
+	// linear system for the intermediate velocity
+	ierr = KSPCreate(PETSC_COMM_WORLD, &ksp1); CHKERRQ(ierr);
+	ierr = KSPSetOptionsPrefix(ksp1, "sys1_"); CHKERRQ(ierr);
+	ierr = KSPSetTolerances(ksp1, simParams->velocitySolveTolerance, PETSC_DEFAULT, PETSC_DEFAULT, simParams->velocitySolveMaxIts); CHKERRQ(ierr);
+	ierr = KSPSetOperators(ksp1, NavierStokesSolver<dim>::A, NavierStokesSolver<dim>::A); CHKERRQ(ierr);
+	ierr = KSPSetInitialGuessNonzero(ksp1, PETSC_TRUE); CHKERRQ(ierr);
+	ierr = KSPSetType(ksp1, KSPCG); CHKERRQ(ierr);
+	ierr = KSPSetFromOptions(ksp1); CHKERRQ(ierr);
+
+	// linear system for the streamfunction (non-singular)
+	ierr = KSPCreate(PETSC_COMM_WORLD, &ksp2); CHKERRQ(ierr);
+	ierr = KSPSetOptionsPrefix(ksp2, "sys2_"); CHKERRQ(ierr);
+	ierr = KSPSetTolerances(ksp2, simParams->PoissonSolveTolerance, PETSC_DEFAULT, PETSC_DEFAULT, simParams->PoissonSolveMaxIts); CHKERRQ(ierr);
+	ierr = KSPSetOperators(ksp2, K, K); CHKERRQ(ierr);
+	ierr = KSPSetInitialGuessNonzero(ksp2, PETSC_TRUE); CHKERRQ(ierr);
+	ierr = KSPSetType(ksp2, KSPCG); CHKERRQ(ierr);
+	ierr = KSPSetFromOptions(ksp2); CHKERRQ(ierr);
+
+	// linear system for the pressure
+	ierr = KSPCreate(PETSC_COMM_WORLD, &kspPressure); CHKERRQ(ierr);
+	ierr = KSPSetOptionsPrefix(kspPressure, "sys3_"); CHKERRQ(ierr);
+	ierr = KSPSetTolerances(kspPressure, simParams->PoissonSolveTolerance, PETSC_DEFAULT, PETSC_DEFAULT, simParams->PoissonSolveMaxIts); CHKERRQ(ierr);
+	ierr = KSPSetOperators(kspPressure, TairaColoniusSolver<dim>::GTBNG, TairaColoniusSolver<dim>::GTBNG); CHKERRQ(ierr);
+	ierr = KSPSetInitialGuessNonzero(kspPressure, PETSC_TRUE); CHKERRQ(ierr);
+	ierr = KSPSetType(kspPressure, KSPCG); CHKERRQ(ierr);
+	ierr = MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_TRUE, 0, NULL, &nsp); CHKERRQ(ierr);
+	ierr = KSPSetNullSpace(kspPressure, nsp); CHKERRQ(ierr);
+	ierr = MatNullSpaceDestroy(&nsp); CHKERRQ(ierr);
+	ierr = KSPSetFromOptions(kspPressure); CHKERRQ(ierr);
+
+	return 0;
+}
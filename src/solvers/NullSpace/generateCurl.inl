@@ -0,0 +1,147 @@
+/***************************************************************************//**
+ * \file generateCurl.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the method `generateCurl` of \c NullSpaceSolver.
+ */
+
+
+/**
+ * \brief Creates the distributed array of the streamfunction and assembles
+ *        the discrete curl \f$ C \f$ and the matrix
+ *        \f$ K = C^T (B^N)^{-1} C \f$.
+ *
+ * The streamfunction is stored at the \f$ (nx-1) \times (ny-1) \f$ interior
+ * nodes of the grid; node \f$ (i,j) \f$ is the upper-right corner of the
+ * pressure cell \f$ (i,j) \f$. The nodes are distributed like the x-fluxes
+ * along x and like the y-fluxes along y, so that each process owns the
+ * nodes around its own fluxes. The flux through a face is the difference of
+ * the streamfunction at its two ends:
+ * \f[ q_x(i,j) = s(i,j) - s(i,j-1), \qquad q_y(i,j) = s(i-1,j) - s(i,j) \f]
+ * so that \f$ Q^T C = 0 \f$ in the interior of the domain. Nodes on the
+ * boundary of the domain are not unknowns: their contribution is carried by
+ * the particular fluxes \f$ q_p \f$.
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::generateCurl()
+{
+	SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "The discrete curl is only implemented in 2D");
+}
+
+template <>
+PetscErrorCode NullSpaceSolver<2>::generateCurl()
+{
+	PetscErrorCode ierr;
+	PetscInt       m, n, mstart, nstart, i, j, localIdx;
+	const PetscInt *lxu, *lyv;
+	PetscReal      **ls, **lu, **lv;
+	PetscInt       row, cols[2];
+	PetscReal      values[2];
+	PetscInt       numCols, qLocalSize, sLocalSize;
+	Mat            WC;
+	Vec            BNInv;
+
+	// distributed array of the streamfunction
+	ierr = DMDAGetInfo(uda, NULL, NULL, NULL, NULL, &m, &n, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+	ierr = DMDAGetOwnershipRanges(uda, &lxu, NULL, NULL); CHKERRQ(ierr);
+	ierr = DMDAGetOwnershipRanges(vda, NULL, &lyv, NULL); CHKERRQ(ierr);
+	ierr = DMDACreate2d(PETSC_COMM_WORLD, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_STAR, mesh->nx-1, mesh->ny-1, m, n, 1, 1, lxu, lyv, &sda); CHKERRQ(ierr);
+	ierr = DMCreateGlobalVector(sda, &s); CHKERRQ(ierr);
+	ierr = VecDuplicate(s, &sRHS); CHKERRQ(ierr);
+	ierr = VecDuplicate(q, &qParticular); CHKERRQ(ierr);
+	ierr = VecDuplicate(q, &qTemp); CHKERRQ(ierr);
+
+	// global indices of the nodes, with the values of the neighbours in the ghost nodes
+	ierr = VecGetOwnershipRange(s, &localIdx, NULL); CHKERRQ(ierr);
+	ierr = DMCreateLocalVector(sda, &sMapping); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(sda, sMapping, &ls); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(sda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+	for(j=nstart; j<nstart+n; j++)
+	{
+		for(i=mstart; i<mstart+m; i++)
+		{
+			ls[j][i] = localIdx;
+			localIdx++;
+		}
+	}
+	ierr = DMDAVecRestoreArray(sda, sMapping, &ls); CHKERRQ(ierr);
+	ierr = DMLocalToLocalBegin(sda, sMapping, INSERT_VALUES, sMapping); CHKERRQ(ierr);
+	ierr = DMLocalToLocalEnd(sda, sMapping, INSERT_VALUES, sMapping); CHKERRQ(ierr);
+
+	// discrete curl (at most two non-zeros per row)
+	ierr = VecGetLocalSize(q, &qLocalSize); CHKERRQ(ierr);
+	ierr = VecGetLocalSize(s, &sLocalSize); CHKERRQ(ierr);
+	ierr = MatCreate(PETSC_COMM_WORLD, &C); CHKERRQ(ierr);
+	ierr = MatSetSizes(C, qLocalSize, sLocalSize, PETSC_DETERMINE, PETSC_DETERMINE); CHKERRQ(ierr);
+	ierr = MatSetFromOptions(C); CHKERRQ(ierr);
+	ierr = MatSeqAIJSetPreallocation(C, 2, NULL); CHKERRQ(ierr);
+	ierr = MatMPIAIJSetPreallocation(C, 2, NULL, 2, NULL); CHKERRQ(ierr);
+
+	ierr = DMDAVecGetArray(sda, sMapping, &ls); CHKERRQ(ierr);
+	// U
+	ierr = DMDAVecGetArray(uda, uMapping, &lu); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+	for(j=nstart; j<nstart+n; j++)
+	{
+		for(i=mstart; i<mstart+m; i++)
+		{
+			row = lu[j][i];
+			numCols = 0;
+			if(j < mesh->ny-1)
+			{
+				cols[numCols] = ls[j][i];
+				values[numCols] = 1.0;
+				numCols++;
+			}
+			if(j > 0)
+			{
+				cols[numCols] = ls[j-1][i];
+				values[numCols] = -1.0;
+				numCols++;
+			}
+			ierr = MatSetValues(C, 1, &row, numCols, cols, values, INSERT_VALUES); CHKERRQ(ierr);
+		}
+	}
+	ierr = DMDAVecRestoreArray(uda, uMapping, &lu); CHKERRQ(ierr);
+	// V
+	ierr = DMDAVecGetArray(vda, vMapping, &lv); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+	for(j=nstart; j<nstart+n; j++)
+	{
+		for(i=mstart; i<mstart+m; i++)
+		{
+			row = lv[j][i];
+			numCols = 0;
+			if(i > 0)
+			{
+				cols[numCols] = ls[j][i-1];
+				values[numCols] = 1.0;
+				numCols++;
+			}
+			if(i < mesh->nx-1)
+			{
+				cols[numCols] = ls[j][i];
+				values[numCols] = -1.0;
+				numCols++;
+			}
+			ierr = MatSetValues(C, 1, &row, numCols, cols, values, INSERT_VALUES); CHKERRQ(ierr);
+		}
+	}
+	ierr = DMDAVecRestoreArray(vda, vMapping, &lv); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(sda, sMapping, &ls); CHKERRQ(ierr);
+
+	ierr = MatAssemblyBegin(C, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+	ierr = MatAssemblyEnd(C, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+
+	// K = C^T (B^N)^{-1} C
+	ierr = MatTranspose(C, MAT_INITIAL_MATRIX, &CT); CHKERRQ(ierr);
+	ierr = VecDuplicate(BN, &BNInv); CHKERRQ(ierr);
+	ierr = VecCopy(BN, BNInv); CHKERRQ(ierr);
+	ierr = VecReciprocal(BNInv); CHKERRQ(ierr);
+	ierr = MatDuplicate(C, MAT_COPY_VALUES, &WC); CHKERRQ(ierr);
+	ierr = MatDiagonalScale(WC, BNInv, NULL); CHKERRQ(ierr);
+	ierr = MatMatMult(CT, WC, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &K); CHKERRQ(ierr);
+	ierr = MatDestroy(&WC); CHKERRQ(ierr);
+	ierr = VecDestroy(&BNInv); CHKERRQ(ierr);
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+/***************************************************************************//**
+ * \file generateForceSystem.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the method `generateForceSystem`
+ *        of \c NullSpaceSolver.
+ */
+
+
+/**
+ * \brief Precomputes and factors the system for the body forces.
+ *
+ * With \f$ q = q_p + C s \f$, minimizing the kinetic energy of the correction
+ * gives \f$ K s = C^T (B^N)^{-1} (q^* - q_p) - C^T E^T f \f$, and the
+ * no-slip condition \f$ E q = u_B \f$ gives
+ * \f[ E C K^{-1} C^T E^T f = E (q_p + C K^{-1} C^T (B^N)^{-1} (q^* - q_p)) - u_B \f]
+ * The columns of \f$ Z = K^{-1} C^T E^T \f$ are obtained with one solve
+ * per component of the Lagrangian force and stored as a dense matrix
+ * distributed like the streamfunction. The matrix \f$ E C Z \f$ is symmetric
+ * positive-definite and small: it is gathered on every process, symmetrized
+ * (the solves are iterative) and Cholesky-factored there.
+ *
+ * `ksp2` solves the systems with \f$ K \f$ (see `createKSPs`).
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::generateForceSystem()
+{
+	PetscErrorCode ierr;
+	Vec            fUnit;
+	MatFactorInfo  info;
+	PetscInt       numStreamfunctionLocal, numForcesLocal, numForces, fStart, fEnd;
+	PetscReal      *Z, *S, *values;
+	PetscLogDouble t0, t1;
+
+	Vec &fTemp = TairaColoniusSolver<dim>::fTemp,
+	    &fSeq = TairaColoniusSolver<dim>::fSeq,
+	    &fSeqRHS = TairaColoniusSolver<dim>::fSeqRHS;
+	Mat &schurComplement = TairaColoniusSolver<dim>::schurComplement;
+	KSP &ksp2 = NavierStokesSolver<dim>::ksp2;
+
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+
+	ierr = VecDuplicate(fTemp, &fUnit); CHKERRQ(ierr);
+	ierr = VecGetLocalSize(s, &numStreamfunctionLocal); CHKERRQ(ierr);
+	ierr = VecGetLocalSize(fTemp, &numForcesLocal); CHKERRQ(ierr);
+	ierr = VecGetSize(fTemp, &numForces); CHKERRQ(ierr);
+	ierr = VecGetOwnershipRange(fTemp, &fStart, &fEnd); CHKERRQ(ierr);
+
+	ierr = VecScatterCreateToAll(fTemp, &TairaColoniusSolver<dim>::forceScatter, &fSeq); CHKERRQ(ierr);
+	ierr = VecDuplicate(fSeq, &fSeqRHS); CHKERRQ(ierr);
+
+	ierr = MatCreateDense(PETSC_COMM_WORLD, numStreamfunctionLocal, numForcesLocal, PETSC_DETERMINE, PETSC_DETERMINE, NULL, &streamfunctionCorrection); CHKERRQ(ierr);
+	ierr = MatCreateSeqDense(PETSC_COMM_SELF, numForces, numForces, NULL, &schurComplement); CHKERRQ(ierr);
+	ierr = MatDenseGetArray(streamfunctionCorrection, &Z); CHKERRQ(ierr);
+	ierr = MatDenseGetArray(schurComplement, &S); CHKERRQ(ierr);
+
+	// one column of Z and E C Z per component of the Lagrangian force
+	for(PetscInt j=0; j<numForces; j++)
+	{
+		ierr = VecSet(fUnit, 0.0); CHKERRQ(ierr);
+		if(j>=fStart && j<fEnd)
+		{
+			ierr = VecSetValue(fUnit, j, 1.0, INSERT_VALUES); CHKERRQ(ierr);
+		}
+		ierr = VecAssemblyBegin(fUnit); CHKERRQ(ierr);
+		ierr = VecAssemblyEnd(fUnit); CHKERRQ(ierr);
+
+		// Z e_j
+		ierr = MatMult(TairaColoniusSolver<dim>::ET, fUnit, qTemp); CHKERRQ(ierr);
+		ierr = MatMult(CT, qTemp, sRHS); CHKERRQ(ierr);
+		ierr = VecPlaceArray(s, Z + j*numStreamfunctionLocal); CHKERRQ(ierr);
+		ierr = VecSet(s, 0.0); CHKERRQ(ierr);
+		ierr = KSPSolve(ksp2, sRHS, s); CHKERRQ(ierr);
+
+		// E C Z e_j
+		ierr = MatMult(C, s, qTemp); CHKERRQ(ierr);
+		ierr = VecResetArray(s); CHKERRQ(ierr);
+		ierr = MatMultTranspose(TairaColoniusSolver<dim>::ET, qTemp, fTemp); CHKERRQ(ierr);
+		ierr = VecScatterBegin(TairaColoniusSolver<dim>::forceScatter, fTemp, fSeq, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+		ierr = VecScatterEnd(TairaColoniusSolver<dim>::forceScatter, fTemp, fSeq, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+		ierr = VecGetArray(fSeq, &values); CHKERRQ(ierr);
+		ierr = PetscMemcpy(S + j*numForces, values, numForces*sizeof(PetscReal)); CHKERRQ(ierr);
+		ierr = VecRestoreArray(fSeq, &values); CHKERRQ(ierr);
+	}
+
+	// remove the asymmetry left by the iterative solves
+	for(PetscInt j=0; j<numForces; j++)
+	{
+		for(PetscInt i=0; i<j; i++)
+		{
+			S[i + j*numForces] = 0.5*(S[i + j*numForces] + S[j + i*numForces]);
+			S[j + i*numForces] = S[i + j*numForces];
+		}
+	}
+
+	ierr = MatDenseRestoreArray(schurComplement, &S); CHKERRQ(ierr);
+	ierr = MatDenseRestoreArray(streamfunctionCorrection, &Z); CHKERRQ(ierr);
+	ierr = MatAssemblyBegin(streamfunctionCorrection, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+	ierr = MatAssemblyEnd(streamfunctionCorrection, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+	ierr = MatAssemblyBegin(schurComplement, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+	ierr = MatAssemblyEnd(schurComplement, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+
+	ierr = MatFactorInfoInitialize(&info); CHKERRQ(ierr);
+	ierr = MatCholeskyFactor(schurComplement, NULL, &info); CHKERRQ(ierr);
+
+	ierr = VecDestroy(&fUnit); CHKERRQ(ierr);
+	ierr = VecSet(s, 0.0); CHKERRQ(ierr);
+
+	ierr = PetscTime(&t1); CHKERRQ(ierr);
+	ierr = PetscPrintf(PETSC_COMM_WORLD, "Force system for %d force components computed in %g s\n", numForces, t1-t0); CHKERRQ(ierr);
+
+	return 0;
+}
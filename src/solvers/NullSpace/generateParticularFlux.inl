@@ -0,0 +1,133 @@
+/***************************************************************************//**
+ * \file generateParticularFlux.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the method `generateParticularFlux`
+ *        of \c NullSpaceSolver.
+ */
+
+
+/**
+ * \brief Computes the fluxes \f$ q_p \f$ generated by the streamfunction on
+ *        the boundary of the domain.
+ *
+ * The streamfunction on the boundary is obtained by integrating the fluxes
+ * through the boundary (stored in the ghost cells of the local flux vectors
+ * by `updateBoundaryGhosts`) counter-clockwise from the bottom-left corner.
+ * The net flux through the boundary has to vanish for the streamfunction to
+ * be single-valued: the mismatch (e.g. from a convective outflow) is removed
+ * by a uniform normal velocity over the whole boundary. The particular fluxes
+ * are then non-zero only on the faces next to the boundary.
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::generateParticularFlux()
+{
+	return 0;
+}
+
+template <>
+PetscErrorCode NullSpaceSolver<2>::generateParticularFlux()
+{
+	PetscErrorCode ierr;
+	PetscInt       mstart, nstart, m, n, i, j, M, N;
+	PetscInt       nx = mesh->nx,
+	               ny = mesh->ny;
+	PetscReal      **qx, **qy;
+	PetscReal      netFlux = 0.0, perimeter;
+	Vec            qxGlobal, qyGlobal;
+
+	// fluxes through the bottom, right, top and left boundaries
+	std::vector<PetscReal> fluxes(2*nx+2*ny, 0.0);
+	PetscReal *bottom = &fluxes[0],
+	          *right  = &fluxes[nx],
+	          *top    = &fluxes[nx+ny],
+	          *left   = &fluxes[2*nx+ny];
+
+	// U-FLUXES
+	ierr = DMDAVecGetArray(uda, qxLocal, &qx); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+	ierr = DMDAGetInfo(uda, NULL, &M, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+	for(j=nstart; j<nstart+n; j++)
+	{
+		if(mstart == 0)
+			left[j] = qx[j][-1];
+		if(mstart+m == M)
+			right[j] = qx[j][M];
+	}
+	ierr = DMDAVecRestoreArray(uda, qxLocal, &qx); CHKERRQ(ierr);
+
+	// V-FLUXES
+	ierr = DMDAVecGetArray(vda, qyLocal, &qy); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+	ierr = DMDAGetInfo(vda, NULL, NULL, &N, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+	for(i=mstart; i<mstart+m; i++)
+	{
+		if(nstart == 0)
+			bottom[i] = qy[-1][i];
+		if(nstart+n == N)
+			top[i] = qy[N][i];
+	}
+	ierr = DMDAVecRestoreArray(vda, qyLocal, &qy); CHKERRQ(ierr);
+
+	ierr = MPI_Allreduce(MPI_IN_PLACE, &fluxes.front(), 2*nx+2*ny, MPIU_REAL, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	// remove the net flux through the boundary
+	for(i=0; i<nx; i++)
+		netFlux += top[i] - bottom[i];
+	for(j=0; j<ny; j++)
+		netFlux += right[j] - left[j];
+	perimeter = 2.0*(mesh->x[nx]-mesh->x[0] + mesh->y[ny]-mesh->y[0]);
+	for(i=0; i<nx; i++)
+	{
+		bottom[i] += netFlux*mesh->dx[i]/perimeter;
+		top[i]    -= netFlux*mesh->dx[i]/perimeter;
+	}
+	for(j=0; j<ny; j++)
+	{
+		left[j]  += netFlux*mesh->dy[j]/perimeter;
+		right[j] -= netFlux*mesh->dy[j]/perimeter;
+	}
+
+	// streamfunction on the boundary (u = ds/dy, v = -ds/dx)
+	std::vector<PetscReal> sBottom(nx+1), sRight(ny+1), sTop(nx+1), sLeft(ny+1);
+	sBottom[0] = 0.0;
+	for(i=0; i<nx; i++)
+		sBottom[i+1] = sBottom[i] - bottom[i];
+	sRight[0] = sBottom[nx];
+	for(j=0; j<ny; j++)
+		sRight[j+1] = sRight[j] + right[j];
+	sTop[nx] = sRight[ny];
+	for(i=nx-1; i>=0; i--)
+		sTop[i] = sTop[i+1] + top[i];
+	sLeft[ny] = sTop[0];
+	for(j=ny-1; j>=0; j--)
+		sLeft[j] = sLeft[j+1] - left[j];
+
+	// fluxes through the faces next to the boundary
+	ierr = VecSet(qParticular, 0.0); CHKERRQ(ierr);
+	ierr = DMCompositeGetAccess(qPack, qParticular, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
+	// U
+	ierr = DMDAVecGetArray(uda, qxGlobal, &qx); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+	for(i=mstart; i<mstart+m; i++)
+	{
+		if(nstart == 0)
+			qx[0][i] -= sBottom[i+1];
+		if(nstart+n == ny)
+			qx[ny-1][i] += sTop[i+1];
+	}
+	ierr = DMDAVecRestoreArray(uda, qxGlobal, &qx); CHKERRQ(ierr);
+	// V
+	ierr = DMDAVecGetArray(vda, qyGlobal, &qy); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+	for(j=nstart; j<nstart+n; j++)
+	{
+		if(mstart == 0)
+			qy[j][0] += sLeft[j+1];
+		if(mstart+m == nx)
+			qy[j][nx-1] -= sRight[j+1];
+	}
+	ierr = DMDAVecRestoreArray(vda, qyGlobal, &qy); CHKERRQ(ierr);
+	ierr = DMCompositeRestoreAccess(qPack, qParticular, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+/***************************************************************************//**
+ * \file generateQTBNQ.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the method `generateQTBNQ` of \c NullSpaceSolver.
+ */
+
+
+/**
+ * \brief Computes the blocks \f$ G^T B^N G \f$ and \f$ G^T B^N E^T \f$ used
+ *        to recover the pressure.
+ *
+ * The streamfunction formulation does not solve the system for the pressure
+ * and the forces, so only the rows of \f$ Q^T B^N Q \f$ associated with the
+ * pressure are computed, from the rows of \f$ Q^T \f$ associated with the
+ * pressure. The matrix \f$ Q^T B^N Q \f$ itself is never built.
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::generateQTBNQ()
+{
+	PetscErrorCode ierr;
+	IS             *is, qIS, rowsIS;
+	Mat            GT, GTBNQ;
+	PetscInt       start, end;
+
+	IS &phiIS = TairaColoniusSolver<dim>::phiIS,
+	   &fIS = TairaColoniusSolver<dim>::fIS;
+
+	ierr = PetscLogEventBegin(NavierStokesSolver<dim>::eventGenerateQTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+
+	ierr = DMCompositeGetGlobalISs(NavierStokesSolver<dim>::lambdaPack, &is); CHKERRQ(ierr);
+	phiIS = is[0];
+	fIS = is[1];
+	ierr = PetscFree(is); CHKERRQ(ierr);
+
+	// rows of Q^T B^N Q associated with the pressure
+	ierr = VecGetOwnershipRange(NavierStokesSolver<dim>::q, &start, &end); CHKERRQ(ierr);
+	ierr = ISCreateStride(PETSC_COMM_WORLD, end-start, start, 1, &qIS); CHKERRQ(ierr);
+	ierr = MatGetSubMatrix(NavierStokesSolver<dim>::QT, phiIS, qIS, MAT_INITIAL_MATRIX, &GT); CHKERRQ(ierr);
+	ierr = MatMatMult(GT, NavierStokesSolver<dim>::BNQ, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &GTBNQ); CHKERRQ(ierr);
+
+	// split the columns into the pressure and the forces
+	ierr = MatGetOwnershipRange(GTBNQ, &start, &end); CHKERRQ(ierr);
+	ierr = ISCreateStride(PETSC_COMM_WORLD, end-start, start, 1, &rowsIS); CHKERRQ(ierr);
+	ierr = MatGetSubMatrix(GTBNQ, rowsIS, phiIS, MAT_INITIAL_MATRIX, &TairaColoniusSolver<dim>::GTBNG); CHKERRQ(ierr);
+	ierr = MatGetSubMatrix(GTBNQ, rowsIS, fIS, MAT_INITIAL_MATRIX, &TairaColoniusSolver<dim>::GTBNET); CHKERRQ(ierr);
+	ierr = MatGetVecs(TairaColoniusSolver<dim>::GTBNET, &TairaColoniusSolver<dim>::fTemp, &TairaColoniusSolver<dim>::phiTemp); CHKERRQ(ierr);
+
+	ierr = ISDestroy(&qIS); CHKERRQ(ierr);
+	ierr = ISDestroy(&rowsIS); CHKERRQ(ierr);
+	ierr = MatDestroy(&GT); CHKERRQ(ierr);
+	ierr = MatDestroy(&GTBNQ); CHKERRQ(ierr);
+
+	ierr = PetscLogEventEnd(NavierStokesSolver<dim>::eventGenerateQTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+
+	return 0;
+}
@@ -0,0 +1,125 @@
+/***************************************************************************//**
+ * \file solvePoissonSystem.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c NullSpaceSolver that solve for
+ *        the streamfunction, the body forces and the pressure.
+ */
+
+
+/**
+ * \brief Solves for the streamfunction without the forces and for the body
+ *        forces.
+ *
+ * \f[ K s_0 = C^T (B^N)^{-1} (q^* - q_p) \f]
+ * \f[ S f = E (q_p + C s_0) - u_B \f]
+ * The fluxes are set to \f$ q_p + C s_0 \f$; the effect of the forces is
+ * subtracted in `projectionStep`. The forces are stored in the force portion
+ * of \f$ \lambda \f$, as with \c TairaColoniusSolver.
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::solvePoissonSystem()
+{
+	PetscErrorCode     ierr;
+	KSPConvergedReason reason;
+	Vec                f;
+	PetscInt           fStart, fEnd;
+	PetscReal          *fArray, *values;
+
+	Vec &q = NavierStokesSolver<dim>::q,
+	    &fTemp = TairaColoniusSolver<dim>::fTemp,
+	    &fSeq = TairaColoniusSolver<dim>::fSeq,
+	    &fSeqRHS = TairaColoniusSolver<dim>::fSeqRHS;
+
+	ierr = generateParticularFlux(); CHKERRQ(ierr);
+
+	// streamfunction without the forces
+	ierr = VecWAXPY(qTemp, -1.0, qParticular, NavierStokesSolver<dim>::qStar); CHKERRQ(ierr);
+	ierr = VecPointwiseDivide(qTemp, qTemp, NavierStokesSolver<dim>::BN); CHKERRQ(ierr);
+	ierr = MatMult(CT, qTemp, sRHS); CHKERRQ(ierr);
+	ierr = KSPSolve(NavierStokesSolver<dim>::ksp2, sRHS, s); CHKERRQ(ierr);
+	ierr = KSPGetConvergedReason(NavierStokesSolver<dim>::ksp2, &reason); CHKERRQ(ierr);
+	if(reason < 0)
+	{
+		ierr = TairaColoniusSolver<dim>::flushLogs(); CHKERRQ(ierr);
+		SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_NOT_CONVERGED, "Streamfunction solve diverged due to reason: %d", reason);
+	}
+	ierr = MatMultAdd(C, s, qParticular, q); CHKERRQ(ierr);
+
+	// forces (the bodies are at rest)
+	ierr = MatMultTranspose(TairaColoniusSolver<dim>::ET, q, fTemp); CHKERRQ(ierr);
+	ierr = VecScatterBegin(TairaColoniusSolver<dim>::forceScatter, fTemp, fSeqRHS, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+	ierr = VecScatterEnd(TairaColoniusSolver<dim>::forceScatter, fTemp, fSeqRHS, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+	ierr = MatSolve(TairaColoniusSolver<dim>::schurComplement, fSeqRHS, fSeq); CHKERRQ(ierr);
+	ierr = VecGetSubVector(NavierStokesSolver<dim>::lambda, TairaColoniusSolver<dim>::fIS, &f); CHKERRQ(ierr);
+	ierr = VecGetOwnershipRange(f, &fStart, &fEnd); CHKERRQ(ierr);
+	ierr = VecGetArray(f, &fArray); CHKERRQ(ierr);
+	ierr = VecGetArray(fSeq, &values); CHKERRQ(ierr);
+	ierr = PetscMemcpy(fArray, values + fStart, (fEnd-fStart)*sizeof(PetscReal)); CHKERRQ(ierr);
+	ierr = VecRestoreArray(fSeq, &values); CHKERRQ(ierr);
+	ierr = VecRestoreArray(f, &fArray); CHKERRQ(ierr);
+	ierr = VecRestoreSubVector(NavierStokesSolver<dim>::lambda, TairaColoniusSolver<dim>::fIS, &f); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Removes the effect of the body forces from the fluxes.
+ *
+ * \f[ q = q_p + C (s_0 - Z f) \f]
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::projectionStep()
+{
+	PetscErrorCode ierr;
+	Vec            f;
+
+	ierr = VecGetSubVector(NavierStokesSolver<dim>::lambda, TairaColoniusSolver<dim>::fIS, &f); CHKERRQ(ierr);
+	ierr = MatMult(streamfunctionCorrection, f, sRHS); CHKERRQ(ierr);
+	ierr = VecRestoreSubVector(NavierStokesSolver<dim>::lambda, TairaColoniusSolver<dim>::fIS, &f); CHKERRQ(ierr);
+	ierr = VecAXPY(s, -1.0, sRHS); CHKERRQ(ierr);
+	ierr = MatMultAdd(C, s, qParticular, NavierStokesSolver<dim>::q); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Recovers the pressure from the fluxes and the forces.
+ *
+ * The projection satisfies \f$ q^* - q = B^N (G \phi + E^T f) \f$, hence
+ * \f[ G^T B^N G \phi = Q^T (q^* - q) |_\phi - G^T B^N E^T f \f]
+ * This pressure solve is only needed when the data are saved, or added to
+ * the statistics.
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::recoverPressure()
+{
+	PetscErrorCode     ierr;
+	KSPConvergedReason reason;
+	Vec                rhsPhi, phi, f;
+
+	Vec &rhs2 = NavierStokesSolver<dim>::rhs2,
+	    &lambda = NavierStokesSolver<dim>::lambda,
+	    &phiTemp = TairaColoniusSolver<dim>::phiTemp;
+
+	// rhs2 is regenerated at the next time step
+	ierr = VecWAXPY(qTemp, -1.0, NavierStokesSolver<dim>::q, NavierStokesSolver<dim>::qStar); CHKERRQ(ierr);
+	ierr = MatMult(NavierStokesSolver<dim>::QT, qTemp, rhs2); CHKERRQ(ierr);
+
+	ierr = VecGetSubVector(rhs2, TairaColoniusSolver<dim>::phiIS, &rhsPhi); CHKERRQ(ierr);
+	ierr = VecGetSubVector(lambda, TairaColoniusSolver<dim>::fIS, &f); CHKERRQ(ierr);
+	ierr = VecGetSubVector(lambda, TairaColoniusSolver<dim>::phiIS, &phi); CHKERRQ(ierr);
+	ierr = MatMult(TairaColoniusSolver<dim>::GTBNET, f, phiTemp); CHKERRQ(ierr);
+	ierr = VecAXPY(rhsPhi, -1.0, phiTemp); CHKERRQ(ierr);
+	ierr = KSPSolve(kspPressure, rhsPhi, phi); CHKERRQ(ierr);
+	ierr = KSPGetConvergedReason(kspPressure, &reason); CHKERRQ(ierr);
+	if(reason < 0)
+	{
+		ierr = TairaColoniusSolver<dim>::flushLogs(); CHKERRQ(ierr);
+		SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_NOT_CONVERGED, "Pressure solve diverged due to reason: %d", reason);
+	}
+	ierr = VecRestoreSubVector(lambda, TairaColoniusSolver<dim>::phiIS, &phi); CHKERRQ(ierr);
+	ierr = VecRestoreSubVector(lambda, TairaColoniusSolver<dim>::fIS, &f); CHKERRQ(ierr);
+	ierr = VecRestoreSubVector(rhs2, TairaColoniusSolver<dim>::phiIS, &rhsPhi); CHKERRQ(ierr);
+
+	return 0;
+}
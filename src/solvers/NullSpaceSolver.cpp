@@ -0,0 +1,130 @@
+/***************************************************************************//**
+ * \file NullSpaceSolver.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of the class \c NullSpaceSolver.
+ */
+
+
+#include "NullSpaceSolver.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <petscdmcomposite.h>
+
+
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::initialize()
+{
+  PetscErrorCode ierr;
+
+  if(dim != 2)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "The null-space solver is only available in 2D");
+  }
+  if(NavierStokesSolver<dim>::simParams->forceSolver == SCHUR_COMPLEMENT)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "The null-space solver always precomputes the force system: use forceSolver COUPLED");
+  }
+  if(NavierStokesSolver<dim>::flowDesc->bc[0][XPLUS].type == PERIODIC || NavierStokesSolver<dim>::flowDesc->bc[0][YPLUS].type == PERIODIC)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "The null-space solver does not support periodic domains");
+  }
+
+  ierr = TairaColoniusSolver<dim>::initialize(); CHKERRQ(ierr);
+  if(TairaColoniusSolver<dim>::movingBodies)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "The null-space solver requires all the bodies to be at rest");
+  }
+
+  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageInitialize); CHKERRQ(ierr);
+  ierr = generateForceSystem(); CHKERRQ(ierr);
+  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+
+  return 0;
+}
+
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::finalize()
+{
+  PetscErrorCode ierr;
+
+  ierr = TairaColoniusSolver<dim>::finalize(); CHKERRQ(ierr);
+
+  // DMs
+  if(sda!=PETSC_NULL) {ierr = DMDestroy(&sda); CHKERRQ(ierr);}
+  // Mats
+  if(C!=PETSC_NULL)   {ierr = MatDestroy(&C); CHKERRQ(ierr);}
+  if(CT!=PETSC_NULL)  {ierr = MatDestroy(&CT); CHKERRQ(ierr);}
+  if(K!=PETSC_NULL)   {ierr = MatDestroy(&K); CHKERRQ(ierr);}
+  if(streamfunctionCorrection!=PETSC_NULL){ierr = MatDestroy(&streamfunctionCorrection); CHKERRQ(ierr);}
+  // Vecs
+  if(sMapping!=PETSC_NULL)   {ierr = VecDestroy(&sMapping); CHKERRQ(ierr);}
+  if(s!=PETSC_NULL)          {ierr = VecDestroy(&s); CHKERRQ(ierr);}
+  if(sRHS!=PETSC_NULL)       {ierr = VecDestroy(&sRHS); CHKERRQ(ierr);}
+  if(qParticular!=PETSC_NULL){ierr = VecDestroy(&qParticular); CHKERRQ(ierr);}
+  if(qTemp!=PETSC_NULL)      {ierr = VecDestroy(&qTemp); CHKERRQ(ierr);}
+  // KSPs
+  if(kspPressure!=PETSC_NULL){ierr = KSPDestroy(&kspPressure); CHKERRQ(ierr);}
+
+  return 0;
+}
+
+/**
+ * \brief The streamfunction system is non-singular: no null space is set.
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::setNullSpace()
+{
+  return 0;
+}
+
+/**
+ * \brief Recovers the pressure at the save points and when the probes are
+ *        sampled, then writes the data and the forces.
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::writeData()
+{
+  PetscErrorCode ierr;
+  PetscInt       statisticsStart = NavierStokesSolver<dim>::simParams->statisticsStart;
+
+  // the pressure has already been recovered if the time step was added to the statistics
+  PetscBool sampled = (statisticsStart >= 0 && NavierStokesSolver<dim>::timeStep-1 >= statisticsStart)? PETSC_TRUE : PETSC_FALSE;
+  if((NavierStokesSolver<dim>::savePoint() || NavierStokesSolver<dim>::probeStep()) && !sampled)
+  {
+    ierr = recoverPressure(); CHKERRQ(ierr);
+  }
+  ierr = TairaColoniusSolver<dim>::writeData(); CHKERRQ(ierr);
+
+  return 0;
+}
+
+/**
+ * \brief Recovers the pressure of the time step (not computed by the
+ *        streamfunction formulation), then adds the flow to the statistics.
+ */
+template <PetscInt dim>
+PetscErrorCode NullSpaceSolver<dim>::updateStatistics()
+{
+  PetscErrorCode ierr;
+
+  if(NavierStokesSolver<dim>::statisticsStep())
+  {
+    ierr = recoverPressure(); CHKERRQ(ierr);
+  }
+  ierr = NavierStokesSolver<dim>::updateStatistics(); CHKERRQ(ierr);
+
+  return 0;
+}
+
+#include "NullSpace/generateQTBNQ.inl"
+#include "NullSpace/createKSPs.inl"
+#include "NullSpace/generateCurl.inl"
+#include "NullSpace/generateForceSystem.inl"
+#include "NullSpace/generateParticularFlux.inl"
+#include "NullSpace/solvePoissonSystem.inl"
+
+template class NullSpaceSolver<2>;
+template class NullSpaceSolver<3>;
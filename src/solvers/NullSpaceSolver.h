@@ -0,0 +1,93 @@
+/***************************************************************************//**
+ * \file NullSpaceSolver.h
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Definition of the class \c NullSpaceSolver.
+ */
+
+
+#if !defined(NULL_SPACE_SOLVER_H)
+#define NULL_SPACE_SOLVER_H
+
+#include "TairaColoniusSolver.h"
+
+
+/**
+ * \class NullSpaceSolver
+ * \brief Solves the two-dimensional Navier-Stokes equations with the discrete
+ *        streamfunction (null-space) formulation of the immersed boundary
+ *        projection method (Colonius and Taira, 2008).
+ *
+ * The divergence-free fluxes are written \f$ q = q_p + C s \f$, where the
+ * columns of the discrete curl \f$ C \f$ span the null space of the
+ * divergence operator, \f$ s \f$ is the streamfunction at the interior nodes
+ * of the grid and \f$ q_p \f$ carries the fluxes through the boundaries of
+ * the domain. The pressure is eliminated: each time step requires one solve
+ * with \f$ C^T (B^N)^{-1} C \f$ and one solve with the small matrix of the
+ * body forces, which is factored once (Cholesky). The bodies, the discrete
+ * delta functions and the outputs are those of \c TairaColoniusSolver; the
+ * pressure is only recovered when the data are saved.
+ *
+ * Only available for stationary bodies in non-periodic domains.
+ */
+template <PetscInt dim>
+class NullSpaceSolver : public TairaColoniusSolver<dim>
+{
+public:
+  // streamfunction at the interior nodes
+  DM  sda;
+  Vec sMapping;
+  Vec s, sRHS;
+
+  // fluxes from the boundary values of the streamfunction
+  // and work vector distributed like the fluxes
+  Vec qParticular, qTemp;
+
+  // discrete curl, its transpose and C^T (B^N)^{-1} C
+  Mat C, CT, K;
+  // K^{-1} C^T E^T (dense, distributed like the streamfunction)
+  Mat streamfunctionCorrection;
+
+  // solver for the pressure, used when the data are saved
+  KSP kspPressure;
+
+  PetscErrorCode generateQTBNQ();
+  PetscErrorCode createKSPs();
+  PetscErrorCode setNullSpace();
+  PetscErrorCode generateCurl();
+  PetscErrorCode generateForceSystem();
+  PetscErrorCode generateParticularFlux();
+  PetscErrorCode solvePoissonSystem();
+  PetscErrorCode projectionStep();
+  PetscErrorCode recoverPressure();
+  PetscErrorCode updateStatistics();
+
+public:
+  PetscErrorCode initialize();
+  PetscErrorCode finalize();
+  PetscErrorCode writeData();
+
+  NullSpaceSolver(std::string folder, FlowDescription *FD, SimulationParameters *SP, CartesianMesh *CM) : TairaColoniusSolver<dim>::TairaColoniusSolver(folder, FD, SP, CM)
+  {
+    sda = PETSC_NULL;
+    sMapping = PETSC_NULL;
+    s    = PETSC_NULL;
+    sRHS = PETSC_NULL;
+    qParticular = PETSC_NULL;
+    qTemp = PETSC_NULL;
+    C  = PETSC_NULL;
+    CT = PETSC_NULL;
+    K  = PETSC_NULL;
+    streamfunctionCorrection = PETSC_NULL;
+    kspPressure = PETSC_NULL;
+    // Q^T B^N Q is not built: only its pressure rows are used, to recover the pressure
+    TairaColoniusSolver<dim>::scaleForces = PETSC_FALSE;
+  }
+
+  // name of the solver
+  virtual std::string name()
+  {
+    return "Null-space";
+  }
+};
+
+#endif
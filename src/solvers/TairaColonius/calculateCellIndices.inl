@@ -1,74 +1,90 @@
+/**
+ * \brief Returns the index of the cell containing the coordinate \c x.
+ *
+ * The nodes are sorted, so the cell is found by bisection. The index is
+ * clipped to the range of cells for points lying outside the domain.
+ *
+ * \param nodes coordinates of the nodes of the mesh along one direction
+ * \param x coordinate of the point
+ */
+inline PetscInt findCell(const std::vector<PetscReal> &nodes, PetscReal x)
+{
+	PetscInt idx = std::lower_bound(nodes.begin(), nodes.end(), x) - nodes.begin() - 1;
+	return std::max<PetscInt>(0, std::min<PetscInt>(idx, nodes.size()-2));
+}
+
+/**
+ * \brief Finds the indices of the cells that contain the body points.
+ *
+ * Each lookup is a binary search on the coordinates of the nodes, so the
+ * cost does not depend on the ordering of the points in the body file.
+ *
+ * Before the distributed arrays are created, the cells of all the points are
+ * needed by the body-weighted decomposition. Afterwards, only the points
+ * whose stencils can reach the cells owned by the process are looked up:
+ * those lying within the support of the delta function (plus one cell) of
+ * the local portion of the grid. With moving bodies, the region is widened
+ * by twice `stencilMargin`: the stencil of a point is laid out around its
+ * anchor cell, up to `stencilMargin` cells away from the point, so that the
+ * point stays in the region as long as its stencil is not laid out again.
+ * The points are stored in `nearbyPoints`, and the cell indices of the other
+ * points are set to -1.
+ */
 template <PetscInt dim>
 PetscErrorCode TairaColoniusSolver<dim>::calculateCellIndices()
 {
-	std::vector<PetscReal> &xMesh = NavierStokesSolver<dim>::mesh->x,
-	                       &yMesh = NavierStokesSolver<dim>::mesh->y,
-	                       &zMesh = NavierStokesSolver<dim>::mesh->z;
-
-	I.reserve(x.size());
-	J.reserve(x.size());
-	if(dim==3) K.reserve(x.size());
+	PetscErrorCode ierr;
+	PetscInt       start[3], numCells[3], lo, hi,
+	               width = (PetscInt)ceil(deltaFunctionSupport()) + ((movingBodies)? 2*stencilMargin : 0) + 1;
+	PetscReal      lower[3], upper[3];
+	PetscBool      nearby;
 
-	PetscInt i=0, j=0, k=0;
+	CartesianMesh *mesh = NavierStokesSolver<dim>::mesh;
+	std::vector<PetscReal> *nodes[3] = {&mesh->x, &mesh->y, &mesh->z},
+	                       *coords[3] = {&x, &y, &z};
+	std::vector<PetscInt>  *cells[3] = {&I, &J, &K};
 
-	/// find the cell for the zeroth point
-	while(xMesh[i+1] < x[0]) i++;
-	while(yMesh[j+1] < y[0]) j++;
-	if(dim==3)
+	nearbyPoints.clear();
+	if(NavierStokesSolver<dim>::pda == PETSC_NULL)
 	{
-		while(zMesh[k+1] < z[0]) k++;
+		nearbyPoints.reserve(x.size());
+		for(size_t l=0; l<x.size(); l++)
+			nearbyPoints.push_back(l);
 	}
-
-	I.push_back(i);
-	J.push_back(j);
-	if(dim==3) K.push_back(k);
-
-	for(size_t l=1; l<x.size(); l++)
+	else
 	{
-		// if the next boundary point is to the left of the current boundary point
-		if(x[l] < x[l-1])
-		{
-			while(xMesh[i] > x[l])
-				i--;
-		}
-		// if the next boundary point is to the right of the current boundary point
-		else
-		{
-			while(xMesh[i+1] < x[l])
-				i++;
-		}
-		// if the next boundary point is below the current boundary point
-		if(y[l] < y[l-1])
+		// coordinates of the region that can influence the cells of the process
+		// (unbounded on the sides of the domain)
+		ierr = DMDAGetCorners(NavierStokesSolver<dim>::pda, &start[0], &start[1], &start[2], &numCells[0], &numCells[1], &numCells[2]); CHKERRQ(ierr);
+		for(PetscInt d=0; d<dim; d++)
 		{
-			while(yMesh[j] > y[l])
-				j--;
+			lo = start[d] - width;
+			hi = start[d] + numCells[d] + width;
+			lower[d] = (lo > 0)? (*nodes[d])[lo] : -std::numeric_limits<PetscReal>::max();
+			upper[d] = (hi < (PetscInt)nodes[d]->size()-1)? (*nodes[d])[hi] : std::numeric_limits<PetscReal>::max();
 		}
-		// if the next boundary point is above the current boundary point
-		else
+		for(size_t l=0; l<x.size(); l++)
 		{
-			while(yMesh[j+1] < y[l])
-				j++;
-		}
-		if(dim==3)
-		{
-			// if the next boundary point is below the current boundary point
-			if(z[l] < z[l-1])
-			{
-				while(zMesh[k] > z[l])
-					k--;
-			}
-			// if the next boundary point is above the current boundary point
-			else
+			nearby = PETSC_TRUE;
+			for(PetscInt d=0; d<dim && nearby; d++)
 			{
-				while(zMesh[k+1] < z[l])
-					k++;
+				if((*coords[d])[l] < lower[d] || (*coords[d])[l] > upper[d])
+					nearby = PETSC_FALSE;
 			}
+			if(nearby)
+				nearbyPoints.push_back(l);
 		}
+	}
 
-		I.push_back(i);
-		J.push_back(j);
-		if(dim==3) K.push_back(k);
+	for(PetscInt d=0; d<dim; d++)
+	{
+		cells[d]->assign(x.size(), -1);
+		for(size_t n=0; n<nearbyPoints.size(); n++)
+		{
+			PetscInt l = nearbyPoints[n];
+			(*cells[d])[l] = findCell(*nodes[d], (*coords[d])[l]);
+		}
 	}
 
 	return 0;
-}
\ No newline at end of file
+}
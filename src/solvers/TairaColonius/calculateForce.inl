@@ -1,115 +1,87 @@
-template <>
-PetscErrorCode TairaColoniusSolver<2>::calculateForce()
+/**
+ * \brief Integrates the force and the moment acting on each body.
+ *
+ * The force is obtained directly from the Lagrangian values \f$ \tilde{f} \f$
+ * owned by the process, weighted by the quadrature weights computed with the
+ * regularization stencils. This avoids regularizing the force onto the whole
+ * velocity grid.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::calculateForce()
 {
 	PetscErrorCode ierr;
-	PetscInt       mstart, nstart, m, n;
-	Vec            fGlobal, fxGlobal, fyGlobal;
-	PetscReal      **fx, **fy, forceOnProcess[2];
+	Vec            fGlobal;
 
-	ierr = DMCompositeGetAccess(lambdaPack, lambda, NULL, &fGlobal); CHKERRQ(ierr);
-	ierr = MatMult(ET, fGlobal, regularizedForce);
-
-	ierr = DMCompositeGetAccess(qPack, regularizedForce, &fxGlobal, &fyGlobal); CHKERRQ(ierr);
-
-	// x-direction
-	ierr = DMDAVecGetArray(uda, fxGlobal, &fx); CHKERRQ(ierr);
-	ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
-	forceOnProcess[0] = 0;
-	for(PetscInt j=nstart; j<nstart+n; j++)
-	{
-		for(PetscInt i=mstart; i<mstart+m; i++)
-		{
-			forceOnProcess[0] += mesh->dy[j] * fx[j][i];
-		}
-	}
-	ierr = DMDAVecRestoreArray(uda, fxGlobal, &fx); CHKERRQ(ierr);
-
-	// y-direction
-	ierr = DMDAVecGetArray(vda, fyGlobal, &fy); CHKERRQ(ierr);
-	ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
-	forceOnProcess[1] = 0;
-	for(PetscInt j=nstart; j<nstart+n; j++)
-	{
-		for(PetscInt i=mstart; i<mstart+m; i++)
-		{
-			forceOnProcess[1] += mesh->dx[i] * fy[j][i];
-		}
-	}
-	ierr = DMDAVecRestoreArray(vda, fyGlobal, &fy); CHKERRQ(ierr);
-
-	ierr = DMCompositeRestoreAccess(qPack, regularizedForce, &fxGlobal, &fyGlobal); CHKERRQ(ierr);
-	ierr = DMCompositeRestoreAccess(lambdaPack, lambda, NULL, &fGlobal); CHKERRQ(ierr);
-
-	ierr = MPI_Reduce(forceOnProcess, force, 2, MPIU_REAL, MPI_SUM, 0, MPI_COMM_WORLD); CHKERRQ(ierr);
+	ierr = PetscLogEventBegin(eventCalculateForce, 0, 0, 0, 0); CHKERRQ(ierr);
+	ierr = DMCompositeGetAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::lambda, NULL, &fGlobal); CHKERRQ(ierr);
+	ierr = integrateForce(fGlobal, forceWeights, 1.0); CHKERRQ(ierr);
+	ierr = DMCompositeRestoreAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::lambda, NULL, &fGlobal); CHKERRQ(ierr);
+	ierr = PetscLogEventEnd(eventCalculateForce, 0, 0, 0, 0); CHKERRQ(ierr);
 
 	return 0;
 }
 
-template <>
-PetscErrorCode TairaColoniusSolver<3>::calculateForce()
+/**
+ * \brief Sums the Lagrangian forces into the force and the moment acting on
+ *        each body.
+ *
+ * The moments are taken about the point `centerRotation` of each body.
+ * The contributions of the local points are accumulated into one buffer
+ * segmented by body (forces of all bodies followed by their moments),
+ * which is summed over the processes with a single reduction.
+ *
+ * \param fGlobal Lagrangian values, distributed like the body points
+ * \param weights quadrature weight of each component of each body point
+ * \param scale factor applied to the weighted values
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::integrateForce(Vec fGlobal, const std::vector<PetscReal> &weights, PetscReal scale)
 {
 	PetscErrorCode ierr;
-	PetscInt       mstart, nstart, pstart, m, n, p;
-	Vec            fGlobal, fxGlobal, fyGlobal, fzGlobal;
-	PetscReal      ***fx, ***fy, ***fz, forceOnProcess[3];
+	PetscInt       rank, fStart, localIdx, b;
+	PetscInt       numMoments = (dim==2)? 1 : 3;
+	PetscReal      *f, F[3], r[3];
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
 
-	ierr = DMCompositeGetAccess(lambdaPack, lambda, NULL, &fGlobal); CHKERRQ(ierr);
-	ierr = MatMult(ET, fGlobal, regularizedForce);
+	std::vector<PetscReal> onProcess((dim+numMoments)*numBodies, 0.0),
+	                       reduced((dim+numMoments)*numBodies, 0.0);
+	PetscReal *forceOnProcess  = &onProcess[0],
+	          *momentOnProcess = &onProcess[dim*numBodies];
 
-	ierr = DMCompositeGetAccess(qPack, regularizedForce, &fxGlobal, &fyGlobal, &fzGlobal); CHKERRQ(ierr);
-	
-	// x-direction
-	ierr = DMDAVecGetArray(uda, fxGlobal, &fx); CHKERRQ(ierr);
-	ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
-	forceOnProcess[0] = 0;
-	for(PetscInt k=pstart; k<pstart+p; k++)
+	ierr = VecGetOwnershipRange(fGlobal, &fStart, NULL); CHKERRQ(ierr);
+	ierr = VecGetArray(fGlobal, &f); CHKERRQ(ierr);
+	for(auto l=boundaryPointIndices[rank].begin(); l!=boundaryPointIndices[rank].end(); l++)
 	{
-		for(PetscInt j=nstart; j<nstart+n; j++)
+		localIdx = forceIndexMapping[*l] - fStart;
+		b = bodyOfPoint[*l];
+		for(PetscInt d=0; d<dim; d++)
 		{
-			for(PetscInt i=mstart; i<mstart+m; i++)
-			{
-				forceOnProcess[0] += mesh->dy[j]*mesh->dz[k] * fx[k][j][i];
-			}
+			F[d] = scale * weights[dim*(*l)+d] * f[localIdx+d];
+			forceOnProcess[dim*b+d] += F[d];
 		}
-	}
-	ierr = DMDAVecRestoreArray(uda, fxGlobal, &fx); CHKERRQ(ierr);
-
-	// y-direction
-	ierr = DMDAVecGetArray(vda, fyGlobal, &fy); CHKERRQ(ierr);
-	ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
-	forceOnProcess[1] = 0;
-	for(PetscInt k=pstart; k<pstart+p; k++)
-	{
-		for(PetscInt j=nstart; j<nstart+n; j++)
+		r[0] = x[*l] - bodyCenters[dim*b];
+		r[1] = y[*l] - bodyCenters[dim*b+1];
+		if(dim==2)
 		{
-			for(PetscInt i=mstart; i<mstart+m; i++)
-			{
-				forceOnProcess[1] += mesh->dz[k]*mesh->dx[i] * fy[k][j][i];
-			}
+			momentOnProcess[b] += r[0]*F[1] - r[1]*F[0];
 		}
-	}
-	ierr = DMDAVecRestoreArray(vda, fyGlobal, &fy); CHKERRQ(ierr);
-
-	// z-direction
-	ierr = DMDAVecGetArray(wda, fzGlobal, &fz); CHKERRQ(ierr);
-	ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
-	forceOnProcess[2] = 0;
-	for(PetscInt k=pstart; k<pstart+p; k++)
-	{
-		for(PetscInt j=nstart; j<nstart+n; j++)
+		else
 		{
-			for(PetscInt i=mstart; i<mstart+m; i++)
-			{
-				forceOnProcess[2] += mesh->dx[i]*mesh->dy[j] * fz[k][j][i];
-			}
+			r[2] = z[*l] - bodyCenters[dim*b+2];
+			momentOnProcess[3*b]   += r[1]*F[2] - r[2]*F[1];
+			momentOnProcess[3*b+1] += r[2]*F[0] - r[0]*F[2];
+			momentOnProcess[3*b+2] += r[0]*F[1] - r[1]*F[0];
 		}
 	}
-	ierr = DMDAVecRestoreArray(wda, fzGlobal, &fz); CHKERRQ(ierr);
+	ierr = VecRestoreArray(fGlobal, &f); CHKERRQ(ierr);
+	// per point: weighted components, lever arm and moment
+	ierr = PetscLogFlops(boundaryPointIndices[rank].size()*((dim==2)? 12.0 : 24.0)); CHKERRQ(ierr);
 
-	ierr = DMCompositeRestoreAccess(qPack, regularizedForce, &fxGlobal, &fyGlobal, &fzGlobal); CHKERRQ(ierr);
-	ierr = DMCompositeRestoreAccess(lambdaPack, lambda, NULL, &fGlobal); CHKERRQ(ierr);
+	ierr = MPI_Reduce(&onProcess.front(), &reduced.front(), onProcess.size(), MPIU_REAL, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
 
-	ierr = MPI_Reduce(forceOnProcess, force, 3, MPIU_REAL, MPI_SUM, 0, MPI_COMM_WORLD); CHKERRQ(ierr);
+	forces.assign(reduced.begin(), reduced.begin()+dim*numBodies);
+	moments.assign(reduced.begin()+dim*numBodies, reduced.end());
 
 	return 0;
-}
\ No newline at end of file
+}
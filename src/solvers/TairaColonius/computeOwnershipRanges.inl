@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ * \file computeOwnershipRanges.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the method `computeOwnershipRanges` of \c TairaColoniusSolver.
+ */
+
+
+/**
+ * \brief Distributes the cells among the processes using a cost model that
+ *        accounts for the immersed boundary.
+ *
+ * Each cell costs 1, plus `bodyCostWeight` for every body point whose
+ * discrete delta function covers it. The cost is projected onto each
+ * direction and every direction is split into as many slabs as PETSc would
+ * use, such that all the slabs carry the same projected cost. The resulting
+ * ownership ranges are stored in `lx`, `ly` (and `lz`), and are used when
+ * the distributed arrays are created.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::computeOwnershipRanges()
+{
+	PetscErrorCode ierr;
+	DM             da;
+	PetscInt       numProcs[3] = {1, 1, 1},
+	               numCells[3];
+	PetscInt       window = (PetscInt)ceil(deltaFunctionSupport()),
+	               minCells = 2;
+	PetscReal      weight = NavierStokesSolver<dim>::simParams->bodyCostWeight,
+	               pointCost;
+
+	CartesianMesh *mesh = NavierStokesSolver<dim>::mesh;
+	std::vector<PetscInt> *cells[3] = {&I, &J, &K},
+	                      *ranges[3] = {&(NavierStokesSolver<dim>::lx), &(NavierStokesSolver<dim>::ly), &(NavierStokesSolver<dim>::lz)};
+
+	numCells[0] = mesh->nx;
+	numCells[1] = mesh->ny;
+	numCells[2] = (dim==3)? mesh->nz : 1;
+
+	// layout of the processes chosen by PETSc
+	if(dim==2)
+	{
+		ierr = DMDACreate2d(PETSC_COMM_WORLD, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_STAR, numCells[0], numCells[1], PETSC_DECIDE, PETSC_DECIDE, 1, 1, NULL, NULL, &da); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = DMDACreate3d(PETSC_COMM_WORLD, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_STAR, numCells[0], numCells[1], numCells[2], PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE, 1, 1, NULL, NULL, NULL, &da); CHKERRQ(ierr);
+	}
+	ierr = DMDAGetInfo(da, NULL, NULL, NULL, NULL, &numProcs[0], &numProcs[1], &numProcs[2], NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+	ierr = DMDestroy(&da); CHKERRQ(ierr);
+
+	// cost of a body point in a slab normal to a direction
+	pointCost = weight*pow(2*window+1, dim-1);
+
+	for(PetscInt d=0; d<dim; d++)
+	{
+		PetscInt N = numCells[d],
+		         P = numProcs[d];
+		if(N < minCells*P)
+		{
+			SETERRQ3(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "Direction %d has %d cells, too few to be split among %d processes", d, N, P);
+		}
+
+		// projected cost of each slab of cells
+		std::vector<PetscReal> cost(N, (PetscReal)(numCells[0]*numCells[1]*numCells[2]/N));
+		for(size_t l=0; l<x.size(); l++)
+		{
+			PetscInt lo = std::max<PetscInt>(0, (*cells[d])[l]-window),
+			         hi = std::min<PetscInt>(N-1, (*cells[d])[l]+window);
+			for(PetscInt i=lo; i<=hi; i++)
+				cost[i] += pointCost;
+		}
+
+		// cumulative cost
+		std::vector<PetscReal> cumulative(N+1, 0.0);
+		for(PetscInt i=0; i<N; i++)
+			cumulative[i+1] = cumulative[i] + cost[i];
+
+		// split into slabs of equal cost
+		ranges[d]->resize(P);
+		PetscInt start = 0, end;
+		for(PetscInt k=0; k<P; k++)
+		{
+			if(k==P-1)
+			{
+				end = N;
+			}
+			else
+			{
+				PetscReal target = cumulative[N]*(k+1)/P;
+				end = std::lower_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+				end = std::max(end, start+minCells);
+				end = std::min(end, N-minCells*(P-1-k));
+			}
+			(*ranges[d])[k] = end - start;
+			start = end;
+		}
+	}
+
+	return 0;
+}
@@ -3,18 +3,23 @@ PetscErrorCode TairaColoniusSolver<2>::createGlobalMappingBodies()
 {
 	PetscErrorCode ierr;
 	PetscInt       numProcs;
-	PetscInt       globalIndex;
+	PetscInt       globalIndex, forceIndex;
 
 	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
 
+	forceIndexMapping.resize(x.size());
+
 	globalIndex = 0;
+	forceIndex = 0;
 	for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
 	{
 		globalIndex += numPhiOnProcess[procIdx];
 		for(auto i=boundaryPointIndices[procIdx].begin(); i!=boundaryPointIndices[procIdx].end(); i++)
 		{
 			globalIndexMapping[*i] = globalIndex;
+			forceIndexMapping[*i] = forceIndex;
 			globalIndex+=2;
+			forceIndex+=2;
 		}
 	}
 
@@ -26,18 +31,23 @@ PetscErrorCode TairaColoniusSolver<3>::createGlobalMappingBodies()
 {
 	PetscErrorCode ierr;
 	PetscInt       numProcs;
-	PetscInt       globalIndex;
+	PetscInt       globalIndex, forceIndex;
 
 	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
 
+	forceIndexMapping.resize(x.size());
+
 	globalIndex = 0;
+	forceIndex = 0;
 	for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
 	{
 		globalIndex += numPhiOnProcess[procIdx];
 		for(auto i=boundaryPointIndices[procIdx].begin(); i!=boundaryPointIndices[procIdx].end(); i++)
 		{
 			globalIndexMapping[*i] = globalIndex;
+			forceIndexMapping[*i] = forceIndex;
 			globalIndex+=3;
+			forceIndex+=3;
 		}
 	}
 
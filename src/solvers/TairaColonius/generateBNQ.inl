@@ -1,8 +1,13 @@
+/**
+ * \brief Assembles the matrices \f$ B^N Q \f$ and \f$ E^T \f$.
+ *
+ * The entries of the regularization operator are taken from the weights
+ * of the discrete delta function computed by `generateStencils`.
+ */
 template <>
 PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
 {
 	PetscErrorCode ierr;
-	PetscInt       numProcs;
 	PetscInt       mstart, nstart, m, n;
 	PetscInt       *BNQ_d_nnz, *BNQ_o_nnz;
 	PetscInt       *ET_d_nnz, *ET_o_nnz;
@@ -11,17 +16,12 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
 	PetscInt       fStart, fEnd, fLocalSize;
 	PetscInt       localIdx;
 	PetscReal      **pGlobalIdx;
-	PetscInt       row, cols[2], BNQ_col, ET_col, value;
+	PetscInt       row, cols[2], BNQ_col, ET_col;
 	PetscReal      values[2] = {-1.0, 1.0};
-	PetscReal      disp[2];
-	PetscReal      xCoord, yCoord, h;
 	Vec            fGlobal;
-	PetscLogEvent  GENERATE_BNQ;
 	
-	ierr = PetscLogEventRegister("generateBNQ", 0, &GENERATE_BNQ); CHKERRQ(ierr);
-	ierr = PetscLogEventBegin(GENERATE_BNQ, 0, 0, 0, 0); CHKERRQ(ierr);
-	
-	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
+	// weights of the discrete delta function
+	ierr = generateStencils(); CHKERRQ(ierr);
 	
 	// ownership range of q
 	ierr = VecGetOwnershipRange(q, &qStart, &qEnd); CHKERRQ(ierr);
@@ -55,36 +55,14 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
 	ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
 	for(PetscInt j=nstart; j<nstart+n; j++)
 	{
-		yCoord = 0.5*(mesh->y[j] + mesh->y[j+1]);
 		for(PetscInt i=mstart; i<mstart+m; i++)
 		{
-			h = mesh->dx[i];
-			xCoord = mesh->x[i+1];
 			// G portion
 			cols[0] = pGlobalIdx[j][i];
 			cols[1] = pGlobalIdx[j][i+1];
 			countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, BNQ_d_nnz[localIdx], BNQ_o_nnz[localIdx]);
-			// ET portion
 			ET_d_nnz[localIdx] = 0;
 			ET_o_nnz[localIdx] = 0;
-			PetscInt numPhi = 0;
-			for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-			{
-				numPhi += numPhiOnProcess[procIdx];
-				for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-				{
-					if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2)
-					{
-						if(isInfluenced(xCoord, yCoord, x[*l], y[*l], 1.5*h, disp))
-						{
-							BNQ_col = globalIndexMapping[*l];
-							(BNQ_col>=lambdaStart && BNQ_col<lambdaEnd)? BNQ_d_nnz[localIdx]++ : BNQ_o_nnz[localIdx]++;
-							ET_col = globalIndexMapping[*l] - numPhi;
-							(ET_col>=fStart && ET_col<fEnd)? ET_d_nnz[localIdx]++ : ET_o_nnz[localIdx]++;
-						}
-					}
-				}
-			}
 			localIdx++;
 		}
 	}
@@ -92,39 +70,26 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
 	ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
 	for(PetscInt j=nstart; j<nstart+n; j++)
 	{
-		h = mesh->dy[j];
-		yCoord = mesh->y[j+1];
 		for(PetscInt i=mstart; i<mstart+m; i++)
 		{
-			xCoord = 0.5*(mesh->x[i] + mesh->x[i+1]);
 			// G portion
 			cols[0] = pGlobalIdx[j][i];
 			cols[1] = pGlobalIdx[j+1][i];
 			countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, BNQ_d_nnz[localIdx], BNQ_o_nnz[localIdx]);
-			// ET portion
 			ET_d_nnz[localIdx] = 0;
 			ET_o_nnz[localIdx] = 0;
-			PetscInt numPhi = 0;
-			for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-			{
-				numPhi += numPhiOnProcess[procIdx];
-				for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-				{
-					if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2)
-					{
-						if(isInfluenced(xCoord, yCoord, x[*l], y[*l], 1.5*h, disp))
-						{
-							BNQ_col = globalIndexMapping[*l]+1;
-							(BNQ_col>=lambdaStart && BNQ_col<lambdaEnd)? BNQ_d_nnz[localIdx]++ : BNQ_o_nnz[localIdx]++;
-							ET_col = globalIndexMapping[*l] - numPhi + 1;
-							(ET_col>=fStart && ET_col<fEnd)? ET_d_nnz[localIdx]++ : ET_o_nnz[localIdx]++;
-						}
-					}
-				}
-			}
 			localIdx++;
 		}
 	}
+	// ET portion
+	for(size_t e=0; e<stencilRows.size(); e++)
+	{
+		localIdx = stencilRows[e] - qStart;
+		BNQ_col = globalIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		(BNQ_col>=lambdaStart && BNQ_col<lambdaEnd)? BNQ_d_nnz[localIdx]++ : BNQ_o_nnz[localIdx]++;
+		ET_col = forceIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		(ET_col>=fStart && ET_col<fEnd)? ET_d_nnz[localIdx]++ : ET_o_nnz[localIdx]++;
+	}
 	
 	// allocate memory for the matrices
 	// BNQ
@@ -154,36 +119,13 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
 	ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
 	for(PetscInt j=nstart; j<nstart+n; j++)
 	{
-		yCoord = 0.5*(mesh->y[j] + mesh->y[j+1]);
 		for(PetscInt i=mstart; i<mstart+m; i++)
 		{
-			h = mesh->dx[i];
-			xCoord = mesh->x[i+1];
 			row = localIdx + qStart;
 			// G portion
 			cols[0] = pGlobalIdx[j][i];
 			cols[1] = pGlobalIdx[j][i+1];
 			ierr = MatSetValues(BNQ, 1, &row, 2, cols, values, INSERT_VALUES); CHKERRQ(ierr);
-			// ET portion
-			PetscInt numPhi = 0;
-			for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-			{
-				numPhi += numPhiOnProcess[procIdx];
-				for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-				{
-					if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2)
-					{
-						if(isInfluenced(xCoord, yCoord, x[*l], y[*l], 1.5*h, disp))
-						{
-							BNQ_col  = globalIndexMapping[*l];
-							value= h*delta(disp[0], disp[1], h);
-							ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
-							ET_col  = globalIndexMapping[*l] - numPhi;
-							ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
-						}
-					}
-				}
-			}
 			localIdx++;
 		}
 	}
@@ -191,40 +133,25 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
 	ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
 	for(PetscInt j=nstart; j<nstart+n; j++)
 	{
-		h = mesh->dy[j];
-		yCoord = mesh->y[j+1];
 		for(PetscInt i=mstart; i<mstart+m; i++)
 		{
-			xCoord = 0.5*(mesh->x[i] + mesh->x[i+1]);
 			row = localIdx + qStart;
 			// G portion
 			cols[0] = pGlobalIdx[j][i];
 			cols[1] = pGlobalIdx[j+1][i];
 			ierr = MatSetValues(BNQ, 1, &row, 2, cols, values, INSERT_VALUES); CHKERRQ(ierr);
-			// ET portion
-			PetscInt numPhi = 0;
-			for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-			{
-				numPhi += numPhiOnProcess[procIdx];
-				for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-				{
-					if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2)
-					{
-						if(isInfluenced(xCoord, yCoord, x[*l], y[*l], 1.5*h, disp))
-						{
-							BNQ_col = globalIndexMapping[*l] + 1;
-							value= h*delta(disp[0], disp[1], h);
-							ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
-							ET_col = globalIndexMapping[*l] - numPhi + 1;
-							ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
-						}
-					}
-				}
-			}
 			localIdx++;
 		}
 	}
 	ierr = DMDAVecRestoreArray(pda, pMapping, &pGlobalIdx); CHKERRQ(ierr);
+	// ET portion
+	for(size_t e=0; e<stencilRows.size(); e++)
+	{
+		BNQ_col = globalIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		ierr = MatSetValue(BNQ, stencilRows[e], BNQ_col, stencilWeights[e], INSERT_VALUES); CHKERRQ(ierr);
+		ET_col = forceIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		ierr = MatSetValue(ET, stencilRows[e], ET_col, stencilWeights[e], INSERT_VALUES); CHKERRQ(ierr);
+	}
 
 	// assemble the matrices
 	// BNQ
@@ -236,17 +163,20 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
 
 	ierr = MatTranspose(BNQ, MAT_INITIAL_MATRIX, &QT); CHKERRQ(ierr);
 	ierr = MatDiagonalScale(BNQ, BN, NULL); CHKERRQ(ierr);
-	
-	ierr = PetscLogEventEnd(GENERATE_BNQ, 0, 0, 0, 0); CHKERRQ(ierr);
 
 	return 0;
 }
 
+/**
+ * \brief Assembles the matrices \f$ B^N Q \f$ and \f$ E^T \f$.
+ *
+ * The entries of the regularization operator are taken from the weights
+ * of the discrete delta function computed by `generateStencils`.
+ */
 template <>
 PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 {
 	PetscErrorCode ierr;
-	PetscInt       numProcs;
 	PetscInt       mstart, nstart, pstart, m, n, p;
 	PetscInt       *BNQ_d_nnz, *BNQ_o_nnz;
 	PetscInt       *ET_d_nnz, *ET_o_nnz;
@@ -255,17 +185,12 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 	PetscInt       fStart, fEnd, fLocalSize;
 	PetscInt       localIdx;
 	PetscReal      ***pGlobalIdx;
-	PetscInt       row, cols[2], BNQ_col, ET_col, value;
+	PetscInt       row, cols[2], BNQ_col, ET_col;
 	PetscReal      values[2] = {-1.0, 1.0};
-	PetscReal      disp[3];
-	PetscReal      xCoord, yCoord, zCoord, h;
 	Vec            fGlobal;
-	PetscLogEvent  GENERATE_BNQ;
 	
-	ierr = PetscLogEventRegister("generateBNQ", 0, &GENERATE_BNQ); CHKERRQ(ierr);
-	ierr = PetscLogEventBegin(GENERATE_BNQ, 0, 0, 0, 0); CHKERRQ(ierr);
-	
-	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
+	// weights of the discrete delta function
+	ierr = generateStencils(); CHKERRQ(ierr);
 	
 	// ownership range of q
 	ierr = VecGetOwnershipRange(q, &qStart, &qEnd); CHKERRQ(ierr);
@@ -299,39 +224,16 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 	ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
 	for(PetscInt k=pstart; k<pstart+p; k++)
 	{
-		zCoord = 0.5*(mesh->z[k] + mesh->z[k+1]);
 		for(PetscInt j=nstart; j<nstart+n; j++)
 		{
-			yCoord = 0.5*(mesh->y[j] + mesh->y[j+1]);
 			for(PetscInt i=mstart; i<mstart+m; i++)
 			{
-				h = mesh->dx[i];
-				xCoord = mesh->x[i+1];
 				// G portion
 				cols[0] = pGlobalIdx[k][j][i];
 				cols[1] = pGlobalIdx[k][j][i+1];
 				countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, BNQ_d_nnz[localIdx], BNQ_o_nnz[localIdx]);
-				// ET portion
 				ET_d_nnz[localIdx] = 0;
 				ET_o_nnz[localIdx] = 0;
-				PetscInt numPhi = 0;
-				for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-				{
-					numPhi += numPhiOnProcess[procIdx];
-					for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-					{
-						if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2 && k>=K[*l]-2 && k<=K[*l]+2)
-						{
-							if(isInfluenced(xCoord, yCoord, zCoord, x[*l], y[*l], z[*l], 1.5*h, disp))
-							{
-								BNQ_col = globalIndexMapping[*l];
-								(BNQ_col>=lambdaStart && BNQ_col<lambdaEnd)? BNQ_d_nnz[localIdx]++ : BNQ_o_nnz[localIdx]++;
-								ET_col = globalIndexMapping[*l] - numPhi;
-								(ET_col>=fStart && ET_col<fEnd)? ET_d_nnz[localIdx]++ : ET_o_nnz[localIdx]++;
-							}
-						}
-					}
-				}
 				localIdx++;
 			}
 		}
@@ -340,39 +242,16 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 	ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
 	for(PetscInt k=pstart; k<pstart+p; k++)
 	{
-		zCoord = 0.5*(mesh->z[k] + mesh->z[k+1]);
 		for(PetscInt j=nstart; j<nstart+n; j++)
 		{
-			h = mesh->dy[j];
-			yCoord = mesh->y[j+1];
 			for(PetscInt i=mstart; i<mstart+m; i++)
 			{
-				xCoord = 0.5*(mesh->x[i] + mesh->x[i+1]);
 				// G portion
 				cols[0] = pGlobalIdx[k][j][i];
 				cols[1] = pGlobalIdx[k][j+1][i];
 				countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, BNQ_d_nnz[localIdx], BNQ_o_nnz[localIdx]);
-				// ET portion
 				ET_d_nnz[localIdx] = 0;
 				ET_o_nnz[localIdx] = 0;
-				PetscInt numPhi = 0;
-				for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-				{
-					numPhi += numPhiOnProcess[procIdx];
-					for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-					{
-						if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2 && k>=K[*l]-2 && k<=K[*l]+2)
-						{
-							if(isInfluenced(xCoord, yCoord, zCoord, x[*l], y[*l], z[*l], 1.5*h, disp))
-							{
-								BNQ_col = globalIndexMapping[*l] + 1;
-								(BNQ_col>=lambdaStart && BNQ_col<lambdaEnd)? BNQ_d_nnz[localIdx]++ : BNQ_o_nnz[localIdx]++;
-								ET_col = globalIndexMapping[*l] - numPhi + 1;
-								(ET_col>=fStart && ET_col<fEnd)? ET_d_nnz[localIdx]++ : ET_o_nnz[localIdx]++;
-							}
-						}
-					}
-				}
 				localIdx++;
 			}
 		}
@@ -381,43 +260,29 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 	ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
 	for(PetscInt k=pstart; k<pstart+p; k++)
 	{
-		h = mesh->dz[k];
-		zCoord = mesh->z[k+1];
 		for(PetscInt j=nstart; j<nstart+n; j++)
 		{
-			yCoord = 0.5*(mesh->y[j] + mesh->y[j+1]);
 			for(PetscInt i=mstart; i<mstart+m; i++)
 			{
-				xCoord = 0.5*(mesh->x[i] + mesh->x[i+1]);
 				// G portion
 				cols[0] = pGlobalIdx[k][j][i];
 				cols[1] = pGlobalIdx[k+1][j][i];
 				countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, BNQ_d_nnz[localIdx], BNQ_o_nnz[localIdx]);
-				// ET portion
 				ET_d_nnz[localIdx] = 0;
 				ET_o_nnz[localIdx] = 0;
-				PetscInt numPhi = 0;
-				for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-				{
-					numPhi += numPhiOnProcess[procIdx];
-					for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-					{
-						if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2 && k>=K[*l]-2 && k<=K[*l]+2)
-						{
-							if(isInfluenced(xCoord, yCoord, zCoord, x[*l], y[*l], z[*l], 1.5*h, disp))
-							{
-								BNQ_col = globalIndexMapping[*l] + 2;
-								(BNQ_col>=lambdaStart && BNQ_col<lambdaEnd)? BNQ_d_nnz[localIdx]++ : BNQ_o_nnz[localIdx]++;
-								ET_col = globalIndexMapping[*l] - numPhi + 2;
-								(ET_col>=fStart && ET_col<fEnd)? ET_d_nnz[localIdx]++ : ET_o_nnz[localIdx]++;
-							}
-						}
-					}
-				}
 				localIdx++;
 			}
 		}
 	}
+	// ET portion
+	for(size_t e=0; e<stencilRows.size(); e++)
+	{
+		localIdx = stencilRows[e] - qStart;
+		BNQ_col = globalIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		(BNQ_col>=lambdaStart && BNQ_col<lambdaEnd)? BNQ_d_nnz[localIdx]++ : BNQ_o_nnz[localIdx]++;
+		ET_col = forceIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		(ET_col>=fStart && ET_col<fEnd)? ET_d_nnz[localIdx]++ : ET_o_nnz[localIdx]++;
+	}
 	
 	// allocate memory for the matrices
 	// BNQ
@@ -447,39 +312,15 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 	ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
 	for(PetscInt k=pstart; k<pstart+p; k++)
 	{
-		zCoord = 0.5*(mesh->z[k] + mesh->z[k+1]);
 		for(PetscInt j=nstart; j<nstart+n; j++)
 		{
-			yCoord = 0.5*(mesh->y[j] + mesh->y[j+1]);
 			for(PetscInt i=mstart; i<mstart+m; i++)
 			{
-				h = mesh->dx[i];
-				xCoord = mesh->x[i+1];
 				row = localIdx + qStart;
 				// G portion
 				cols[0] = pGlobalIdx[k][j][i];
 				cols[1] = pGlobalIdx[k][j][i+1];
 				ierr = MatSetValues(BNQ, 1, &row, 2, cols, values, INSERT_VALUES); CHKERRQ(ierr);
-				// ET portion
-				PetscInt numPhi = 0;
-				for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-				{
-					numPhi += numPhiOnProcess[procIdx];
-					for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-					{
-						if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2 && k>=K[*l]-2 && k<=K[*l]+2)
-						{
-							if(isInfluenced(xCoord, yCoord, zCoord, x[*l], y[*l], z[*l], 1.5*h, disp))
-							{
-								BNQ_col  = globalIndexMapping[*l];
-								value= h*delta(disp[0], disp[1], disp[2], h);
-								ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
-								ET_col  = globalIndexMapping[*l] - numPhi;
-								ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
-							}
-						}
-					}
-				}
 				localIdx++;
 			}
 		}
@@ -488,39 +329,15 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 	ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
 	for(PetscInt k=pstart; k<pstart+p; k++)
 	{
-		zCoord = 0.5*(mesh->z[k] + mesh->z[k+1]);
 		for(PetscInt j=nstart; j<nstart+n; j++)
 		{
-			h = mesh->dy[j];
-			yCoord = mesh->y[j+1];
 			for(PetscInt i=mstart; i<mstart+m; i++)
 			{
-				xCoord = 0.5*(mesh->x[i] + mesh->x[i+1]);
 				row = localIdx + qStart;
 				// G portion
 				cols[0] = pGlobalIdx[k][j][i];
 				cols[1] = pGlobalIdx[k][j+1][i];
 				ierr = MatSetValues(BNQ, 1, &row, 2, cols, values, INSERT_VALUES); CHKERRQ(ierr);
-				// ET portion
-				PetscInt numPhi = 0;
-				for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-				{
-					numPhi += numPhiOnProcess[procIdx];
-					for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-					{
-						if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2 && k>=K[*l]-2 && k<=K[*l]+2)
-						{
-							if(isInfluenced(xCoord, yCoord, zCoord, x[*l], y[*l], z[*l], 1.5*h, disp))
-							{
-								BNQ_col  = globalIndexMapping[*l] + 1;
-								value= h*delta(disp[0], disp[1], disp[2], h);
-								ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
-								ET_col  = globalIndexMapping[*l] - numPhi + 1;
-								ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
-							}
-						}
-					}
-				}
 				localIdx++;
 			}
 		}
@@ -529,44 +346,28 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 	ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
 	for(PetscInt k=pstart; k<pstart+p; k++)
 	{
-		h = mesh->dz[k];
-		zCoord = mesh->z[k+1];
 		for(PetscInt j=nstart; j<nstart+n; j++)
 		{
-			yCoord = 0.5*(mesh->y[j] + mesh->y[j+1]);
 			for(PetscInt i=mstart; i<mstart+m; i++)
 			{
-				xCoord = 0.5*(mesh->x[i] + mesh->x[i+1]);
 				row = localIdx + qStart;
 				// G portion
 				cols[0] = pGlobalIdx[k][j][i];
 				cols[1] = pGlobalIdx[k+1][j][i];
 				ierr = MatSetValues(BNQ, 1, &row, 2, cols, values, INSERT_VALUES); CHKERRQ(ierr);
-				// ET portion
-				PetscInt numPhi = 0;
-				for(PetscInt procIdx=0; procIdx<numProcs; procIdx++)
-				{
-					numPhi += numPhiOnProcess[procIdx];
-					for(auto l=boundaryPointIndices[procIdx].begin(); l!=boundaryPointIndices[procIdx].end(); l++)
-					{
-						if(i>=I[*l]-2 && i<=I[*l]+2 && j>=J[*l]-2 && j<=J[*l]+2 && k>=K[*l]-2 && k<=K[*l]+2)
-						{
-							if(isInfluenced(xCoord, yCoord, zCoord, x[*l], y[*l], z[*l], 1.5*h, disp))
-							{
-								BNQ_col  = globalIndexMapping[*l] + 2;
-								value= h*delta(disp[0], disp[1], disp[2], h);
-								ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
-								ET_col  = globalIndexMapping[*l] - numPhi + 2;
-								ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
-							}
-						}
-					}
-				}
 				localIdx++;
 			}
 		}
 	}
 	ierr = DMDAVecRestoreArray(pda, pMapping, &pGlobalIdx); CHKERRQ(ierr);
+	// ET portion
+	for(size_t e=0; e<stencilRows.size(); e++)
+	{
+		BNQ_col = globalIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		ierr = MatSetValue(BNQ, stencilRows[e], BNQ_col, stencilWeights[e], INSERT_VALUES); CHKERRQ(ierr);
+		ET_col = forceIndexMapping[stencilPoints[e]] + stencilComponents[e];
+		ierr = MatSetValue(ET, stencilRows[e], ET_col, stencilWeights[e], INSERT_VALUES); CHKERRQ(ierr);
+	}
 
 	// assembles matrices
 	// BNQ
@@ -578,8 +379,6 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 
 	ierr = MatTranspose(BNQ, MAT_INITIAL_MATRIX, &QT); CHKERRQ(ierr);
 	ierr = MatDiagonalScale(BNQ, BN, NULL); CHKERRQ(ierr);
-	
-	ierr = PetscLogEventEnd(GENERATE_BNQ, 0, 0, 0, 0); CHKERRQ(ierr);
 
 	return 0;
-}
\ No newline at end of file
+}
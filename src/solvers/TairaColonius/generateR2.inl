@@ -58,6 +58,9 @@ PetscErrorCode TairaColoniusSolver<2>::generateR2()
 
 	ierr = DMCompositeRestoreAccess(lambdaPack, r2,  &bc2Global, NULL); CHKERRQ(ierr);
 
+	// velocity of the body points
+	ierr = addBodyVelocities(); CHKERRQ(ierr);
+
 	return 0;
 }
 
@@ -150,5 +153,8 @@ PetscErrorCode TairaColoniusSolver<3>::generateR2()
 
 	ierr = DMCompositeRestoreAccess(lambdaPack, r2,  &bc2Global, NULL); CHKERRQ(ierr);
 
+	// velocity of the body points
+	ierr = addBodyVelocities(); CHKERRQ(ierr);
+
 	return 0;
 }
\ No newline at end of file
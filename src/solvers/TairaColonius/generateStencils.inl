@@ -0,0 +1,196 @@
+/***************************************************************************//**
+ * \file generateStencils.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods `generateStencils` and
+ *        `computeStencilWeights` of \c TairaColoniusSolver.
+ */
+
+
+/**
+ * \brief Computes the weights of the discrete delta function between the body
+ *        points and the velocity nodes owned by the current process.
+ *
+ * The kernel is selected with the keyword `deltaFunction` of the file
+ * `simulationParameters.yaml` and is passed as a template parameter to
+ * `computeStencilWeights`, so that its evaluation is inlined. The weights are
+ * computed once and reused every time the regularization or interpolation
+ * operators are needed.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::generateStencils()
+{
+	switch(NavierStokesSolver<dim>::simParams->deltaFunction)
+	{
+		case PESKIN_4:
+			return computeStencilWeights<PeskinDelta4>();
+		case BSPLINE_6:
+			return computeStencilWeights<BSplineDelta6>();
+		case ROMA_ET_AL:
+		default:
+			return computeStencilWeights<RomaDelta>();
+	}
+}
+
+/**
+ * \brief Returns the half-width (in number of cells) of the discrete delta
+ *        function selected in the file `simulationParameters.yaml`.
+ */
+template <PetscInt dim>
+PetscReal TairaColoniusSolver<dim>::deltaFunctionSupport()
+{
+	switch(NavierStokesSolver<dim>::simParams->deltaFunction)
+	{
+		case PESKIN_4:
+			return PeskinDelta4::support();
+		case BSPLINE_6:
+			return BSplineDelta6::support();
+		case ROMA_ET_AL:
+		default:
+			return RomaDelta::support();
+	}
+}
+
+/**
+ * \brief Computes the weights of the discrete delta function \c Kernel.
+ *
+ * For each body point close to the portion of the grid owned by the process
+ * (see `calculateCellIndices`), only the velocity nodes located in a window
+ * of half-width the support of the kernel around the cell containing the
+ * point are visited. Each entry stores the global row of the velocity node,
+ * the index of the body point, the direction of the velocity component and
+ * the weight \f$ h \delta_h(\mathbf{x}-\mathbf{X}) \f$.
+ *
+ * The weights multiplied by the area of the faces are also summed for each
+ * body point, which gives the quadrature weights used by `calculateForce`
+ * to integrate the force directly from the Lagrangian values.
+ *
+ * The window of a point that belongs to a moving body is centered on its
+ * anchor cell and widened by `stencilMargin` cells, and the entries with a
+ * zero weight are kept. The layout of the stencils, and hence the non-zero
+ * structure of the operators, stays the same as long as the point does not
+ * move further than the margin from its anchor cell.
+ */
+template <PetscInt dim>
+template <typename Kernel>
+PetscErrorCode TairaColoniusSolver<dim>::computeStencilWeights()
+{
+	PetscErrorCode ierr;
+	PetscInt       qStart, offset, row;
+	PetscInt       start[3], numNodes[3], lo[3], hi[3], idx[3];
+	PetscInt       window = (PetscInt)ceil(Kernel::support()),
+	               halfWidth, center;
+	PetscReal      gridCoord[3], disp[3], h, weight, area;
+	PetscBool      influenced, moving;
+
+	CartesianMesh *mesh = NavierStokesSolver<dim>::mesh;
+	DM             da[3] = {NavierStokesSolver<dim>::uda, NavierStokesSolver<dim>::vda, NavierStokesSolver<dim>::wda};
+	std::vector<PetscReal> *nodes[3] = {&mesh->x, &mesh->y, &mesh->z},
+	                       *widths[3] = {&mesh->dx, &mesh->dy, &mesh->dz};
+	std::vector<PetscInt>  *cells[3] = {&I, &J, &K},
+	                       *anchors[3] = {&anchorI, &anchorJ, &anchorK};
+
+	// lay out the stencils of the moving points around their current cells
+	if(movingBodies && anchorI.empty())
+	{
+		anchorI = I;
+		anchorJ = J;
+		anchorK = K;
+	}
+
+	stencilRows.clear();
+	stencilPoints.clear();
+	stencilComponents.clear();
+	stencilWeights.clear();
+	forceWeights.assign(dim*x.size(), 0.0);
+
+	ierr = VecGetOwnershipRange(NavierStokesSolver<dim>::q, &qStart, NULL); CHKERRQ(ierr);
+
+	offset = 0;
+	for(PetscInt d=0; d<dim; d++)
+	{
+		ierr = DMDAGetCorners(da[d], &start[0], &start[1], &start[2], &numNodes[0], &numNodes[1], &numNodes[2]); CHKERRQ(ierr);
+		if(dim==2)
+		{
+			start[2] = 0;
+			numNodes[2] = 1;
+		}
+		for(size_t n=0; n<nearbyPoints.size(); n++)
+		{
+			PetscInt l = nearbyPoints[n];
+			moving = (movingBodies && bodyMotions[bodyOfPoint[l]].moving)? PETSC_TRUE : PETSC_FALSE;
+			halfWidth = (moving)? window+stencilMargin : window;
+			// a point that came close after the stencils were laid out
+			// was too far away to reach the cells of the process
+			if(moving && (*anchors[0])[l] < 0)
+				continue;
+			// window of velocity nodes that can be influenced by the body point
+			// intersected with the portion of the grid owned by the process
+			for(PetscInt c=0; c<3; c++)
+			{
+				if(c<dim)
+				{
+					center = (moving)? (*anchors[c])[l] : (*cells[c])[l];
+					lo[c] = std::max(start[c], center-halfWidth);
+					hi[c] = std::min(start[c]+numNodes[c]-1, center+halfWidth);
+				}
+				else
+				{
+					lo[c] = 0;
+					hi[c] = 0;
+				}
+			}
+			for(idx[2]=lo[2]; idx[2]<=hi[2]; idx[2]++)
+			{
+				for(idx[1]=lo[1]; idx[1]<=hi[1]; idx[1]++)
+				{
+					for(idx[0]=lo[0]; idx[0]<=hi[0]; idx[0]++)
+					{
+						// velocity nodes are located on the faces normal to the direction d
+						for(PetscInt c=0; c<dim; c++)
+						{
+							gridCoord[c] = (c==d)? (*nodes[c])[idx[c]+1] : 0.5*((*nodes[c])[idx[c]] + (*nodes[c])[idx[c]+1]);
+						}
+						h = (*widths[d])[idx[d]];
+						if(dim==2)
+						{
+							influenced = isInfluenced(gridCoord[0], gridCoord[1], x[l], y[l], Kernel::support()*h, disp);
+						}
+						else
+						{
+							influenced = isInfluenced(gridCoord[0], gridCoord[1], gridCoord[2], x[l], y[l], z[l], Kernel::support()*h, disp);
+						}
+						if(!influenced && !moving)
+							continue;
+						weight = 0.0;
+						if(influenced)
+						{
+							weight = h;
+							for(PetscInt c=0; c<dim; c++)
+							{
+								weight *= dh<Kernel>(disp[c], h);
+							}
+						}
+						row = qStart + offset + ((idx[2]-start[2])*numNodes[1] + (idx[1]-start[1]))*numNodes[0] + (idx[0]-start[0]);
+						stencilRows.push_back(row);
+						stencilPoints.push_back(l);
+						stencilComponents.push_back(d);
+						stencilWeights.push_back(weight);
+						// area of the face on which the velocity node lies
+						area = 1.0;
+						for(PetscInt c=0; c<dim; c++)
+						{
+							if(c!=d) area *= (*widths[c])[idx[c]];
+						}
+						forceWeights[dim*l+d] += weight*area;
+					}
+				}
+			}
+		}
+		offset += numNodes[0]*numNodes[1]*numNodes[2];
+	}
+
+	// the stencil of a body point can span several processes
+	ierr = MPI_Allreduce(MPI_IN_PLACE, &forceWeights.front(), dim*x.size(), MPIU_REAL, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	return 0;
+}
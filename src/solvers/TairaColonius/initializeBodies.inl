@@ -5,9 +5,47 @@
  */
 
 
+/**
+ * \brief Reads the prescribed motion of a body from its entry in `bodies.yaml`.
+ *
+ * Missing keys correspond to a body at rest.
+ */
+inline BodyMotion parseBodyMotion(const YAML::Node &node)
+{
+  BodyMotion motion;
+  const char *oscillations[3] = {"xOscillation", "yOscillation", "pitchOscillation"};
+  PetscReal  *values[3] = {motion.xOscillation, motion.yOscillation, motion.pitchOscillation};
+
+  motion.moving = PETSC_FALSE;
+  if (node["moving"])
+  {
+    for (size_t i=0; i<node["moving"].size(); i++)
+      if (node["moving"][i].as<bool>())
+        motion.moving = PETSC_TRUE;
+  }
+  for (size_t d=0; d<3; d++)
+    motion.velocity[d] = (node["velocity"] && d<node["velocity"].size())? node["velocity"][d].as<PetscReal>() : 0.0;
+  motion.omega = node["omega"].as<PetscReal>(0.0);
+  for (size_t i=0; i<3; i++)
+  {
+    for (size_t j=0; j<3; j++)
+      values[i][j] = (node[oscillations[i]] && j<node[oscillations[i]].size())? node[oscillations[i]][j].as<PetscReal>() : 0.0;
+  }
+
+  return motion;
+}
+
 /**
  * \brief Initializes the immersed boundaries by parsing the input file `bodies.yaml`.
  *
+ * Each entry of the file describes one body. The points of all the bodies
+ * are stored contiguously, body after body.
+ *
+ * With the key `pointSpacingRatio`, the points of a body are redistributed
+ * along the curve so that their spacing is that ratio times the local grid
+ * spacing. Bodies of type `points` are taken as closed curves unless
+ * `closed: false` is given.
+ *
  * Two-dimensional simulations.
  */
 template <>
@@ -23,71 +61,108 @@ PetscErrorCode TairaColoniusSolver<2>::initializeBodies()
   {
     std::string bodiesFile = caseFolder + "/bodies.yaml";
     YAML::Node nodes = YAML::LoadFile(bodiesFile);
-    const YAML::Node &node = nodes[0];
+    for (unsigned int b=0; b<nodes.size(); b++)
+    {
+      const YAML::Node &node = nodes[b];
+      PetscInt numPointsBefore = x.size();
 
-    std::string type = node["type"].as<std::string>();
+      std::string type = node["type"].as<std::string>();
 
-    if (type == "circle")
-    {
-      PetscReal xc = node["circleOptions"][0].as<PetscReal>();
-      PetscReal yc = node["circleOptions"][1].as<PetscReal>();
-      PetscReal R = node["circleOptions"][2].as<PetscReal>();
-      PetscInt numPoints = node["circleOptions"][3].as<PetscInt>();
-
-      x.reserve(numPoints);
-      y.reserve(numPoints);
-      for (PetscInt i=0; i<numPoints; i++)
+      if (type == "circle")
       {
-        x.push_back(xc + R*cos(2.0*PETSC_PI*i/numPoints));
-        y.push_back(yc + R*sin(2.0*PETSC_PI*i/numPoints));
+        PetscReal xc = node["circleOptions"][0].as<PetscReal>();
+        PetscReal yc = node["circleOptions"][1].as<PetscReal>();
+        PetscReal R = node["circleOptions"][2].as<PetscReal>();
+        PetscInt numPoints = node["circleOptions"][3].as<PetscInt>();
+
+        x.reserve(x.size()+numPoints);
+        y.reserve(y.size()+numPoints);
+        for (PetscInt i=0; i<numPoints; i++)
+        {
+          x.push_back(xc + R*cos(2.0*PETSC_PI*i/numPoints));
+          y.push_back(yc + R*sin(2.0*PETSC_PI*i/numPoints));
+        }
       }
-    }
-    else if (type == "points")
-    {
-      PetscInt numPoints;
-      PetscReal xCoord, yCoord;
-      std::string pointsFile = caseFolder + "/" + node["pointsFile"].as<std::string>();
-      std::cout << "Initiliazing body: reading coordinates from: " << pointsFile << std::endl;
-      std::ifstream infile(pointsFile.c_str());
-      infile >> numPoints;
-      x.reserve(numPoints);
-      y.reserve(numPoints);
-      for (PetscInt i=0; i<numPoints; i++)
+      else if (type == "points")
       {
-        infile >> xCoord >> yCoord;
-        x.push_back(xCoord);
-        y.push_back(yCoord);
+        PetscInt numPoints;
+        PetscReal xCoord, yCoord;
+        std::string pointsFile = caseFolder + "/" + node["pointsFile"].as<std::string>();
+        std::cout << "Initiliazing body: reading coordinates from: " << pointsFile << std::endl;
+        std::ifstream infile(pointsFile.c_str());
+        infile >> numPoints;
+        x.reserve(x.size()+numPoints);
+        y.reserve(y.size()+numPoints);
+        for (PetscInt i=0; i<numPoints; i++)
+        {
+          infile >> xCoord >> yCoord;
+          x.push_back(xCoord);
+          y.push_back(yCoord);
+        }
+        infile.close();
       }
-      infile.close();
-    }
-    else if (type == "lineSegment")
-    {
-      PetscReal startX = node["segmentOptions"][0].as<PetscReal>();
-      PetscReal startY = node["segmentOptions"][1].as<PetscReal>();
-      PetscReal endX = node["segmentOptions"][2].as<PetscReal>();
-      PetscReal endY = node["segmentOptions"][3].as<PetscReal>();
-      PetscInt numPoints = node["segmentOptions"][4].as<PetscInt>();
-      // initialize line segment
-      x.reserve(numPoints);
-      y.reserve(numPoints);
-      PetscReal xi;
-      for (PetscInt i=0; i<numPoints; i++)
+      else if (type == "lineSegment")
       {
-        xi = (i+0.5)/numPoints;
-        x.push_back((1-xi)*startX + xi*endX);
-        y.push_back((1-xi)*startY + xi*endY);
+        PetscReal startX = node["segmentOptions"][0].as<PetscReal>();
+        PetscReal startY = node["segmentOptions"][1].as<PetscReal>();
+        PetscReal endX = node["segmentOptions"][2].as<PetscReal>();
+        PetscReal endY = node["segmentOptions"][3].as<PetscReal>();
+        PetscInt numPoints = node["segmentOptions"][4].as<PetscInt>();
+        // initialize line segment
+        x.reserve(x.size()+numPoints);
+        y.reserve(y.size()+numPoints);
+        PetscReal xi;
+        for (PetscInt i=0; i<numPoints; i++)
+        {
+          xi = (i+0.5)/numPoints;
+          x.push_back((1-xi)*startX + xi*endX);
+          y.push_back((1-xi)*startY + xi*endY);
+        }
       }
+      else
+      {
+        std::cout << "\nERROR: Unknown type of body" << std::endl;
+        exit(0);
+      }
+      // redistribute the points to match the local grid spacing
+      if (node["pointSpacingRatio"])
+      {
+        PetscReal ratio = node["pointSpacingRatio"].as<PetscReal>();
+        PetscBool closed = PETSC_TRUE;
+        if (type == "lineSegment")
+          closed = PETSC_FALSE;
+        else if (type == "points")
+          closed = (node["closed"].as<bool>(true))? PETSC_TRUE : PETSC_FALSE;
+        size_t numPointsGiven = x.size() - numPointsBefore;
+        ierr = resampleCurve(numPointsBefore, ratio, closed); CHKERRQ(ierr);
+        if (type == "circle")
+        {
+          // bring the points back from the chords onto the circle
+          PetscReal xc = node["circleOptions"][0].as<PetscReal>();
+          PetscReal yc = node["circleOptions"][1].as<PetscReal>();
+          PetscReal R = node["circleOptions"][2].as<PetscReal>();
+          for (size_t i=numPointsBefore; i<x.size(); i++)
+          {
+            PetscReal r = sqrt((x[i]-xc)*(x[i]-xc) + (y[i]-yc)*(y[i]-yc));
+            x[i] = xc + R*(x[i]-xc)/r;
+            y[i] = yc + R*(y[i]-yc)/r;
+          }
+        }
+        std::cout << "Resampling body " << b << ": " << numPointsGiven << " -> " << x.size()-numPointsBefore << " points (spacing ratio " << ratio << ")" << std::endl;
+      }
+      numPointsInBody.push_back(x.size() - numPointsBefore);
+      // reference point of the moments
+      for (size_t d=0; d<2; d++)
+        bodyCenters.push_back((node["centerRotation"])? node["centerRotation"][d].as<PetscReal>() : 0.0);
+      bodyMotions.push_back(parseBodyMotion(node));
     }
-    else
-    {
-      std::cout << "\nERROR: Unknown type of body" << std::endl;
-      exit(0);
-    }
+    numBodies = nodes.size();
     totalPoints = x.size();
   }
 
   // broadcast total number of body points to all processes
   ierr = MPI_Bcast(&totalPoints, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Bcast(&numBodies, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
 
   ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
 
@@ -99,12 +174,38 @@ PetscErrorCode TairaColoniusSolver<2>::initializeBodies()
   ierr = MPI_Bcast(&x.front(), totalPoints, MPIU_REAL, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
   ierr = MPI_Bcast(&y.front(), totalPoints, MPIU_REAL, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
 
+  // broadcast the number of points and the reference point of each body
+  numPointsInBody.resize(numBodies);
+  bodyCenters.resize(2*numBodies);
+  ierr = MPI_Bcast(&numPointsInBody.front(), numBodies, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Bcast(&bodyCenters.front(), 2*numBodies, MPIU_REAL, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+  // index of the body to which each point belongs
+  bodyOfPoint.reserve(totalPoints);
+  for (PetscInt b=0; b<numBodies; b++)
+    bodyOfPoint.insert(bodyOfPoint.end(), numPointsInBody[b], b);
+
+  // broadcast the prescribed motions
+  bodyMotions.resize(numBodies);
+  ierr = MPI_Bcast(&bodyMotions.front(), numBodies*sizeof(BodyMotion), MPI_BYTE, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  for (PetscInt b=0; b<numBodies; b++)
+    if (bodyMotions[b].moving)
+      movingBodies = PETSC_TRUE;
+
   return 0;
 }
 
 /**
  * \brief Initializes the immersed boundaries by parsing the input file `bodies.yaml`.
  *
+ * Each entry of the file describes one body. The points of all the bodies
+ * are stored contiguously, body after body.
+ *
+ * With the key `pointSpacingRatio`, the number of points of a `quad` is
+ * chosen from the local grid spacing, and the points of a `points` body
+ * that are closer to each other than that ratio times the local grid
+ * spacing are removed (scattered points cannot be refined).
+ *
  * Three-dimensional simulations.
  */
 template <>
@@ -120,80 +221,125 @@ PetscErrorCode TairaColoniusSolver<3>::initializeBodies()
   {
     std::string bodiesFile = caseFolder + "/bodies.yaml";
     YAML::Node nodes = YAML::LoadFile(bodiesFile);
-    const YAML::Node &node = nodes[0];
-
-    std::string type = node["type"].as<std::string>();
-
-    if (type == "quad")
+    for (unsigned int b=0; b<nodes.size(); b++)
     {
-      PetscInt nXi = node["quadOptions"][0].as<PetscInt>(),
-               nEta = node["quadOptions"][0].as<PetscInt>();
-      PetscReal corners[4][3];
+      const YAML::Node &node = nodes[b];
+      PetscInt numPointsBefore = x.size();
 
-      x.reserve(nXi*nEta);
-      y.reserve(nXi*nEta);
-      z.reserve(nXi*nEta);
+      std::string type = node["type"].as<std::string>();
 
-      for (size_t d=0; d<3; d++)
+      if (type == "quad")
       {
-        corners[0][d] = node["bottomLeft"][d].as<PetscReal>();
-        corners[1][d] = node["bottomRight"][d].as<PetscReal>();
-        corners[2][d] = node["topRight"][d].as<PetscReal>();
-        corners[3][d] = node["topLeft"][d].as<PetscReal>();
+        PetscInt nXi = node["quadOptions"][0].as<PetscInt>(),
+                 nEta = node["quadOptions"][1].as<PetscInt>();
+        PetscReal corners[4][3];
+
+        for (size_t d=0; d<3; d++)
+        {
+          corners[0][d] = node["bottomLeft"][d].as<PetscReal>();
+          corners[1][d] = node["bottomRight"][d].as<PetscReal>();
+          corners[2][d] = node["topRight"][d].as<PetscReal>();
+          corners[3][d] = node["topLeft"][d].as<PetscReal>();
+        }
+
+        // number of points along each side from the local grid spacing
+        if (node["pointSpacingRatio"])
+        {
+          PetscReal ratio = node["pointSpacingRatio"].as<PetscReal>();
+          PetscReal center[3], xiSide[3], etaSide[3], xiLength = 0.0, etaLength = 0.0;
+          for (size_t d=0; d<3; d++)
+          {
+            center[d] = 0.25*(corners[0][d] + corners[1][d] + corners[2][d] + corners[3][d]);
+            xiSide[d] = 0.5*(corners[1][d] - corners[0][d] + corners[2][d] - corners[3][d]);
+            etaSide[d] = 0.5*(corners[3][d] - corners[0][d] + corners[2][d] - corners[1][d]);
+            xiLength += xiSide[d]*xiSide[d];
+            etaLength += etaSide[d]*etaSide[d];
+          }
+          xiLength = sqrt(xiLength);
+          etaLength = sqrt(etaLength);
+          for (size_t d=0; d<3; d++)
+          {
+            xiSide[d] /= xiLength;
+            etaSide[d] /= etaLength;
+          }
+          PetscInt numPointsGiven = nXi*nEta;
+          nXi = std::max<PetscInt>(1, floor(xiLength/(ratio*gridSpacing(center, xiSide))+0.5));
+          nEta = std::max<PetscInt>(1, floor(etaLength/(ratio*gridSpacing(center, etaSide))+0.5));
+          std::cout << "Resampling body " << b << ": " << numPointsGiven << " -> " << nXi*nEta << " points (spacing ratio " << ratio << ")" << std::endl;
+        }
+
+        x.reserve(x.size()+nXi*nEta);
+        y.reserve(y.size()+nXi*nEta);
+        z.reserve(z.size()+nXi*nEta);
+
+        PetscReal xi, eta;
+        for (PetscInt j=0; j<nEta; j++)
+        {
+          eta = (j+0.5)/nEta;
+          for (PetscInt i=0; i<nXi; i++)
+          {
+            xi = (i+0.5)/nXi;
+            x.push_back((1-xi)*(1-eta)*corners[0][0] 
+                        + xi*(1-eta)*corners[1][0] 
+                        + xi*eta*corners[2][0] 
+                        + (1-xi)*eta*corners[3][0]);
+            y.push_back((1-xi)*(1-eta)*corners[0][1] 
+                        + xi*(1-eta)*corners[1][1] 
+                        + xi*eta*corners[2][1] 
+                        + (1-xi)*eta*corners[3][1]);
+            z.push_back((1-xi)*(1-eta)*corners[0][2] 
+                        + xi*(1-eta)*corners[1][2] 
+                        + xi*eta*corners[2][2] 
+                        + (1-xi)*eta*corners[3][2]);
+          }
+        }
       }
-      
-      PetscReal xi, eta;
-      for (PetscInt j=0; j<nEta; j++)
+      else if (type == "points")
       {
-        eta = (j+0.5)/nEta;
-        for (PetscInt i=0; i<nXi; i++)
+        std::string pointsFile = caseFolder + "/" + node["pointsFile"].as<std::string>();
+        std::cout << "Initiliazing body: reading coordinates from: " << pointsFile << std::endl;
+        std::ifstream infile(pointsFile.c_str());
+        PetscInt numPoints;
+        PetscReal xCoord, yCoord, zCoord;
+        infile >> numPoints;
+        x.reserve(x.size()+numPoints);
+        y.reserve(y.size()+numPoints);
+        z.reserve(z.size()+numPoints);
+        for (PetscInt i=0; i<numPoints; i++)
         {
-          xi = (i+0.5)/nXi;
-          x.push_back((1-xi)*(1-eta)*corners[0][0] 
-                      + xi*(1-eta)*corners[1][0] 
-                      + xi*eta*corners[2][0] 
-                      + (1-xi)*eta*corners[3][0]);
-          y.push_back((1-xi)*(1-eta)*corners[0][1] 
-                      + xi*(1-eta)*corners[1][1] 
-                      + xi*eta*corners[2][1] 
-                      + (1-xi)*eta*corners[3][1]);
-          z.push_back((1-xi)*(1-eta)*corners[0][2] 
-                      + xi*(1-eta)*corners[1][2] 
-                      + xi*eta*corners[2][2] 
-                      + (1-xi)*eta*corners[3][2]);
+          infile >> xCoord >> yCoord >> zCoord;
+          x.push_back(xCoord);
+          y.push_back(yCoord);
+          z.push_back(zCoord);
         }
+        infile.close();
       }
-    }
-    else if (type == "points")
-    {
-      std::string pointsFile = caseFolder + "/" + node["pointsFile"].as<std::string>();
-      std::cout << "Initiliazing body: reading coordinates from: " << pointsFile << std::endl;
-      std::ifstream infile(pointsFile.c_str());
-      PetscInt numPoints;
-      PetscReal xCoord, yCoord, zCoord;
-      infile >> numPoints;
-      x.reserve(numPoints);
-      y.reserve(numPoints);
-      z.reserve(numPoints);
-      for (PetscInt i=0; i<numPoints; i++)
+      else
       {
-        infile >> xCoord >> yCoord >> zCoord;
-        x.push_back(xCoord);
-        y.push_back(yCoord);
-        z.push_back(zCoord);
+        std::cout << "\nERROR: Unknown type of body" << std::endl;
+        exit(0);
       }
-      infile.close();
-    }
-    else
-    {
-      std::cout << "\nERROR: Unknown type of body" << std::endl;
-      exit(0);
+      // thin the scattered points that are too close to each other
+      if (type == "points" && node["pointSpacingRatio"])
+      {
+        PetscReal ratio = node["pointSpacingRatio"].as<PetscReal>();
+        size_t numPointsGiven = x.size() - numPointsBefore;
+        thinPoints(numPointsBefore, ratio);
+        std::cout << "Resampling body " << b << ": " << numPointsGiven << " -> " << x.size()-numPointsBefore << " points (spacing ratio " << ratio << ")" << std::endl;
+      }
+      numPointsInBody.push_back(x.size() - numPointsBefore);
+      // reference point of the moments
+      for (size_t d=0; d<3; d++)
+        bodyCenters.push_back((node["centerRotation"])? node["centerRotation"][d].as<PetscReal>() : 0.0);
+      bodyMotions.push_back(parseBodyMotion(node));
     }
+    numBodies = nodes.size();
     totalPoints = x.size();
   }
 
   // broadcast total number of body points to all processes
   ierr = MPI_Bcast(&totalPoints, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Bcast(&numBodies, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
 
   ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
 
@@ -207,5 +353,23 @@ PetscErrorCode TairaColoniusSolver<3>::initializeBodies()
   ierr = MPI_Bcast(&y.front(), totalPoints, MPIU_REAL, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
   ierr = MPI_Bcast(&z.front(), totalPoints, MPIU_REAL, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
 
+  // broadcast the number of points and the reference point of each body
+  numPointsInBody.resize(numBodies);
+  bodyCenters.resize(3*numBodies);
+  ierr = MPI_Bcast(&numPointsInBody.front(), numBodies, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Bcast(&bodyCenters.front(), 3*numBodies, MPIU_REAL, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+  // index of the body to which each point belongs
+  bodyOfPoint.reserve(totalPoints);
+  for (PetscInt b=0; b<numBodies; b++)
+    bodyOfPoint.insert(bodyOfPoint.end(), numPointsInBody[b], b);
+
+  // broadcast the prescribed motions
+  bodyMotions.resize(numBodies);
+  ierr = MPI_Bcast(&bodyMotions.front(), numBodies*sizeof(BodyMotion), MPI_BYTE, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  for (PetscInt b=0; b<numBodies; b++)
+    if (bodyMotions[b].moving)
+      movingBodies = PETSC_TRUE;
+
   return 0;
 }
\ No newline at end of file
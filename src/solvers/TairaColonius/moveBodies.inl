@@ -0,0 +1,265 @@
+/***************************************************************************//**
+ * \file moveBodies.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c TairaColoniusSolver
+ *        that handle the prescribed motion of the bodies.
+ */
+
+
+/**
+ * \brief Moves the bodies to their position at a given time, and computes
+ *        the velocity of each body point.
+ *
+ * The motion of each body is described by a \c BodyMotion. The points of the
+ * bodies at rest are not modified.
+ *
+ * \param time time at which the position of the bodies is computed
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::moveBodies(PetscReal time)
+{
+	PetscReal center[3], centerVelocity[3], r[3];
+	PetscReal theta, thetaDot;
+
+	bodyVelocities.assign(dim*x.size(), 0.0);
+
+	for(size_t l=0; l<x.size(); l++)
+	{
+		PetscInt b = bodyOfPoint[l];
+		const BodyMotion &motion = bodyMotions[b];
+		if(!motion.moving)
+			continue;
+
+		const PetscReal *oscillation[2] = {motion.xOscillation, motion.yOscillation};
+		for(PetscInt d=0; d<dim; d++)
+		{
+			center[d] = bodyCenters0[dim*b+d] + motion.velocity[d]*time;
+			centerVelocity[d] = motion.velocity[d];
+			if(d<2)
+			{
+				center[d] += oscillation[d][0]*sin(oscillation[d][1]*time + oscillation[d][2]);
+				centerVelocity[d] += oscillation[d][0]*oscillation[d][1]*cos(oscillation[d][1]*time + oscillation[d][2]);
+			}
+			bodyCenters[dim*b+d] = center[d];
+		}
+		theta = motion.omega*time + motion.pitchOscillation[0]*sin(motion.pitchOscillation[1]*time + motion.pitchOscillation[2]);
+		thetaDot = motion.omega + motion.pitchOscillation[0]*motion.pitchOscillation[1]*cos(motion.pitchOscillation[1]*time + motion.pitchOscillation[2]);
+
+		// rotation about the z-axis through the reference point
+		r[0] = cos(theta)*(x0[l]-bodyCenters0[dim*b]) - sin(theta)*(y0[l]-bodyCenters0[dim*b+1]);
+		r[1] = sin(theta)*(x0[l]-bodyCenters0[dim*b]) + cos(theta)*(y0[l]-bodyCenters0[dim*b+1]);
+		x[l] = center[0] + r[0];
+		y[l] = center[1] + r[1];
+		bodyVelocities[dim*l]   = centerVelocity[0] - thetaDot*r[1];
+		bodyVelocities[dim*l+1] = centerVelocity[1] + thetaDot*r[0];
+		if(dim==3)
+		{
+			z[l] = center[2] + (z0[l]-bodyCenters0[dim*b+2]);
+			bodyVelocities[dim*l+2] = centerVelocity[2];
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Moves the bodies to their position at the next time step and
+ *        updates the operators that depend on it.
+ *
+ * Called at the beginning of every time step. Nothing is done if all the
+ * bodies are at rest. The time spent in each part of the update is written
+ * into the file `bodyUpdate.txt`. In case of a rebuild, the time spent in
+ * \c generateBNQ is reported under the stencils.
+ *
+ * The process that owns a body point (and its rows of the force vector) is
+ * the one chosen from the initial position of the point, and is not
+ * reassigned as the body moves. A point that travels into the subdomain of
+ * another process stays owned by its original process: the results are the
+ * same, but more entries of \f$ B^N Q \f$ and \f$ E^T \f$ are off-process.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::updateImmersedBoundary()
+{
+	PetscErrorCode ierr;
+	PetscInt       rank;
+	PetscBool      rebuilt;
+	PetscLogDouble t0, t1, timings[3];
+
+	if(!movingBodies)
+		return 0;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+	ierr = moveBodies((NavierStokesSolver<dim>::timeStep+1)*NavierStokesSolver<dim>::simParams->dt); CHKERRQ(ierr);
+	ierr = calculateCellIndices(); CHKERRQ(ierr);
+	ierr = PetscTime(&t1); CHKERRQ(ierr);
+
+	ierr = updateOperators(&rebuilt, timings); CHKERRQ(ierr);
+
+	if(rank==0)
+	{
+		// the file is created at the first time step, and appended to after a restart
+		if(!bodyUpdateFile.is_open())
+		{
+			std::string filename = NavierStokesSolver<dim>::caseFolder + "/bodyUpdate.txt";
+			if(NavierStokesSolver<dim>::simParams->restart)
+			{
+				bodyUpdateFile.open(filename.c_str(), std::ios::out | std::ios::app);
+			}
+			else
+			{
+				bodyUpdateFile.open(filename.c_str());
+				bodyUpdateFile << "# time-step\trebuilt\tmove\tstencils\tBNQ/ET\tQTBNQ\n";
+			}
+		}
+		bodyUpdateFile << NavierStokesSolver<dim>::timeStep+1 << '\t' << rebuilt << '\t' << t1-t0;
+		for(PetscInt i=0; i<3; i++)
+			bodyUpdateFile << '\t' << timings[i];
+		bodyUpdateFile << std::endl;
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Updates the matrices \f$ B^N Q \f$, \f$ Q^T \f$, \f$ E^T \f$ and
+ *        \f$ Q^T B^N Q \f$ after the bodies have moved.
+ *
+ * As long as every moving point stays within `stencilMargin` cells of the
+ * cell around which its stencil was laid out, the non-zero structure of the
+ * operators does not change: only the entries coupling the velocity nodes
+ * to the moving points are recomputed and inserted, and the product
+ * \f$ Q^T B^N Q \f$ is recomputed numerically, reusing its symbolic
+ * structure. Otherwise, the stencils are laid out again and the operators
+ * are rebuilt from scratch.
+ *
+ * \param rebuilt set to \c PETSC_TRUE if the operators have been rebuilt
+ * \param timings time spent computing the stencils, updating \f$ B^N Q \f$
+ *                and \f$ E^T \f$, and updating \f$ Q^T B^N Q \f$
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::updateOperators(PetscBool *rebuilt, PetscLogDouble *timings)
+{
+	PetscErrorCode ierr;
+	PetscInt       qStart, row, col;
+	PetscBool      rebuild = PETSC_FALSE;
+	PetscReal      *BN;
+	PetscLogDouble t0, t1, t2, t3;
+
+	std::vector<PetscInt> *cells[3] = {&I, &J, &K},
+	                      *anchors[3] = {&anchorI, &anchorJ, &anchorK};
+
+	// have the moving points left the region covered by their stencils?
+	// (each point is checked by the processes it was close to when the
+	// stencils were laid out, and every process takes the same decision)
+	PetscInt leftStencil = 0;
+	for(size_t n=0; n<nearbyPoints.size() && !leftStencil; n++)
+	{
+		PetscInt l = nearbyPoints[n];
+		if(!bodyMotions[bodyOfPoint[l]].moving || (*anchors[0])[l] < 0)
+			continue;
+		for(PetscInt d=0; d<dim; d++)
+		{
+			if(abs((*cells[d])[l] - (*anchors[d])[l]) > stencilMargin)
+				leftStencil = 1;
+		}
+	}
+	ierr = MPI_Allreduce(MPI_IN_PLACE, &leftStencil, 1, MPIU_INT, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	rebuild = (leftStencil)? PETSC_TRUE : PETSC_FALSE;
+
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+	if(rebuild)
+	{
+		anchorI.clear();
+		anchorJ.clear();
+		anchorK.clear();
+		ierr = MatDestroy(&NavierStokesSolver<dim>::BNQ); CHKERRQ(ierr);
+		ierr = MatDestroy(&NavierStokesSolver<dim>::QT); CHKERRQ(ierr);
+		ierr = MatDestroy(&NavierStokesSolver<dim>::QTBNQ); CHKERRQ(ierr);
+		ierr = MatDestroy(&ET); CHKERRQ(ierr);
+		ierr = PetscLogEventBegin(NavierStokesSolver<dim>::eventGenerateBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+		ierr = generateBNQ(); CHKERRQ(ierr);
+		ierr = PetscLogEventEnd(NavierStokesSolver<dim>::eventGenerateBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+		ierr = PetscTime(&t1); CHKERRQ(ierr);
+		t2 = t1;
+		ierr = NavierStokesSolver<dim>::generateQTBNQ(); CHKERRQ(ierr);
+		ierr = KSPSetOperators(NavierStokesSolver<dim>::ksp2, NavierStokesSolver<dim>::QTBNQ, NavierStokesSolver<dim>::QTBNQ); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = generateStencils(); CHKERRQ(ierr);
+		ierr = PetscTime(&t1); CHKERRQ(ierr);
+
+		ierr = VecGetOwnershipRange(NavierStokesSolver<dim>::q, &qStart, NULL); CHKERRQ(ierr);
+		ierr = VecGetArray(NavierStokesSolver<dim>::BN, &BN); CHKERRQ(ierr);
+		for(size_t e=0; e<stencilRows.size(); e++)
+		{
+			if(!bodyMotions[bodyOfPoint[stencilPoints[e]]].moving)
+				continue;
+			row = stencilRows[e];
+			col = globalIndexMapping[stencilPoints[e]] + stencilComponents[e];
+			ierr = MatSetValue(NavierStokesSolver<dim>::BNQ, row, col, BN[row-qStart]*stencilWeights[e], INSERT_VALUES); CHKERRQ(ierr);
+			ierr = MatSetValue(NavierStokesSolver<dim>::QT, col, row, stencilWeights[e], INSERT_VALUES); CHKERRQ(ierr);
+			col = forceIndexMapping[stencilPoints[e]] + stencilComponents[e];
+			ierr = MatSetValue(ET, row, col, stencilWeights[e], INSERT_VALUES); CHKERRQ(ierr);
+		}
+		ierr = VecRestoreArray(NavierStokesSolver<dim>::BN, &BN); CHKERRQ(ierr);
+		ierr = MatAssemblyBegin(NavierStokesSolver<dim>::BNQ, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+		ierr = MatAssemblyEnd(NavierStokesSolver<dim>::BNQ, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+		ierr = MatAssemblyBegin(NavierStokesSolver<dim>::QT, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+		ierr = MatAssemblyEnd(NavierStokesSolver<dim>::QT, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+		ierr = MatAssemblyBegin(ET, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+		ierr = MatAssemblyEnd(ET, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+		ierr = PetscTime(&t2); CHKERRQ(ierr);
+
+		ierr = PetscLogEventBegin(NavierStokesSolver<dim>::eventGenerateQTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+		ierr = MatMatMult(NavierStokesSolver<dim>::QT, NavierStokesSolver<dim>::BNQ, MAT_REUSE_MATRIX, PETSC_DEFAULT, &NavierStokesSolver<dim>::QTBNQ); CHKERRQ(ierr);
+		ierr = PetscLogEventEnd(NavierStokesSolver<dim>::eventGenerateQTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+	}
+	if(scaleForces)
+	{
+		ierr = scaleForceBlock(); CHKERRQ(ierr);
+	}
+	ierr = PetscTime(&t3); CHKERRQ(ierr);
+
+	*rebuilt = rebuild;
+	timings[0] = t1-t0;
+	timings[1] = t2-t1;
+	timings[2] = t3-t2;
+
+	return 0;
+}
+
+/**
+ * \brief Sets the velocity of the body points in the portion of the vector
+ *        \f$ r^2 \f$ associated with the Lagrangian forces.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::addBodyVelocities()
+{
+	PetscErrorCode ierr;
+	PetscInt       rank, fStart;
+	Vec            fGlobal;
+	PetscReal      *bc;
+
+	if(!movingBodies)
+		return 0;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	ierr = DMCompositeGetAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::r2, NULL, &fGlobal); CHKERRQ(ierr);
+	ierr = VecGetOwnershipRange(fGlobal, &fStart, NULL); CHKERRQ(ierr);
+	ierr = VecGetArray(fGlobal, &bc); CHKERRQ(ierr);
+	for(auto l=boundaryPointIndices[rank].begin(); l!=boundaryPointIndices[rank].end(); l++)
+	{
+		for(PetscInt d=0; d<dim; d++)
+		{
+			bc[forceIndexMapping[*l]-fStart+d] = bodyVelocities[dim*(*l)+d];
+		}
+	}
+	ierr = VecRestoreArray(fGlobal, &bc); CHKERRQ(ierr);
+	ierr = DMCompositeRestoreAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::r2, NULL, &fGlobal); CHKERRQ(ierr);
+
+	return 0;
+}
@@ -0,0 +1,179 @@
+/***************************************************************************//**
+ * \file resampleBodies.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c TairaColoniusSolver that
+ *        resample the body points to match the local grid spacing.
+ */
+
+
+/**
+ * \brief Returns the width of the cells around a point along a direction.
+ *
+ * The cell widths \f$ h_d \f$ are those of the cell containing the point
+ * (clamped to the domain). Along the unit vector \f$ t \f$, the spacing is
+ * \f$ \left( \sum_d (t_d/h_d)^2 \right)^{-1/2} \f$; without a direction,
+ * the geometric mean of the widths is returned.
+ */
+template <PetscInt dim>
+PetscReal TairaColoniusSolver<dim>::gridSpacing(const PetscReal *point, const PetscReal *direction)
+{
+	const std::vector<PetscReal> *nodes[3] = {&NavierStokesSolver<dim>::mesh->x, &NavierStokesSolver<dim>::mesh->y, &NavierStokesSolver<dim>::mesh->z},
+	                             *widths[3] = {&NavierStokesSolver<dim>::mesh->dx, &NavierStokesSolver<dim>::mesh->dy, &NavierStokesSolver<dim>::mesh->dz};
+	PetscReal h[3], sum = 0.0, product = 1.0;
+	PetscInt  cell;
+
+	for(PetscInt d=0; d<dim; d++)
+	{
+		cell = std::upper_bound(nodes[d]->begin(), nodes[d]->end(), point[d]) - nodes[d]->begin() - 1;
+		cell = std::max<PetscInt>(0, std::min<PetscInt>(cell, widths[d]->size()-1));
+		h[d] = (*widths[d])[cell];
+	}
+	if(direction == NULL)
+	{
+		for(PetscInt d=0; d<dim; d++)
+			product *= h[d];
+		return pow(product, 1.0/dim);
+	}
+	for(PetscInt d=0; d<dim; d++)
+		sum += (direction[d]/h[d])*(direction[d]/h[d]);
+	return 1.0/sqrt(sum);
+}
+
+/**
+ * \brief Redistributes the points of a curve so that the distance between
+ *        consecutive points is `ratio` times the local grid spacing.
+ *
+ * The points from index `first` to the end of the coordinate arrays are
+ * taken as the vertices of a polyline (closed or not). The number of points
+ * is the length of the curve measured in units of the target spacing, and
+ * the new points are placed at equal increments of that measure by linear
+ * interpolation along the polyline.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::resampleCurve(size_t, PetscReal, PetscBool)
+{
+	SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Curves can only be resampled in 2D");
+}
+
+template <>
+PetscErrorCode TairaColoniusSolver<2>::resampleCurve(size_t first, PetscReal ratio, PetscBool closed)
+{
+	std::vector<PetscReal> xOld(x.begin()+first, x.end()),
+	                       yOld(y.begin()+first, y.end());
+	size_t    numOld = xOld.size(),
+	          numSegments = (closed)? numOld : numOld-1;
+	PetscReal point[2], tangent[2], length, alpha, target;
+	PetscInt  numNew;
+
+	if(numOld < 2)
+		return 0;
+
+	// length of each segment in units of the target spacing
+	std::vector<PetscReal> measure(numSegments+1, 0.0);
+	for(size_t k=0; k<numSegments; k++)
+	{
+		size_t next = (k+1)%numOld;
+		tangent[0] = xOld[next]-xOld[k];
+		tangent[1] = yOld[next]-yOld[k];
+		length = sqrt(tangent[0]*tangent[0] + tangent[1]*tangent[1]);
+		if(length == 0.0)
+		{
+			measure[k+1] = measure[k];
+			continue;
+		}
+		tangent[0] /= length;
+		tangent[1] /= length;
+		point[0] = 0.5*(xOld[next]+xOld[k]);
+		point[1] = 0.5*(yOld[next]+yOld[k]);
+		measure[k+1] = measure[k] + length/(ratio*gridSpacing(point, tangent));
+	}
+
+	numNew = std::max<PetscInt>((closed)? 3 : 2, floor(measure[numSegments]+0.5));
+	x.resize(first);
+	y.resize(first);
+	size_t k = 0;
+	for(PetscInt i=0; i<numNew; i++)
+	{
+		// closed curves start at the first point; open curves are sampled at the middle of the intervals
+		target = ((closed)? i : i+0.5)*measure[numSegments]/numNew;
+		while(k+1<numSegments && measure[k+1]<target)
+			k++;
+		size_t next = (k+1)%numOld;
+		alpha = (measure[k+1]>measure[k])? (target-measure[k])/(measure[k+1]-measure[k]) : 0.0;
+		x.push_back((1.0-alpha)*xOld[k] + alpha*xOld[next]);
+		y.push_back((1.0-alpha)*yOld[k] + alpha*yOld[next]);
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Removes the points of a body that are closer to an already kept
+ *        point than `ratio` times the local grid spacing.
+ *
+ * Used for bodies given as scattered points, for which there is no
+ * connectivity to interpolate new points: too dense bodies are thinned,
+ * too sparse bodies are left as they are. The points are sorted into
+ * buckets as wide as the largest target spacing, so that only the
+ * neighbouring buckets are searched.
+ */
+template <PetscInt dim>
+void TairaColoniusSolver<dim>::thinPoints(size_t first, PetscReal ratio)
+{
+	std::vector<PetscReal> *coords[3] = {&x, &y, &z};
+	size_t                 numOld = x.size()-first;
+	std::vector<PetscReal> spacing(numOld);
+	PetscReal              point[3] = {0.0, 0.0, 0.0}, bucketSize = 0.0, distance2;
+	PetscInt               key[3] = {0, 0, 0};
+	PetscBool              keep;
+
+	for(size_t k=0; k<numOld; k++)
+	{
+		for(PetscInt d=0; d<dim; d++)
+			point[d] = (*coords[d])[first+k];
+		spacing[k] = ratio*gridSpacing(point, NULL);
+		bucketSize = std::max(bucketSize, spacing[k]);
+	}
+	if(bucketSize == 0.0)
+		return;
+
+	std::map< std::vector<PetscInt>, std::vector<size_t> > buckets;
+	std::vector<size_t> kept;
+	for(size_t k=0; k<numOld; k++)
+	{
+		for(PetscInt d=0; d<dim; d++)
+			key[d] = floor((*coords[d])[first+k]/bucketSize);
+		keep = PETSC_TRUE;
+		for(PetscInt n=0; n<((dim==3)? 27 : 9) && keep; n++)
+		{
+			std::vector<PetscInt> neighbour(key, key+dim);
+			neighbour[0] += n%3-1;
+			neighbour[1] += (n/3)%3-1;
+			if(dim == 3)
+				neighbour[2] += n/9-1;
+			auto bucket = buckets.find(neighbour);
+			if(bucket == buckets.end())
+				continue;
+			for(auto l=bucket->second.begin(); l!=bucket->second.end() && keep; l++)
+			{
+				distance2 = 0.0;
+				for(PetscInt d=0; d<dim; d++)
+					distance2 += ((*coords[d])[first+k]-(*coords[d])[first+*l])*((*coords[d])[first+k]-(*coords[d])[first+*l]);
+				if(distance2 < spacing[k]*spacing[k])
+					keep = PETSC_FALSE;
+			}
+		}
+		if(keep)
+		{
+			buckets[std::vector<PetscInt>(key, key+dim)].push_back(k);
+			kept.push_back(k);
+		}
+	}
+
+	for(PetscInt d=0; d<dim; d++)
+	{
+		for(size_t l=0; l<kept.size(); l++)
+			(*coords[d])[first+l] = (*coords[d])[first+kept[l]];
+		coords[d]->resize(first+kept.size());
+	}
+}
@@ -0,0 +1,53 @@
+/***************************************************************************//**
+ * \file scaleForceBlock.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the method `scaleForceBlock` of \c TairaColoniusSolver.
+ */
+
+
+/**
+ * \brief Scales the force unknowns of the system for the pressure and the
+ *        body forces symmetrically.
+ *
+ * The entries of the force block \f$ E B^N E^T \f$ scale with the weights of
+ * the discrete delta function and differ by orders of magnitude from those
+ * of \f$ G^T B^N G \f$. With \f$ D = \mathrm{diag}(1, d_f) \f$, where
+ * \f$ d_f \f$ is the inverse square root of the diagonal of the force block,
+ * the matrix \f$ Q^T B^N Q \f$ is replaced in place by
+ * \f$ D Q^T B^N Q D \f$, whose force block has a unit diagonal. The
+ * constant pressure remains its null space.
+ *
+ * The right-hand side and the unknowns are scaled around the solve in
+ * `solvePoissonSystem`, so that \f$ \lambda \f$ keeps the unscaled forces
+ * in the projection step, in the output and at restart.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::scaleForceBlock()
+{
+	PetscErrorCode ierr;
+	Vec            phiPortion, fPortion;
+	PetscInt       numForcesLocal;
+	PetscReal      *d;
+
+	if(lambdaScaling == PETSC_NULL)
+	{
+		ierr = VecDuplicate(NavierStokesSolver<dim>::lambda, &lambdaScaling); CHKERRQ(ierr);
+	}
+	ierr = MatGetDiagonal(NavierStokesSolver<dim>::QTBNQ, lambdaScaling); CHKERRQ(ierr);
+
+	ierr = DMCompositeGetAccess(NavierStokesSolver<dim>::lambdaPack, lambdaScaling, &phiPortion, &fPortion); CHKERRQ(ierr);
+	ierr = VecSet(phiPortion, 1.0); CHKERRQ(ierr);
+	ierr = VecGetLocalSize(fPortion, &numForcesLocal); CHKERRQ(ierr);
+	ierr = VecGetArray(fPortion, &d); CHKERRQ(ierr);
+	for(PetscInt i=0; i<numForcesLocal; i++)
+	{
+		// a point with an empty stencil (outside the domain) is left unscaled
+		d[i] = (d[i] > 0.0)? 1.0/sqrt(d[i]) : 1.0;
+	}
+	ierr = VecRestoreArray(fPortion, &d); CHKERRQ(ierr);
+	ierr = DMCompositeRestoreAccess(NavierStokesSolver<dim>::lambdaPack, lambdaScaling, &phiPortion, &fPortion); CHKERRQ(ierr);
+
+	ierr = MatDiagonalScale(NavierStokesSolver<dim>::QTBNQ, lambdaScaling, lambdaScaling); CHKERRQ(ierr);
+
+	return 0;
+}
@@ -0,0 +1,236 @@
+/***************************************************************************//**
+ * \file schurComplement.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the methods of \c TairaColoniusSolver
+ *        that solve for the pressure and the forces with a precomputed
+ *        Schur complement.
+ */
+
+
+/**
+ * \brief Precomputes and factors the Schur complement of the pressure block
+ *        in the system for the pressure and the body forces.
+ *
+ * With \f$ Q = [G, E^T] \f$, the matrix \f$ Q^T B^N Q \f$ is split into the
+ * blocks \f$ G^T B^N G \f$, \f$ G^T B^N E^T \f$, \f$ E B^N G \f$ and
+ * \f$ E B^N E^T \f$. The correction
+ * \f$ X = (G^T B^N G)^{-1} G^T B^N E^T \f$ is obtained with one
+ * pressure-only solve per component of the Lagrangian force and is stored as
+ * a dense matrix distributed like the pressure. The Schur complement
+ * \f$ S = E B^N E^T - E B^N G X \f$ is small: it is gathered, stored and
+ * factored on the first process only.
+ *
+ * The operators do not change with time, so this is only available when all
+ * the bodies are at rest. After this call, `ksp2` solves the pressure-only
+ * system and its options (prefix `sys2_`) apply to it.
+ *
+ * With \f$ n_f \f$ force components and \f$ n_\phi \f$ pressure unknowns,
+ * the setup costs \f$ n_f \f$ pressure solves, \f$ X \f$ takes
+ * \f$ 8 n_\phi n_f \f$ bytes over all the processes, and the first process
+ * stores \f$ S \f$ (\f$ 8 n_f^2 \f$ bytes) and factors it in
+ * \f$ O(n_f^3) \f$ operations; each time step gathers the force residual
+ * (\f$ n_f \f$ values) on the first process and scatters the forces back. This only pays off for a few
+ * thousand force components, so the setup fails above `schurMaxForces`
+ * (2000 by default, set in `simulationParameters.yaml`).
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::generateSchurComplement()
+{
+	PetscErrorCode ierr;
+	IS             *is;
+	Mat            EBNET;
+	Vec            phiRHS, fRHS, fUnit;
+	MatNullSpace   nsp;
+	MatFactorInfo  info;
+	PetscInt       numPhiLocal, numForcesLocal, numForces, fStart, fEnd;
+	PetscReal      *X, *S, *values;
+	PetscMPIInt    rank;
+	PetscLogDouble t0, t1;
+
+	if(movingBodies)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "The Schur complement force solver requires all the bodies to be at rest");
+	}
+
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	// blocks of the matrix Q^T B^N Q
+	ierr = DMCompositeGetGlobalISs(NavierStokesSolver<dim>::lambdaPack, &is); CHKERRQ(ierr);
+	phiIS = is[0];
+	fIS = is[1];
+	ierr = PetscFree(is); CHKERRQ(ierr);
+	ierr = MatGetSubMatrix(NavierStokesSolver<dim>::QTBNQ, phiIS, phiIS, MAT_INITIAL_MATRIX, &GTBNG); CHKERRQ(ierr);
+	ierr = MatGetSubMatrix(NavierStokesSolver<dim>::QTBNQ, phiIS, fIS, MAT_INITIAL_MATRIX, &GTBNET); CHKERRQ(ierr);
+	ierr = MatGetSubMatrix(NavierStokesSolver<dim>::QTBNQ, fIS, phiIS, MAT_INITIAL_MATRIX, &EBNG); CHKERRQ(ierr);
+	ierr = MatGetSubMatrix(NavierStokesSolver<dim>::QTBNQ, fIS, fIS, MAT_INITIAL_MATRIX, &EBNET); CHKERRQ(ierr);
+
+	ierr = MatGetVecs(GTBNET, &fTemp, &phiTemp); CHKERRQ(ierr);
+	ierr = VecDuplicate(phiTemp, &phiRHS); CHKERRQ(ierr);
+	ierr = VecDuplicate(fTemp, &fRHS); CHKERRQ(ierr);
+	ierr = VecDuplicate(fTemp, &fUnit); CHKERRQ(ierr);
+	ierr = VecGetLocalSize(phiTemp, &numPhiLocal); CHKERRQ(ierr);
+	ierr = VecGetLocalSize(fTemp, &numForcesLocal); CHKERRQ(ierr);
+	ierr = VecGetSize(fTemp, &numForces); CHKERRQ(ierr);
+	ierr = VecGetOwnershipRange(fTemp, &fStart, &fEnd); CHKERRQ(ierr);
+	if(numForces > NavierStokesSolver<dim>::simParams->schurMaxForces)
+	{
+		SETERRQ2(PETSC_COMM_WORLD, PETSC_ERR_SUP, "The Schur complement force solver is limited to %d force components (%d requested): increase schurMaxForces or use forceSolver COUPLED", NavierStokesSolver<dim>::simParams->schurMaxForces, numForces);
+	}
+
+	// the pressure-only system has the constant vector as null space
+	ierr = KSPSetOperators(NavierStokesSolver<dim>::ksp2, GTBNG, GTBNG); CHKERRQ(ierr);
+	ierr = MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_TRUE, 0, NULL, &nsp); CHKERRQ(ierr);
+	ierr = KSPSetNullSpace(NavierStokesSolver<dim>::ksp2, nsp); CHKERRQ(ierr);
+	ierr = MatNullSpaceDestroy(&nsp); CHKERRQ(ierr);
+
+	// S lives on the first process: fSeq is empty on the others
+	ierr = VecScatterCreateToZero(fTemp, &forceScatter, &fSeq); CHKERRQ(ierr);
+	ierr = VecDuplicate(fSeq, &fSeqRHS); CHKERRQ(ierr);
+
+	ierr = MatCreateDense(PETSC_COMM_WORLD, numPhiLocal, numForcesLocal, PETSC_DETERMINE, PETSC_DETERMINE, NULL, &forceCorrection); CHKERRQ(ierr);
+	ierr = MatDenseGetArray(forceCorrection, &X); CHKERRQ(ierr);
+	if(rank==0)
+	{
+		ierr = MatCreateSeqDense(PETSC_COMM_SELF, numForces, numForces, NULL, &schurComplement); CHKERRQ(ierr);
+		ierr = MatDenseGetArray(schurComplement, &S); CHKERRQ(ierr);
+	}
+
+	// one column of X and S per component of the Lagrangian force
+	for(PetscInt j=0; j<numForces; j++)
+	{
+		ierr = VecSet(fUnit, 0.0); CHKERRQ(ierr);
+		if(j>=fStart && j<fEnd)
+		{
+			ierr = VecSetValue(fUnit, j, 1.0, INSERT_VALUES); CHKERRQ(ierr);
+		}
+		ierr = VecAssemblyBegin(fUnit); CHKERRQ(ierr);
+		ierr = VecAssemblyEnd(fUnit); CHKERRQ(ierr);
+
+		// X e_j
+		ierr = MatMult(GTBNET, fUnit, phiRHS); CHKERRQ(ierr);
+		ierr = VecPlaceArray(phiTemp, X + j*numPhiLocal); CHKERRQ(ierr);
+		ierr = VecSet(phiTemp, 0.0); CHKERRQ(ierr);
+		ierr = KSPSolve(NavierStokesSolver<dim>::ksp2, phiRHS, phiTemp); CHKERRQ(ierr);
+
+		// S e_j
+		ierr = MatMult(EBNG, phiTemp, fRHS); CHKERRQ(ierr);
+		ierr = VecResetArray(phiTemp); CHKERRQ(ierr);
+		ierr = MatMult(EBNET, fUnit, fTemp); CHKERRQ(ierr);
+		ierr = VecAXPY(fTemp, -1.0, fRHS); CHKERRQ(ierr);
+		ierr = VecScatterBegin(forceScatter, fTemp, fSeq, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+		ierr = VecScatterEnd(forceScatter, fTemp, fSeq, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+		if(rank==0)
+		{
+			ierr = VecGetArray(fSeq, &values); CHKERRQ(ierr);
+			ierr = PetscMemcpy(S + j*numForces, values, numForces*sizeof(PetscReal)); CHKERRQ(ierr);
+			ierr = VecRestoreArray(fSeq, &values); CHKERRQ(ierr);
+		}
+	}
+
+	ierr = MatDenseRestoreArray(forceCorrection, &X); CHKERRQ(ierr);
+	ierr = MatAssemblyBegin(forceCorrection, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+	ierr = MatAssemblyEnd(forceCorrection, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+	if(rank==0)
+	{
+		ierr = MatDenseRestoreArray(schurComplement, &S); CHKERRQ(ierr);
+		ierr = MatAssemblyBegin(schurComplement, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+		ierr = MatAssemblyEnd(schurComplement, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+
+		// the iterative solves leave S slightly unsymmetric: use LU rather than Cholesky
+		ierr = MatFactorInfoInitialize(&info); CHKERRQ(ierr);
+		ierr = MatLUFactor(schurComplement, NULL, NULL, &info); CHKERRQ(ierr);
+	}
+
+	ierr = MatDestroy(&EBNET); CHKERRQ(ierr);
+	ierr = VecDestroy(&phiRHS); CHKERRQ(ierr);
+	ierr = VecDestroy(&fRHS); CHKERRQ(ierr);
+	ierr = VecDestroy(&fUnit); CHKERRQ(ierr);
+
+	ierr = PetscTime(&t1); CHKERRQ(ierr);
+	ierr = PetscPrintf(PETSC_COMM_WORLD, "Schur complement for %d force components computed in %g s\n", numForces, t1-t0); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Solves for the pressure and the body forces with the precomputed
+ *        Schur complement.
+ *
+ * \f[ G^T B^N G \phi^* = r_\phi \f]
+ * \f[ S f = r_f - E B^N G \phi^* \f]
+ * \f[ \phi = \phi^* - X f \f]
+ * so that each time step needs a single pressure-only solve. The system for
+ * the forces is solved on the first process and the forces are scattered
+ * back to the other processes.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::solveSchurComplement()
+{
+	PetscErrorCode     ierr;
+	KSPConvergedReason reason;
+	Vec                rhsPhi, rhsF, phi, f;
+	PetscMPIInt        rank;
+
+	ierr = VecGetSubVector(NavierStokesSolver<dim>::rhs2, phiIS, &rhsPhi); CHKERRQ(ierr);
+	ierr = VecGetSubVector(NavierStokesSolver<dim>::rhs2, fIS, &rhsF); CHKERRQ(ierr);
+	ierr = VecGetSubVector(NavierStokesSolver<dim>::lambda, phiIS, &phi); CHKERRQ(ierr);
+	ierr = VecGetSubVector(NavierStokesSolver<dim>::lambda, fIS, &f); CHKERRQ(ierr);
+
+	// pressure without the forces
+	ierr = KSPSolve(NavierStokesSolver<dim>::ksp2, rhsPhi, phi); CHKERRQ(ierr);
+	ierr = KSPGetConvergedReason(NavierStokesSolver<dim>::ksp2, &reason); CHKERRQ(ierr);
+	if(reason < 0)
+	{
+		ierr = flushLogs(); CHKERRQ(ierr);
+		SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_NOT_CONVERGED, "Poisson solve diverged due to reason: %d", reason);
+	}
+
+	// forces
+	ierr = MatMult(EBNG, phi, fTemp); CHKERRQ(ierr);
+	ierr = VecAYPX(fTemp, -1.0, rhsF); CHKERRQ(ierr);
+	ierr = VecScatterBegin(forceScatter, fTemp, fSeqRHS, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+	ierr = VecScatterEnd(forceScatter, fTemp, fSeqRHS, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+	if(rank==0)
+	{
+		ierr = MatSolve(schurComplement, fSeqRHS, fSeq); CHKERRQ(ierr);
+	}
+	ierr = VecScatterBegin(forceScatter, fSeq, f, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+	ierr = VecScatterEnd(forceScatter, fSeq, f, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+
+	// correction of the pressure
+	ierr = MatMult(forceCorrection, f, phiTemp); CHKERRQ(ierr);
+	ierr = VecAXPY(phi, -1.0, phiTemp); CHKERRQ(ierr);
+
+	ierr = VecRestoreSubVector(NavierStokesSolver<dim>::lambda, fIS, &f); CHKERRQ(ierr);
+	ierr = VecRestoreSubVector(NavierStokesSolver<dim>::lambda, phiIS, &phi); CHKERRQ(ierr);
+	ierr = VecRestoreSubVector(NavierStokesSolver<dim>::rhs2, fIS, &rhsF); CHKERRQ(ierr);
+	ierr = VecRestoreSubVector(NavierStokesSolver<dim>::rhs2, phiIS, &rhsPhi); CHKERRQ(ierr);
+
+	return 0;
+}
+
+/**
+ * \brief Destroys the objects created by \c generateSchurComplement.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::destroySchurComplement()
+{
+	PetscErrorCode ierr;
+
+	if(phiIS!=PETSC_NULL) {ierr = ISDestroy(&phiIS); CHKERRQ(ierr);}
+	if(fIS!=PETSC_NULL)   {ierr = ISDestroy(&fIS); CHKERRQ(ierr);}
+	if(GTBNG!=PETSC_NULL) {ierr = MatDestroy(&GTBNG); CHKERRQ(ierr);}
+	if(GTBNET!=PETSC_NULL){ierr = MatDestroy(&GTBNET); CHKERRQ(ierr);}
+	if(EBNG!=PETSC_NULL)  {ierr = MatDestroy(&EBNG); CHKERRQ(ierr);}
+	if(forceCorrection!=PETSC_NULL){ierr = MatDestroy(&forceCorrection); CHKERRQ(ierr);}
+	if(schurComplement!=PETSC_NULL){ierr = MatDestroy(&schurComplement); CHKERRQ(ierr);}
+	if(phiTemp!=PETSC_NULL){ierr = VecDestroy(&phiTemp); CHKERRQ(ierr);}
+	if(fTemp!=PETSC_NULL)  {ierr = VecDestroy(&fTemp); CHKERRQ(ierr);}
+	if(fSeq!=PETSC_NULL)   {ierr = VecDestroy(&fSeq); CHKERRQ(ierr);}
+	if(fSeqRHS!=PETSC_NULL){ierr = VecDestroy(&fSeqRHS); CHKERRQ(ierr);}
+	if(forceScatter!=PETSC_NULL){ierr = VecScatterDestroy(&forceScatter); CHKERRQ(ierr);}
+
+	return 0;
+}
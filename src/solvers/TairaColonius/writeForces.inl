@@ -1,51 +1,81 @@
-template <>
-PetscErrorCode TairaColoniusSolver<2>::writeForces()
+/**
+ * \brief Writes the forces and the moments acting on the bodies into the
+ *        files `forces.txt` and `moments.txt` (if `legacyLogs` is set).
+ *
+ * Each line contains the time followed by the components of the force
+ * (or moment) on each body, body after body. The lines are buffered and
+ * written together with the telemetry log.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::writeForces()
 {
 	PetscErrorCode ierr;
 	PetscInt       rank;
+	PetscInt       timeStep = NavierStokesSolver<dim>::timeStep;
+	PetscReal      time = timeStep*NavierStokesSolver<dim>::simParams->dt;
+
+	if(!NavierStokesSolver<dim>::simParams->legacyLogs)
+		return 0;
 
 	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
 
 	if(rank==0)
 	{
-		std::string filename = caseFolder + "/forces.txt";
-		if(timeStep==1)
-		{
-			forcesFile.open(filename.c_str());
-		}
-		else
+		std::stringstream forcesLine, momentsLine;
+		if(forcesLog == PETSC_NULL)
 		{
-			forcesFile.open(filename.c_str(), std::ios::out | std::ios::app);
+			PetscInt  interval = NavierStokesSolver<dim>::simParams->telemetryInterval;
+			PetscBool append = (timeStep==1)? PETSC_FALSE : PETSC_TRUE;
+			forcesLog = new BufferedLog(NavierStokesSolver<dim>::caseFolder + "/forces.txt", interval, append);
+			momentsLog = new BufferedLog(NavierStokesSolver<dim>::caseFolder + "/moments.txt", interval, append);
 		}
-		forcesFile << timeStep*simParams->dt << '\t' << force[0] << '\t' << force[1] << std::endl;
-		forcesFile.close();
+		forcesLine << time;
+		for(size_t i=0; i<forces.size(); i++)
+			forcesLine << '\t' << forces[i];
+		ierr = forcesLog->addLine(forcesLine.str()); CHKERRQ(ierr);
+		momentsLine << time;
+		for(size_t i=0; i<moments.size(); i++)
+			momentsLine << '\t' << moments[i];
+		ierr = momentsLog->addLine(momentsLine.str()); CHKERRQ(ierr);
 	}
 
 	return 0;
 }
 
-template <>
-PetscErrorCode TairaColoniusSolver<3>::writeForces()
+/**
+ * \brief Adds the forces and the moments on the bodies (body after body) to
+ *        the telemetry record of the time step.
+ */
+template <PetscInt dim>
+void TairaColoniusSolver<dim>::addTelemetry(std::ostream &record)
 {
-	PetscErrorCode ierr;
-	PetscInt       rank;
+	record << ", \"forces\": [";
+	for(size_t i=0; i<forces.size(); i++)
+		record << ((i > 0)? ", " : "") << forces[i];
+	record << "], \"moments\": [";
+	for(size_t i=0; i<moments.size(); i++)
+		record << ((i > 0)? ", " : "") << moments[i];
+	record << "]";
+}
 
-	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+/**
+ * \brief Writes the buffered lines of the forces and the moments, then those
+ *        of the logs of the base class.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::flushLogs()
+{
+	PetscErrorCode ierr;
 
-	if(rank==0)
+	if(forcesLog != PETSC_NULL)
 	{
-		std::string filename = caseFolder + "/forces.txt";
-		if(timeStep==1)
-		{
-			forcesFile.open(filename.c_str());
-		}
-		else
-		{
-			forcesFile.open(filename.c_str(), std::ios::out | std::ios::app);
-		}
-		forcesFile << timeStep*simParams->dt << '\t' << force[0] << '\t' << force[1] << '\t' << force[2] << std::endl;
-		forcesFile.close();
+		ierr = forcesLog->flush(); CHKERRQ(ierr);
+	}
+	if(momentsLog != PETSC_NULL)
+	{
+		ierr = momentsLog->flush(); CHKERRQ(ierr);
 	}
+	ierr = NavierStokesSolver<dim>::flushLogs(); CHKERRQ(ierr);
 
 	return 0;
 }
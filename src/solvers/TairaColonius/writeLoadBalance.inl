@@ -0,0 +1,90 @@
+/***************************************************************************//**
+ * \file writeLoadBalance.inl
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Implementation of the method `writeLoadBalance` of \c TairaColoniusSolver.
+ */
+
+
+/**
+ * \brief Writes the predicted and the measured load of each process
+ *        into the file `loadBalance.txt`.
+ *
+ * The predicted load is given by the cost model of `computeOwnershipRanges`
+ * evaluated on the subdomain owned by the process. The measured load is the
+ * number of non-zeros in the local rows of the matrices applied at every
+ * time step (A, BNQ and QTBNQ). The ratio of the maximum to the average load
+ * is printed for both. The file is only written with the body-weighted
+ * decomposition.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::writeLoadBalance()
+{
+	PetscErrorCode ierr;
+	PetscInt       rank, numProcs;
+	PetscInt       start[3], numNodes[3], overlap;
+	PetscInt       window = (PetscInt)ceil(deltaFunctionSupport());
+	PetscReal      load[2] = {0.0, 0.0};
+	MatInfo        info;
+
+	std::vector<PetscInt> *cells[3] = {&I, &J, &K};
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
+
+	// predicted load
+	ierr = DMDAGetCorners(NavierStokesSolver<dim>::pda, &start[0], &start[1], &start[2], &numNodes[0], &numNodes[1], &numNodes[2]); CHKERRQ(ierr);
+	load[0] = numNodes[0]*numNodes[1];
+	if(dim==3) load[0] *= numNodes[2];
+	for(size_t n=0; n<nearbyPoints.size(); n++)
+	{
+		PetscInt l = nearbyPoints[n];
+		overlap = 1;
+		for(PetscInt d=0; d<dim; d++)
+		{
+			overlap *= std::max<PetscInt>(0, std::min<PetscInt>(start[d]+numNodes[d]-1, (*cells[d])[l]+window) - std::max<PetscInt>(start[d], (*cells[d])[l]-window) + 1);
+		}
+		load[0] += NavierStokesSolver<dim>::simParams->bodyCostWeight*overlap;
+	}
+
+	// measured load
+	ierr = MatGetInfo(NavierStokesSolver<dim>::A, MAT_LOCAL, &info); CHKERRQ(ierr);
+	load[1] += info.nz_used;
+	ierr = MatGetInfo(NavierStokesSolver<dim>::BNQ, MAT_LOCAL, &info); CHKERRQ(ierr);
+	load[1] += info.nz_used;
+	// not built by the null-space solver
+	if(NavierStokesSolver<dim>::QTBNQ != PETSC_NULL)
+	{
+		ierr = MatGetInfo(NavierStokesSolver<dim>::QTBNQ, MAT_LOCAL, &info); CHKERRQ(ierr);
+		load[1] += info.nz_used;
+	}
+
+	std::vector<PetscReal> loads(2*numProcs);
+	ierr = MPI_Gather(load, 2, MPIU_REAL, &loads.front(), 2, MPIU_REAL, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	if(rank==0)
+	{
+		PetscReal sum[2] = {0.0, 0.0},
+		          max[2] = {0.0, 0.0};
+		for(PetscInt i=0; i<numProcs; i++)
+		{
+			for(PetscInt j=0; j<2; j++)
+			{
+				sum[j] += loads[2*i+j];
+				max[j] = std::max(max[j], loads[2*i+j]);
+			}
+		}
+
+		std::string filename = NavierStokesSolver<dim>::caseFolder + "/loadBalance.txt";
+		std::ofstream file(filename.c_str());
+		file << "# rank\tpredicted\tmeasured (non-zeros)\n";
+		for(PetscInt i=0; i<numProcs; i++)
+		{
+			file << i << '\t' << loads[2*i]/sum[0] << '\t' << loads[2*i+1]/sum[1] << '\n';
+		}
+		file.close();
+
+		ierr = PetscPrintf(PETSC_COMM_SELF, "load imbalance (max/average): predicted %g, measured %g\n", max[0]*numProcs/sum[0], max[1]*numProcs/sum[1]); CHKERRQ(ierr);
+	}
+
+	return 0;
+}
@@ -11,12 +11,36 @@
 #include <sstream>
 #include <string>
 #include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <sys/stat.h>
 
 #include "yaml-cpp/yaml.h"
 #include <petscdmcomposite.h>
 
 
+template <PetscInt dim>
+PetscLogEvent TairaColoniusSolver<dim>::eventCalculateForce;
+
+/**
+ * \brief Registers the log event of the force integration, on the first call
+ *        only (see \c NavierStokesSolver::registerLogEvents).
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::registerForceLogEvent()
+{
+  PetscErrorCode   ierr;
+  static PetscBool registered = PETSC_FALSE;
+
+  if(registered)
+    return 0;
+  registered = PETSC_TRUE;
+  ierr = PetscLogEventRegister("calculateForce", 0, &eventCalculateForce); CHKERRQ(ierr);
+
+  return 0;
+}
+
 template <PetscInt dim>
 PetscErrorCode TairaColoniusSolver<dim>::initialize()
 {
@@ -24,10 +48,30 @@ PetscErrorCode TairaColoniusSolver<dim>::initialize()
 
   ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageInitialize); CHKERRQ(ierr);
   ierr = initializeBodies(); CHKERRQ(ierr);
-  ierr = calculateCellIndices(); CHKERRQ(ierr);
+  if(movingBodies)
+  {
+    x0 = x;
+    y0 = y;
+    z0 = z;
+    bodyCenters0 = bodyCenters;
+    ierr = moveBodies(NavierStokesSolver<dim>::timeStep*NavierStokesSolver<dim>::simParams->dt); CHKERRQ(ierr);
+  }
   ierr = createDMs(); CHKERRQ(ierr);
+  ierr = calculateCellIndices(); CHKERRQ(ierr);
   ierr = createGlobalMappingBodies(); CHKERRQ(ierr);
   ierr = NavierStokesSolver<dim>::initializeCommon(); CHKERRQ(ierr);
+  if(scaleForces)
+  {
+    ierr = scaleForceBlock(); CHKERRQ(ierr);
+  }
+  if(NavierStokesSolver<dim>::simParams->forceSolver == SCHUR_COMPLEMENT)
+  {
+    ierr = generateSchurComplement(); CHKERRQ(ierr);
+  }
+  if(NavierStokesSolver<dim>::simParams->decomposition == BODY_WEIGHTED)
+  {
+    ierr = writeLoadBalance(); CHKERRQ(ierr);
+  }
   ierr = PetscLogStagePop(); CHKERRQ(ierr);
 
   return 0;
@@ -38,15 +82,20 @@ PetscErrorCode TairaColoniusSolver<dim>::finalize()
 {
   PetscErrorCode ierr;
 
-  ierr = NavierStokesSolver<dim>::finalize();
+  ierr = NavierStokesSolver<dim>::finalize(); CHKERRQ(ierr);
+  ierr = destroySchurComplement(); CHKERRQ(ierr);
+
+  // logs (writes the buffered lines)
+  if(forcesLog!=PETSC_NULL) {delete forcesLog; forcesLog = PETSC_NULL;}
+  if(momentsLog!=PETSC_NULL){delete momentsLog; momentsLog = PETSC_NULL;}
 
   // DMs
   if(bda!=PETSC_NULL) {ierr = DMDestroy(&bda); CHKERRQ(ierr);}
   // Mats
   if(ET!=PETSC_NULL)  {ierr = MatDestroy(&ET); CHKERRQ(ierr);}
   // Vecs
-  if(regularizedForce!=PETSC_NULL){ierr = VecDestroy(&regularizedForce); CHKERRQ(ierr);}
   if(nullSpaceVec!=PETSC_NULL){ierr = VecDestroy(&nullSpaceVec); CHKERRQ(ierr);}
+  if(lambdaScaling!=PETSC_NULL){ierr = VecDestroy(&lambdaScaling); CHKERRQ(ierr);}
 
   return 0;
 }
@@ -55,6 +104,12 @@ template <PetscInt dim>
 PetscErrorCode TairaColoniusSolver<dim>::createDMs()
 {
   PetscErrorCode ierr;
+  if(NavierStokesSolver<dim>::simParams->decomposition == BODY_WEIGHTED)
+  {
+    // cells of all the points (the distributed arrays do not exist yet)
+    ierr = calculateCellIndices(); CHKERRQ(ierr);
+    ierr = computeOwnershipRanges(); CHKERRQ(ierr);
+  }
   ierr = NavierStokesSolver<dim>::createDMs(); CHKERRQ(ierr); 
   ierr = generateBodyInfo(); CHKERRQ(ierr);
   ierr = DMDACreate1d(PETSC_COMM_WORLD, DM_BOUNDARY_NONE, x.size(), dim, 0, &numBoundaryPointsOnProcess.front(), &bda); CHKERRQ(ierr);
@@ -69,55 +124,77 @@ PetscErrorCode TairaColoniusSolver<dim>::createVecs()
   PetscErrorCode ierr;
 
   ierr = NavierStokesSolver<dim>::createVecs();
-  ierr = VecDuplicate(NavierStokesSolver<dim>::q, &regularizedForce); CHKERRQ(ierr);
   ierr = VecDuplicate(NavierStokesSolver<dim>::lambda, &nullSpaceVec); CHKERRQ(ierr);
 
   return 0;
 }
 
+/**
+ * \brief Solves for the pressure and the body forces.
+ *
+ * With the force scaling, the system solved is
+ * \f$ (D Q^T B^N Q D) (D^{-1} \lambda) = D r \f$.
+ */
 template <PetscInt dim>
-PetscErrorCode TairaColoniusSolver<dim>::writeData()
+PetscErrorCode TairaColoniusSolver<dim>::solvePoissonSystem()
 {
-  NavierStokesSolver<dim>::writeData();
-  calculateForce();
-  writeForces();
+  PetscErrorCode ierr;
+
+  if(scaleForces)
+  {
+    ierr = VecPointwiseMult(NavierStokesSolver<dim>::rhs2, NavierStokesSolver<dim>::rhs2, lambdaScaling); CHKERRQ(ierr);
+    ierr = VecPointwiseDivide(NavierStokesSolver<dim>::lambda, NavierStokesSolver<dim>::lambda, lambdaScaling); CHKERRQ(ierr);
+  }
+
+  if(NavierStokesSolver<dim>::simParams->forceSolver == SCHUR_COMPLEMENT)
+  {
+    ierr = solveSchurComplement(); CHKERRQ(ierr);
+  }
+  else
+  {
+    ierr = NavierStokesSolver<dim>::solvePoissonSystem(); CHKERRQ(ierr);
+  }
+
+  if(scaleForces)
+  {
+    ierr = VecPointwiseMult(NavierStokesSolver<dim>::lambda, NavierStokesSolver<dim>::lambda, lambdaScaling); CHKERRQ(ierr);
+  }
 
   return 0;
 }
 
 template <PetscInt dim>
-PetscReal TairaColoniusSolver<dim>::dhRoma(PetscReal x, PetscReal h)
+PetscErrorCode TairaColoniusSolver<dim>::writeData()
 {
-  PetscReal r = fabs(x)/h;
-  if(r>1.5) return 0.0;
-  if(r>0.5 && r<=1.5) return 1.0/(6*h)*( 5.0 - 3.0*r - sqrt(-3.0*(1-r)*(1-r) + 1.0) );
-  return 1.0/(3*h)*( 1.0 + sqrt(-3.0*r*r + 1.0) );
-}
+  PetscErrorCode ierr;
 
-template <PetscInt dim>
-PetscReal TairaColoniusSolver<dim>::delta(PetscReal x, PetscReal y, PetscReal h)
-{
-  return dhRoma(x, h) * dhRoma(y, h);
-}
+  // the forces are part of the telemetry record written by the base class
+  ierr = calculateForce(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::writeData(); CHKERRQ(ierr);
+  ierr = writeForces(); CHKERRQ(ierr);
 
-template <PetscInt dim>
-PetscReal TairaColoniusSolver<dim>::delta(PetscReal x, PetscReal y, PetscReal z, PetscReal h)
-{
-  return dhRoma(x, h) * dhRoma(y, h) * dhRoma(z, h);
+  return 0;
 }
 
 #include "TairaColonius/setNullSpace.inl"
 #include "TairaColonius/calculateCellIndices.inl"
 #include "TairaColonius/initializeLambda.inl"
 #include "TairaColonius/generateBodyInfo.inl"
+#include "TairaColonius/computeOwnershipRanges.inl"
+#include "TairaColonius/writeLoadBalance.inl"
+#include "TairaColonius/generateStencils.inl"
 #include "TairaColonius/generateBNQ.inl"
 #include "TairaColonius/generateR2.inl"
+#include "TairaColonius/resampleBodies.inl"
 #include "TairaColonius/initializeBodies.inl"
 #include "TairaColonius/createGlobalMappingBodies.inl"
 #include "TairaColonius/isInfluenced.inl"
 #include "TairaColonius/writeLambda.inl"
 #include "TairaColonius/calculateForce.inl"
 #include "TairaColonius/writeForces.inl"
+#include "TairaColonius/moveBodies.inl"
+#include "TairaColonius/schurComplement.inl"
+#include "TairaColonius/scaleForceBlock.inl"
 
 template class TairaColoniusSolver<2>;
 template class TairaColoniusSolver<3>;
\ No newline at end of file
@@ -9,8 +9,28 @@
 #define TAIRA_COLONIUS_SOLVER_H
 
 #include "NavierStokesSolver.h"
+#include "DeltaFunctions.h"
 
 
+/**
+ * \brief Prescribed motion of an immersed body.
+ *
+ * The reference point of the body (`centerRotation`) moves as
+ * \f$ X_c(t) = X_c(0) + U t + A_x \sin(\omega_x t + \phi_x) \f$ (same in y),
+ * and the body rotates about the z-axis through that point by the angle
+ * \f$ \theta(t) = \Omega t + A_\theta \sin(\omega_\theta t + \phi_\theta) \f$.
+ * Oscillations are given as [amplitude, angular frequency, phase].
+ */
+struct BodyMotion
+{
+  PetscBool moving;              ///< is the body moving?
+  PetscReal velocity[3];         ///< translational velocity
+  PetscReal omega;               ///< angular velocity
+  PetscReal xOscillation[3],     ///< oscillation in the x-direction
+            yOscillation[3],     ///< oscillation in the y-direction (heaving)
+            pitchOscillation[3]; ///< angular oscillation about the z-axis
+};
+
 /**
  * \class TairaColoniusSolver
  * \brief Solves the Navier-Stokes equations 
@@ -23,35 +43,106 @@ public:
   PetscInt  startGlobalIndex;
   DM        bda;
   Mat       ET;
-  PetscReal force[3];
-  Vec       nullSpaceVec, regularizedForce;
+  PetscInt  numBodies;
+  Vec       nullSpaceVec;
+
+  // forces and moments in the format of the text files (legacyLogs)
+  BufferedLog *forcesLog, *momentsLog;
 
-  std::ofstream forcesFile;
+  // force and moment on each body (body after body)
+  std::vector<PetscReal> forces, moments;
+
+  // event of the force integration (registered once, by the first solver created)
+  static PetscLogEvent eventCalculateForce;
+  static PetscErrorCode registerForceLogEvent();
 
   std::vector<PetscReal> x, y, z;
   std::vector<PetscInt>  I, J, K;
+  // body points whose stencils can reach the cells owned by the process
+  // (the only ones with a cell index, see calculateCellIndices)
+  std::vector<PetscInt>  nearbyPoints;
+  std::vector<PetscInt>  numPointsInBody;
+  std::vector<PetscInt>  bodyOfPoint;
+  std::vector<PetscReal> bodyCenters;
   std::vector<PetscInt>  globalIndexMapping;
+  std::vector<PetscInt>  forceIndexMapping;
   std::vector<PetscInt>  numBoundaryPointsOnProcess;
   std::vector<PetscInt>  numPhiOnProcess;
   std::vector< std::vector<PetscInt> > boundaryPointIndices;
+
+  // weights of the discrete delta function between the body points
+  // and the velocity nodes owned by the process (one entry per pair)
+  std::vector<PetscInt>  stencilRows,
+                         stencilPoints,
+                         stencilComponents;
+  std::vector<PetscReal> stencilWeights;
+  // quadrature weights of the components of the Lagrangian force
+  std::vector<PetscReal> forceWeights;
+
+  // prescribed motion of the bodies
+  PetscBool               movingBodies;
+  std::vector<BodyMotion> bodyMotions;
+  std::vector<PetscReal>  x0, y0, z0,     // initial coordinates of the body points
+                          bodyCenters0,   // initial reference points of the bodies
+                          bodyVelocities; // velocity of each body point
+  // cells around which the stencils of the moving points are laid out;
+  // the stencils are widened by stencilMargin cells so that the points can
+  // move without changing the non-zero structure of the operators
+  std::vector<PetscInt>   anchorI, anchorJ, anchorK;
+  PetscInt                stencilMargin;
+  std::ofstream           bodyUpdateFile;
+
+  // blocks of Q^T B^N Q and precomputed Schur complement for the forces
+  // (used when the forces are solved for with forceSolver SCHUR_COMPLEMENT)
+  IS         phiIS, fIS;
+  Mat        GTBNG,           // pressure-pressure block
+             GTBNET,          // pressure-force block
+             EBNG,            // force-pressure block
+             forceCorrection, // (G^T B^N G)^{-1} G^T B^N E^T (dense)
+             schurComplement; // LU factors of the Schur complement (dense, on the first process only)
+  Vec        phiTemp, fTemp, fSeq, fSeqRHS;
+  VecScatter forceScatter;
+
+  // symmetric diagonal scaling of the force unknowns of Q^T B^N Q
+  // (1 for the pressure, distributed like lambda)
+  PetscBool scaleForces;
+  Vec       lambdaScaling;
   
   PetscErrorCode initializeLambda();
   PetscErrorCode initializeBodies();
+  PetscReal gridSpacing(const PetscReal *point, const PetscReal *direction);
+  PetscErrorCode resampleCurve(size_t first, PetscReal ratio, PetscBool closed);
+  void thinPoints(size_t first, PetscReal ratio);
   PetscErrorCode generateBodyInfo();
   PetscErrorCode calculateCellIndices();
   PetscErrorCode createDMs();
   PetscErrorCode createVecs();
   PetscErrorCode setNullSpace();
+  PetscErrorCode computeOwnershipRanges();
+  PetscErrorCode writeLoadBalance();
+  PetscErrorCode generateStencils();
+  PetscReal deltaFunctionSupport();
+  template <typename Kernel>
+  PetscErrorCode computeStencilWeights();
   PetscErrorCode generateBNQ();
   PetscErrorCode generateR2();
   PetscErrorCode createGlobalMappingBodies();
   PetscErrorCode calculateForce();
+  PetscErrorCode integrateForce(Vec fGlobal, const std::vector<PetscReal> &weights, PetscReal scale);
   PetscErrorCode writeForces();
+  void addTelemetry(std::ostream &record);
+  PetscErrorCode flushLogs();
   PetscErrorCode writeLambda();
+  PetscErrorCode moveBodies(PetscReal time);
+  PetscErrorCode updateOperators(PetscBool *rebuilt, PetscLogDouble *timings);
+  PetscErrorCode addBodyVelocities();
+  PetscErrorCode updateImmersedBoundary();
+  PetscErrorCode generateSchurComplement();
+  PetscErrorCode scaleForceBlock();
+  PetscErrorCode solvePoissonSystem();
+  PetscErrorCode solveSchurComplement();
+  PetscErrorCode destroySchurComplement();
 
-  PetscReal dhRoma(PetscReal x, PetscReal h);
-  PetscReal delta(PetscReal x, PetscReal y, PetscReal h);
-  PetscReal delta(PetscReal x, PetscReal y, PetscReal z, PetscReal h);
   PetscBool isInfluenced(PetscReal xGrid, PetscReal yGrid, PetscReal xBody, PetscReal yBody, PetscReal radius, PetscReal *delta);
   PetscBool isInfluenced(PetscReal xGrid, PetscReal yGrid, PetscReal zGrid, PetscReal xBody, PetscReal yBody, PetscReal zBody, PetscReal radius, PetscReal *delta);
 
@@ -64,8 +155,27 @@ public:
   {
     bda = PETSC_NULL;
     ET  = PETSC_NULL;
-    nullSpaceVec     = PETSC_NULL;
-    regularizedForce = PETSC_NULL;
+    nullSpaceVec = PETSC_NULL;
+    numBodies = 0;
+    movingBodies = PETSC_FALSE;
+    stencilMargin = 2;
+    phiIS = PETSC_NULL;
+    fIS   = PETSC_NULL;
+    GTBNG  = PETSC_NULL;
+    GTBNET = PETSC_NULL;
+    EBNG   = PETSC_NULL;
+    forceCorrection = PETSC_NULL;
+    schurComplement = PETSC_NULL;
+    phiTemp = PETSC_NULL;
+    fTemp   = PETSC_NULL;
+    fSeq    = PETSC_NULL;
+    fSeqRHS = PETSC_NULL;
+    forceScatter = PETSC_NULL;
+    scaleForces = SP->forceScaling;
+    lambdaScaling = PETSC_NULL;
+    forcesLog  = PETSC_NULL;
+    momentsLog = PETSC_NULL;
+    registerForceLogEvent();
   }
   
   // name of the solver
@@ -11,7 +11,8 @@
  * \brief Creates the appropriate solver.
  *
  * If there is no immersed boundary in the domain, a Navier-Stokes solver iis
- * created. Otherwise, Taira and Colonius (2007) solver type is instanciated.
+ * created. Otherwise, Taira and Colonius (2007) solver type, the direct
+ * forcing solver or the (2D) null-space solver is instanciated.
  */
 template <PetscInt dim>
 std::unique_ptr< NavierStokesSolver<dim> > createSolver(std::string folder, 
@@ -34,6 +35,14 @@ std::unique_ptr< NavierStokesSolver<dim> > createSolver(std::string folder,
       return std::unique_ptr< TairaColoniusSolver<dim> >(new TairaColoniusSolver<dim>(folder, 
                                                                                       FD, SP, CM));
       break;
+    case DIRECT_FORCING:
+      return std::unique_ptr< DirectForcingSolver<dim> >(new DirectForcingSolver<dim>(folder, 
+                                                                                      FD, SP, CM));
+      break;
+    case NULL_SPACE:
+      return std::unique_ptr< NullSpaceSolver<dim> >(new NullSpaceSolver<dim>(folder, 
+                                                                              FD, SP, CM));
+      break;
     default:
       PetscPrintf(PETSC_COMM_WORLD, "Unrecognized solver!\n");
       return NULL;
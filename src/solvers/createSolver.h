@@ -10,6 +10,8 @@
 
 #include "NavierStokesSolver.h"
 #include "TairaColoniusSolver.h"
+#include "DirectForcingSolver.h"
+#include "NullSpaceSolver.h"
 
 #include <memory>
 
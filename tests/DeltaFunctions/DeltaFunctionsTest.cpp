@@ -0,0 +1,78 @@
+/***************************************************************************//**
+ * \file DeltaFunctionsTest.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Unit-test for the discrete delta kernels.
+ */
+
+
+#include "DeltaFunctions.h"
+#include "gtest/gtest.h"
+
+
+/**
+ * \brief Checks that the kernel satisfies the discrete partition of unity
+ *        and has a zero first moment, for several shifts of the body point.
+ */
+template <typename Kernel>
+void checkMoments()
+{
+  PetscInt width = (PetscInt)ceil(Kernel::support()) + 1;
+  for(PetscInt s=0; s<10; s++)
+  {
+    PetscReal shift = 0.1*s,
+              sum = 0.0,
+              firstMoment = 0.0;
+    for(PetscInt j=-width; j<=width; j++)
+    {
+      sum += Kernel::phi(fabs(j - shift));
+      firstMoment += (j - shift)*Kernel::phi(fabs(j - shift));
+    }
+    EXPECT_NEAR(sum, 1.0, 1.0E-12);
+    EXPECT_NEAR(firstMoment, 0.0, 1.0E-12);
+  }
+}
+
+TEST(DeltaFunctionsTest, RomaMoments)
+{
+  checkMoments<RomaDelta>();
+}
+
+TEST(DeltaFunctionsTest, PeskinMoments)
+{
+  checkMoments<PeskinDelta4>();
+}
+
+TEST(DeltaFunctionsTest, BSplineMoments)
+{
+  checkMoments<BSplineDelta6>();
+}
+
+TEST(DeltaFunctionsTest, Support)
+{
+  EXPECT_DOUBLE_EQ(RomaDelta::phi(1.5), 0.0);
+  EXPECT_DOUBLE_EQ(PeskinDelta4::phi(2.0), 0.0);
+  EXPECT_DOUBLE_EQ(BSplineDelta6::phi(3.0), 0.0);
+}
+
+TEST(DeltaFunctionsTest, RomaScaling)
+{
+  // one-dimensional kernel of Roma et al. (1999) scaled by the grid-spacing
+  PetscReal h = 0.25;
+  for(PetscInt s=0; s<=30; s++)
+  {
+    PetscReal x = -0.4 + s*0.8/30,
+              r = fabs(x)/h,
+              expected = 0.0;
+    if(r<=0.5)
+      expected = 1.0/(3*h)*(1.0 + sqrt(-3.0*r*r + 1.0));
+    else if(r<=1.5)
+      expected = 1.0/(6*h)*(5.0 - 3.0*r - sqrt(-3.0*(1-r)*(1-r) + 1.0));
+    EXPECT_NEAR(dh<RomaDelta>(x, h), expected, 1.0E-12);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
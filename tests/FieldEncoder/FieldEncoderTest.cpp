@@ -0,0 +1,106 @@
+/***************************************************************************//**
+ * \file FieldEncoderTest.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Unit-test for the encodings of the flow variables in the output files.
+ */
+
+
+#include "FieldEncoder.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <limits>
+
+
+/**
+ * \brief Smooth field with small-scale fluctuations.
+ */
+std::vector<PetscReal> sampleField()
+{
+  std::vector<PetscReal> values(1000);
+  for(size_t i=0; i<values.size(); i++)
+    values[i] = sin(0.01*i) + 1.0E-03*cos(0.37*i);
+  values[500] = 0.0;
+  values[501] = -1.0E+10;
+  return values;
+}
+
+/**
+ * \brief Encodes and decodes the sample field; returns the largest error.
+ */
+PetscReal roundTrip(FieldEncoding encoding, PetscReal tolerance, size_t &numBytes)
+{
+  std::vector<PetscReal> values = sampleField(),
+                         decoded(values.size());
+  std::vector<char>      bytes;
+  PetscReal              error = 0.0;
+
+  encodeValues(encoding, tolerance, &values[0], values.size(), bytes);
+  numBytes = bytes.size();
+  EXPECT_EQ(decodeValues(encoding, tolerance, &bytes[0], values.size(), &decoded[0]), numBytes);
+  for(size_t i=0; i<values.size(); i++)
+    error = std::max(error, fabs(decoded[i]-values[i])/std::max(1.0, fabs(values[i])));
+  return error;
+}
+
+TEST(FieldEncoderTest, FullPrecision)
+{
+  size_t numBytes;
+  EXPECT_EQ(roundTrip(FULL_PRECISION, 0.0, numBytes), 0.0);
+  EXPECT_EQ(numBytes, 1000*sizeof(PetscReal));
+}
+
+TEST(FieldEncoderTest, SinglePrecision)
+{
+  size_t numBytes;
+  EXPECT_LT(roundTrip(SINGLE_PRECISION, 0.0, numBytes), 1.0E-07);
+  EXPECT_EQ(numBytes, 1000*sizeof(float));
+}
+
+TEST(FieldEncoderTest, Lossless)
+{
+  size_t numBytes;
+  EXPECT_EQ(roundTrip(LOSSLESS, 0.0, numBytes), 0.0);
+  // about 92% of the full-precision size on this field (see FieldEncoder.h)
+  EXPECT_LT(numBytes, 0.95*1000*sizeof(PetscReal));
+}
+
+TEST(FieldEncoderTest, ErrorBounded)
+{
+  size_t numBytes;
+  std::vector<PetscReal> values = sampleField(),
+                         decoded(values.size());
+  std::vector<char>      bytes;
+
+  encodeValues(ERROR_BOUNDED, 1.0E-06, &values[0], values.size(), bytes);
+  decodeValues(ERROR_BOUNDED, 1.0E-06, &bytes[0], values.size(), &decoded[0]);
+  for(size_t i=0; i<values.size(); i++)
+  {
+    EXPECT_LE(fabs(decoded[i]-values[i]), 1.0E-06);
+  }
+  roundTrip(ERROR_BOUNDED, 1.0E-06, numBytes);
+  EXPECT_LT(numBytes, 1000*sizeof(float));
+}
+
+TEST(FieldEncoderTest, ErrorBoundedOutOfRange)
+{
+  PetscReal values[6] = {1.0E+14, -1.0E+14, 1.0, std::numeric_limits<PetscReal>::infinity(),
+                         std::numeric_limits<PetscReal>::quiet_NaN(), 0.5},
+            decoded[6];
+  std::vector<char> bytes;
+
+  encodeValues(ERROR_BOUNDED, 1.0E-06, values, 6, bytes);
+  EXPECT_EQ(decodeValues(ERROR_BOUNDED, 1.0E-06, &bytes[0], 6, decoded), bytes.size());
+  EXPECT_EQ(decoded[0], 1.0E+14);
+  EXPECT_EQ(decoded[1], -1.0E+14);
+  EXPECT_LE(fabs(decoded[2]-1.0), 1.0E-06);
+  EXPECT_EQ(decoded[3], values[3]);
+  EXPECT_TRUE(std::isnan(decoded[4]));
+  EXPECT_LE(fabs(decoded[5]-0.5), 1.0E-06);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
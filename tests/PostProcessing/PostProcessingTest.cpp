@@ -0,0 +1,148 @@
+/***************************************************************************//**
+ * \file PostProcessingTest.cpp
+ * \author Anush Krishnan (anush@bu.edu)
+ * \brief Unit-test for the memory-mapped reads of the output files.
+ */
+
+
+#include "MappedField.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+
+/**
+ * \brief Writes a vector in the PETSc binary format (big-endian), preceded by
+ *        `padding` bytes.
+ */
+void writeVector(std::string fileName, const std::vector<double> &values, size_t padding=0)
+{
+  std::ofstream file(fileName.c_str(), std::ios::binary);
+  std::vector<unsigned char> bytes(padding, 0);
+  int32_t header[2] = {1211214, (int32_t)values.size()};
+  for(int h=0; h<2; h++)
+  {
+    for(int b=3; b>=0; b--)
+      bytes.push_back((header[h] >> (8*b)) & 0xff);
+  }
+  for(size_t i=0; i<values.size(); i++)
+  {
+    uint64_t bits;
+    memcpy(&bits, &values[i], sizeof(double));
+    for(int b=7; b>=0; b--)
+      bytes.push_back((bits >> (8*b)) & 0xff);
+  }
+  file.write((const char *)&bytes[0], bytes.size());
+}
+
+/**
+ * \brief Grid of 4x3x2 cells; the spacing along x is non-uniform.
+ */
+class PostProcessingTest : public ::testing::Test
+{
+protected:
+  PostProcessingTest()
+  {
+    std::ofstream file("grid.txt");
+    file << "4\t3\t2\n";
+    double x[5] = {0.0, 1.0, 3.0, 4.0, 5.0};
+    for(int i=0; i<5; i++)
+      file << x[i] << '\n';
+    for(int j=0; j<4; j++)
+      file << 0.5*j << '\n';
+    for(int k=0; k<3; k++)
+      file << 2.0*k << '\n';
+  }
+
+  ~PostProcessingTest()
+  {
+    remove("grid.txt");
+    remove("field.dat");
+  }
+};
+
+TEST_F(PostProcessingTest, CellCentredView)
+{
+  OutputGrid grid("grid.txt");
+  std::vector<double> values(24);
+  for(size_t i=0; i<values.size(); i++)
+    values[i] = 0.5*i;
+  writeVector("field.dat", values);
+
+  MappedField field(grid, "field.dat", "phi");
+  EXPECT_EQ(field.normal, -1);
+  FieldView view = field.view();
+  EXPECT_EQ(view.numPoints(), 24);
+  EXPECT_DOUBLE_EQ(view(3, 2, 1), 0.5*(3 + 4*(2 + 3*1)));
+  EXPECT_DOUBLE_EQ(view.coordinate(0, 1), 2.0);
+  EXPECT_DOUBLE_EQ(view.coordinate(2, 1), 3.0);
+
+  double lower[3] = {1.5, 0.0, 0.0},
+         upper[3] = {4.0, 0.5, 10.0};
+  FieldView box = view.subBox(lower, upper);
+  EXPECT_EQ(box.size[0], 2);
+  EXPECT_EQ(box.size[1], 1);
+  EXPECT_EQ(box.size[2], 2);
+  EXPECT_DOUBLE_EQ(box(1, 0, 1), view(2, 0, 1));
+
+  FieldView plane = view.slice(2, 2.9);
+  EXPECT_EQ(plane.numPoints(), 12);
+  EXPECT_DOUBLE_EQ(plane(2, 1, 0), view(2, 1, 1));
+
+  int steps[3] = {2, 2, 1};
+  FieldView coarse = plane.strided(steps);
+  EXPECT_EQ(coarse.size[0], 2);
+  EXPECT_EQ(coarse.size[1], 2);
+  EXPECT_DOUBLE_EQ(coarse(1, 1, 0), view(2, 2, 1));
+  EXPECT_DOUBLE_EQ(coarse.coordinate(0, 1), 3.5);
+}
+
+TEST_F(PostProcessingTest, FluxInContainer)
+{
+  OutputGrid grid("grid.txt");
+  std::vector<double> values(3*3*2, 1.0);
+  values[2 + 3*(1 + 3*1)] = -2.0;
+  writeVector("field.dat", values, 5000);
+
+  MappedField field(grid, "field.dat", "qx", 5000);
+  EXPECT_EQ(field.normal, 0);
+  EXPECT_FALSE(field.periodic);
+  EXPECT_EQ(field.numPoints[0], 3);
+  FieldView view = field.view();
+  EXPECT_DOUBLE_EQ(view.coordinate(0, 2), 4.0);
+  EXPECT_DOUBLE_EQ(view(2, 1, 1), -2.0);
+  EXPECT_DOUBLE_EQ(view.velocity(2, 1, 1), -2.0/(0.5*2.0));
+
+  EXPECT_THROW(MappedField(grid, "field.dat", "phi", 5000), std::runtime_error);
+  EXPECT_THROW(MappedField(grid, "field.dat", "qx", 0), std::runtime_error);
+}
+
+TEST_F(PostProcessingTest, LastEntryOfIndex)
+{
+  // time step 3 written twice in the container (restart): the last entry holds the data
+  std::ofstream index("fields.index");
+  index << "# time-step\tvariable\tfile\toffset\tsize\n"
+        << "3\tphi\tfield.dat\t0\t24\n"
+        << "3\tqx\tfield.dat\t208\t18\n"
+        << "3\tphi\tfield.dat\t5000\t24\n";
+  index.close();
+
+  std::string fileName;
+  long        offset;
+  locateField(".", 3, "phi", fileName, offset);
+  EXPECT_EQ(fileName, "./field.dat");
+  EXPECT_EQ(offset, 5000);
+  locateField(".", 3, "qx", fileName, offset);
+  EXPECT_EQ(offset, 208);
+  EXPECT_THROW(locateField(".", 4, "phi", fileName, offset), std::runtime_error);
+
+  remove("fields.index");
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -26,6 +26,7 @@ public:
     char           caseFolder[PETSC_MAX_PATH_LEN];
 
     lambdaGold = PETSC_NULL;
+    error = PETSC_NULL;
     
     // read case folder
     PetscOptionsGetString(NULL, "-caseFolder", caseFolder, sizeof(caseFolder), NULL);
@@ -88,6 +89,53 @@ TEST_F(TairaColoniusTest, ComparePhi)
   EXPECT_LT(errorNorm/goldNorm, 5e-4);
 }
 
+TEST_F(TairaColoniusTest, CompareForce)
+{
+  TairaColoniusSolver<2> *tc = dynamic_cast<TairaColoniusSolver<2> *>(solver.get());
+  PetscInt    rank, mstart, nstart, m, n;
+  Vec         fTilde, regularizedForce, fx, fy;
+  PetscReal   **fxArray, **fyArray, forceOnProcess[2] = {0.0, 0.0}, forceGold[2], force[2] = {0.0, 0.0};
+
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+
+  // force integrated by regularizing fTilde onto the whole grid
+  VecDuplicate(solver->q, &regularizedForce);
+  DMCompositeGetAccess(solver->lambdaPack, solver->lambda, NULL, &fTilde);
+  MatMult(tc->ET, fTilde, regularizedForce);
+  DMCompositeRestoreAccess(solver->lambdaPack, solver->lambda, NULL, &fTilde);
+  DMCompositeGetAccess(solver->qPack, regularizedForce, &fx, &fy);
+  DMDAVecGetArray(solver->uda, fx, &fxArray);
+  DMDAGetCorners(solver->uda, &mstart, &nstart, NULL, &m, &n, NULL);
+  for(PetscInt j=nstart; j<nstart+n; j++)
+    for(PetscInt i=mstart; i<mstart+m; i++)
+      forceOnProcess[0] += CM.dy[j]*fxArray[j][i];
+  DMDAVecRestoreArray(solver->uda, fx, &fxArray);
+  DMDAVecGetArray(solver->vda, fy, &fyArray);
+  DMDAGetCorners(solver->vda, &mstart, &nstart, NULL, &m, &n, NULL);
+  for(PetscInt j=nstart; j<nstart+n; j++)
+    for(PetscInt i=mstart; i<mstart+m; i++)
+      forceOnProcess[1] += CM.dx[i]*fyArray[j][i];
+  DMDAVecRestoreArray(solver->vda, fy, &fyArray);
+  DMCompositeRestoreAccess(solver->qPack, regularizedForce, &fx, &fy);
+  VecDestroy(&regularizedForce);
+  MPI_Reduce(forceOnProcess, forceGold, 2, MPIU_REAL, MPI_SUM, 0, PETSC_COMM_WORLD);
+
+  // force integrated directly from the Lagrangian values
+  tc->calculateForce();
+
+  if(rank==0)
+  {
+    // sum of the forces on all the bodies
+    for(PetscInt b=0; b<tc->numBodies; b++)
+    {
+      force[0] += tc->forces[2*b];
+      force[1] += tc->forces[2*b+1];
+    }
+    EXPECT_NEAR(force[0], forceGold[0], 1.0E-10*(1.0+fabs(forceGold[0])));
+    EXPECT_NEAR(force[1], forceGold[1], 1.0E-10*(1.0+fabs(forceGold[1])));
+  }
+}
+
 int main(int argc, char **argv)
 {
   PetscErrorCode ierr, result;
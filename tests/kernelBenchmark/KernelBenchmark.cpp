@@ -0,0 +1,279 @@
+/***************************************************************************//**
+ * \file KernelBenchmark.cpp
+ * \author Olivier Mesnard (mesnardo@gwu.edu)
+ * \brief Implementation of the methods of the class \c KernelBenchmark.
+ */
+
+
+#include "KernelBenchmark.h"
+
+#include <fstream>
+#include <sstream>
+
+#include <petsctime.h>
+
+
+/**
+ * \brief Constructor - Reads the number of repeats and the size of the
+ *        arrays of the STREAM triad from the command-line.
+ */
+template <PetscInt dim>
+KernelBenchmark<dim>::KernelBenchmark(std::string folder,
+                                      FlowDescription *FD,
+                                      SimulationParameters *SP,
+                                      CartesianMesh *CM) : NavierStokesSolver<dim>::NavierStokesSolver(folder, FD, SP, CM)
+{
+  numRepeats = 20;
+  PetscOptionsGetInt(NULL, "-repeats", &numRepeats, NULL);
+  // three arrays of 32 MB: larger than the last-level caches
+  streamSize = 4000000;
+  PetscOptionsGetInt(NULL, "-streamSize", &streamSize, NULL);
+  streamBandwidth = 0.0;
+}
+
+/**
+ * \brief Initializes the solver and fills the fluxes and the pressure-forces
+ *        with random values.
+ */
+template <PetscInt dim>
+PetscErrorCode KernelBenchmark<dim>::initialize()
+{
+  PetscErrorCode ierr;
+
+  ierr = NavierStokesSolver<dim>::initialize(); CHKERRQ(ierr);
+  ierr = VecSetRandom(NavierStokesSolver<dim>::q, PETSC_NULL); CHKERRQ(ierr);
+  ierr = VecSetRandom(NavierStokesSolver<dim>::lambda, PETSC_NULL); CHKERRQ(ierr);
+
+  return ierr;
+}
+
+/**
+ * \brief Measures the bandwidth of the triad `a = b + s*c` of the STREAM
+ *        benchmark, run by all the processes at the same time.
+ *
+ * The best of the timed repeats is kept, after a first call that touches the
+ * pages of the arrays.
+ */
+template <PetscInt dim>
+PetscErrorCode KernelBenchmark<dim>::measureStreamBandwidth()
+{
+  PetscErrorCode ierr;
+
+  std::vector<PetscReal> a(streamSize, 0.0), b(streamSize, 1.0), c(streamSize, 2.0);
+  const PetscReal s = 3.0;
+  PetscLogDouble start, time, maxTime, best = 0.0;
+  for (PetscInt r=0; r<=numRepeats; r++)
+  {
+    ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
+    ierr = PetscTime(&start); CHKERRQ(ierr);
+    for (PetscInt i=0; i<streamSize; i++)
+      a[i] = b[i] + s*c[i];
+    ierr = PetscTime(&time); CHKERRQ(ierr);
+    time -= start;
+    ierr = MPI_Allreduce(&time, &maxTime, 1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+    if (r > 0 && (best == 0.0 || maxTime < best))
+      best = maxTime;
+  }
+  // the result is used, so the loop cannot be removed by the compiler
+  if (a[streamSize/2] != b[streamSize/2] + s*c[streamSize/2])
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Wrong result of the STREAM triad");
+  }
+
+  PetscMPIInt numProcs;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
+  Timing timing;
+  timing.name = "streamTriad";
+  timing.time = best;
+  timing.bytes = numProcs*3.0*sizeof(PetscReal)*streamSize;
+  timing.flops = numProcs*2.0*streamSize;
+  timings.push_back(timing);
+  streamBandwidth = timing.bytes/timing.time;
+
+  return ierr;
+}
+
+/**
+ * \brief Times a kernel.
+ *
+ * The kernel is called once to warm the caches, then `numRepeats` times.
+ * The time of a call is that of the slowest process and the best call is
+ * kept. The flops are those logged by PETSc during the timed calls.
+ *
+ * \param name name of the kernel in the report
+ * \param kernel function that calls the kernel
+ * \param bytes memory traffic of a call on the current process
+ */
+template <PetscInt dim>
+PetscErrorCode KernelBenchmark<dim>::timeKernel(std::string name, std::function<PetscErrorCode()> kernel, PetscLogDouble bytes)
+{
+  PetscErrorCode ierr;
+
+  PetscLogDouble start, time, maxTime, best = 0.0,
+                 flopsBefore, flopsAfter, flops;
+  ierr = kernel(); CHKERRQ(ierr);
+  ierr = PetscGetFlops(&flopsBefore); CHKERRQ(ierr);
+  for (PetscInt r=0; r<numRepeats; r++)
+  {
+    ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
+    ierr = PetscTime(&start); CHKERRQ(ierr);
+    ierr = kernel(); CHKERRQ(ierr);
+    ierr = PetscTime(&time); CHKERRQ(ierr);
+    time -= start;
+    ierr = MPI_Allreduce(&time, &maxTime, 1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+    if (best == 0.0 || maxTime < best)
+      best = maxTime;
+  }
+  ierr = PetscGetFlops(&flopsAfter); CHKERRQ(ierr);
+  flops = (flopsAfter - flopsBefore)/numRepeats;
+
+  Timing timing;
+  timing.name = name;
+  timing.time = best;
+  ierr = MPI_Allreduce(&bytes, &timing.bytes, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&flops, &timing.flops, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  timings.push_back(timing);
+
+  return ierr;
+}
+
+/**
+ * \brief Counts the velocity nodes of the current process located next to
+ *        a boundary of the domain.
+ */
+template <PetscInt dim>
+PetscErrorCode KernelBenchmark<dim>::countBoundaryNodes(PetscLogDouble *numNodes)
+{
+  PetscErrorCode ierr;
+
+  DM das[3] = {NavierStokesSolver<dim>::uda, NavierStokesSolver<dim>::vda, NavierStokesSolver<dim>::wda};
+  PetscInt start[3], width[3], size[3];
+  *numNodes = 0.0;
+  for (PetscInt c=0; c<dim; c++)
+  {
+    ierr = DMDAGetCorners(das[c], &start[0], &start[1], &start[2], &width[0], &width[1], &width[2]); CHKERRQ(ierr);
+    ierr = DMDAGetInfo(das[c], NULL, &size[0], &size[1], &size[2], NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+    PetscLogDouble total = 1.0, interior = 1.0;
+    for (PetscInt d=0; d<dim; d++)
+    {
+      PetscInt inner = width[d] - (start[d] == 0) - (start[d]+width[d] == size[d]);
+      total *= width[d];
+      interior *= (inner > 0)? inner : 0;
+    }
+    *numNodes += total - interior;
+  }
+
+  return ierr;
+}
+
+/**
+ * \brief Memory traffic of a product with a parallel AIJ matrix on the
+ *        current process: values and column indices of the non-zeros, row
+ *        offsets, input and output vectors.
+ */
+template <PetscInt dim>
+PetscErrorCode KernelBenchmark<dim>::matMultBytes(Mat M, PetscLogDouble *bytes)
+{
+  PetscErrorCode ierr;
+
+  MatInfo info;
+  PetscInt m, n;
+  ierr = MatGetInfo(M, MAT_LOCAL, &info); CHKERRQ(ierr);
+  ierr = MatGetLocalSize(M, &m, &n); CHKERRQ(ierr);
+  *bytes = info.nz_used*(sizeof(PetscScalar) + sizeof(PetscInt))
+           + (m+1)*sizeof(PetscInt)
+           + (m+n)*sizeof(PetscScalar);
+
+  return ierr;
+}
+
+/**
+ * \brief Times the kernels of a time-step.
+ *
+ * The bytes of the stencil kernels count every array once: for the explicit
+ * terms, the scatter of the fluxes to the local vectors (read and write), the
+ * stencils (read), H (read and write) and rn (write); for the boundary
+ * kernels, about three values per node next to the boundary.
+ */
+template <PetscInt dim>
+PetscErrorCode KernelBenchmark<dim>::runKernels()
+{
+  PetscErrorCode ierr;
+
+  const PetscLogDouble value = sizeof(PetscReal);
+  PetscInt numLocalFluxes;
+  PetscLogDouble numBoundaryNodes, bytes;
+  ierr = VecGetLocalSize(NavierStokesSolver<dim>::q, &numLocalFluxes); CHKERRQ(ierr);
+  ierr = countBoundaryNodes(&numBoundaryNodes); CHKERRQ(ierr);
+
+  ierr = timeKernel("explicitTerms", [this]() { return this->calculateExplicitTerms(); }, 6.0*value*numLocalFluxes); CHKERRQ(ierr);
+  ierr = timeKernel("boundaryGhosts", [this]() { return this->updateBoundaryGhosts(); }, 3.0*value*numBoundaryNodes); CHKERRQ(ierr);
+  ierr = timeKernel("generateBC1", [this]() { return this->generateBC1(); }, value*numLocalFluxes + 3.0*value*numBoundaryNodes); CHKERRQ(ierr);
+
+  ierr = matMultBytes(NavierStokesSolver<dim>::A, &bytes); CHKERRQ(ierr);
+  ierr = timeKernel("MatMult(A)", [this]() { return MatMult(this->A, this->q, this->temp); }, bytes); CHKERRQ(ierr);
+  ierr = matMultBytes(NavierStokesSolver<dim>::BNQ, &bytes); CHKERRQ(ierr);
+  ierr = timeKernel("MatMult(BNQ)", [this]() { return MatMult(this->BNQ, this->lambda, this->temp); }, bytes); CHKERRQ(ierr);
+  // the projection also reads qStar and writes q
+  ierr = timeKernel("projection", [this]() { return this->projectionStep(); }, bytes + 2.0*value*numLocalFluxes); CHKERRQ(ierr);
+  ierr = matMultBytes(NavierStokesSolver<dim>::QT, &bytes); CHKERRQ(ierr);
+  ierr = timeKernel("MatMult(QT)", [this]() { return MatMult(this->QT, this->q, this->rhs2); }, bytes); CHKERRQ(ierr);
+
+  return ierr;
+}
+
+/**
+ * \brief Prints the achieved bandwidth and flop rate of each kernel and
+ *        appends them to a file.
+ *
+ * The fraction of STREAM compares the bandwidth of the kernel with the
+ * bandwidth of the triad; the bound is the flop rate the kernel would reach
+ * at the bandwidth of the triad (its arithmetic intensity times the
+ * bandwidth), i.e. the memory roof of the roofline model.
+ */
+template <PetscInt dim>
+PetscErrorCode KernelBenchmark<dim>::writeTimings()
+{
+  PetscErrorCode ierr;
+
+  PetscMPIInt numProcs;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
+  CartesianMesh *mesh = NavierStokesSolver<dim>::mesh;
+  PetscLogDouble numCells = mesh->nx*mesh->ny*((dim == 3)? mesh->nz : 1),
+                 cellsPerProcess = numCells/numProcs;
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "\n%D cells, %.0f cells per process, %d processes\n", (PetscInt)numCells, cellsPerProcess, numProcs); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "%-16s%12s%12s%12s%12s%12s%12s\n", "kernel", "time (s)", "GB/s", "GFlop/s", "flop/byte", "of STREAM", "bound"); CHKERRQ(ierr);
+
+  PetscInt rank;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  std::ofstream fileStream;
+  if (rank == 0)
+  {
+    std::stringstream out;
+    out << "./data/kernels" << dim << "d.dat";
+    fileStream.open(out.str().c_str(), std::ios::out | std::ios::app);
+  }
+  for (size_t t=0; t<timings.size(); t++)
+  {
+    const Timing &timing = timings[t];
+    PetscLogDouble bandwidth = timing.bytes/timing.time,
+                   flopRate = timing.flops/timing.time,
+                   intensity = timing.flops/timing.bytes,
+                   bound = intensity*streamBandwidth;
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "%-16s%12.4e%12.3f%12.3f%12.3f%11.1f%%%12.3f\n", timing.name.c_str(), timing.time, bandwidth/1.0E+09, flopRate/1.0E+09, intensity, 100.0*bandwidth/streamBandwidth, bound/1.0E+09); CHKERRQ(ierr);
+    if (rank == 0)
+    {
+      fileStream << cellsPerProcess << "\t" << timing.name << "\t" << timing.time << "\t"
+                 << bandwidth/1.0E+09 << "\t" << flopRate/1.0E+09 << "\t" << intensity << "\t"
+                 << bandwidth/streamBandwidth << std::endl;
+    }
+  }
+  if (rank == 0)
+    fileStream.close();
+
+  return ierr;
+}
+
+template class KernelBenchmark<2>;
+template class KernelBenchmark<3>;
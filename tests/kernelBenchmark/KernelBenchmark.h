@@ -0,0 +1,56 @@
+/***************************************************************************//**
+ * \file KernelBenchmark.h
+ * \author Olivier Mesnard (mesnardo@gwu.edu)
+ * \brief Definition of the class \c KernelBenchmark.
+ */
+
+
+#if !defined(KERNEL_BENCHMARK_H)
+#define KERNEL_BENCHMARK_H
+
+#include <NavierStokesSolver.h>
+
+#include <functional>
+
+
+/**
+ * \class KernelBenchmark
+ * \brief Times the kernels of a time-step and compares their bandwidth
+ *        with the bandwidth measured by a STREAM triad.
+ *
+ * The flops of a kernel are those counted by PETSc (through \c PetscLogFlops
+ * in the hand-written kernels); the bytes are the compulsory memory traffic
+ * of the kernel (every array read or written once).
+ */
+template <PetscInt dim>
+class KernelBenchmark : public NavierStokesSolver<dim>
+{
+public:
+  /**
+   * \brief Measurements of a kernel (summed over the processes).
+   */
+  struct Timing
+  {
+    std::string    name;
+    PetscLogDouble time,   ///< best wall-time of a call (slowest process)
+                   bytes,  ///< compulsory memory traffic of a call
+                   flops;  ///< floating-point operations of a call
+  };
+
+  PetscInt            numRepeats;       // number of timed calls of each kernel
+  PetscInt            streamSize;       // number of values of the arrays of the STREAM triad
+  PetscLogDouble      streamBandwidth;  // bandwidth of the STREAM triad (bytes/s)
+  std::vector<Timing> timings;          // measurements of the kernels
+
+  PetscErrorCode initialize();
+  PetscErrorCode measureStreamBandwidth();
+  PetscErrorCode timeKernel(std::string name, std::function<PetscErrorCode()> kernel, PetscLogDouble bytes);
+  PetscErrorCode runKernels();
+  PetscErrorCode countBoundaryNodes(PetscLogDouble *numNodes);
+  PetscErrorCode matMultBytes(Mat M, PetscLogDouble *bytes);
+  PetscErrorCode writeTimings();
+
+  KernelBenchmark(std::string folder, FlowDescription *FD, SimulationParameters *SP, CartesianMesh *CM);
+};
+
+#endif
@@ -0,0 +1,87 @@
+/***************************************************************************//**
+ * \file kernelBenchmark.cpp
+ * \author Olivier Mesnard (mesnardo@gwu.edu)
+ * \brief Micro-benchmark of the kernels of a time-step.
+ *
+ * Usage:
+ *
+ *     mpiexec -n <np> kernelBenchmark3d -caseFolder <folder> -cells <n>
+ *                     [-repeats <r>] [-streamSize <s>]
+ *
+ * The flow and the simulation parameters are read from the case folder; the
+ * grid is a uniform unit box with `n` cells in each direction, written in
+ * `./data/mesh<dim>d_<n>`.
+ */
+
+
+#include "KernelBenchmark.h"
+#include <NavierStokesSolver.h>
+#include <CartesianMesh.h>
+#include <FlowDescription.h>
+#include <SimulationParameters.h>
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <sys/stat.h>
+
+#include <petscksp.h>
+
+#ifndef DIMENSIONS
+#define DIMENSIONS 2
+#endif
+
+
+int main(int argc, char **argv)
+{
+  PetscErrorCode ierr;
+  const PetscInt dim = DIMENSIONS;
+
+  ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
+
+  char caseFolder[PETSC_MAX_PATH_LEN];
+  ierr = PetscOptionsGetString(NULL, "-caseFolder", caseFolder, sizeof(caseFolder), NULL); CHKERRQ(ierr);
+  PetscInt numCells = 64;
+  ierr = PetscOptionsGetInt(NULL, "-cells", &numCells, NULL); CHKERRQ(ierr);
+
+  // uniform grid of the benchmark
+  std::stringstream out;
+  out << "./data/mesh" << dim << "d_" << numCells;
+  std::string meshFolder = out.str();
+  PetscInt rank;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  if (rank == 0)
+  {
+    mkdir(meshFolder.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+    std::ofstream fileStream((meshFolder+"/cartesianMesh.yaml").c_str());
+    const char *directions[3] = {"x", "y", "z"};
+    for (PetscInt d=0; d<dim; d++)
+    {
+      fileStream << "- direction: " << directions[d] << "\n"
+                 << "  start: 0.0\n"
+                 << "  subDomains:\n"
+                 << "    - end: 1.0\n"
+                 << "      cells: " << numCells << "\n"
+                 << "      stretchRatio: 1.0\n\n";
+    }
+  }
+
+  std::string folder(caseFolder);
+  FlowDescription FD(folder+"/flowDescription.yaml");
+  CartesianMesh CM(meshFolder+"/cartesianMesh.yaml");
+  SimulationParameters SP(folder+"/simulationParameters.yaml");
+
+  std::unique_ptr< KernelBenchmark<dim> > solver(new KernelBenchmark<dim>(meshFolder, &FD, &SP, &CM));
+
+  ierr = solver->initialize(); CHKERRQ(ierr);
+
+  ierr = solver->measureStreamBandwidth(); CHKERRQ(ierr);
+  ierr = solver->runKernels(); CHKERRQ(ierr);
+  ierr = solver->writeTimings(); CHKERRQ(ierr);
+
+  ierr = solver->finalize(); CHKERRQ(ierr);
+
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+
+  return ierr;
+}
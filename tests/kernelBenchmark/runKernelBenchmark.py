@@ -0,0 +1,128 @@
+#!/usr/bin/env python
+
+# file: runKernelBenchmark.py
+# author: Olivier Mesnard (mesnardo@gwu.edu)
+# brief: Runs the micro-benchmark of the kernels in 2d and 3d and plots
+#        the fraction of the STREAM bandwidth and the roofline of the kernels.
+
+
+import os
+
+import numpy
+from matplotlib import pyplot
+
+
+def read_timings(file_path):
+  """Reads the measurements of the kernels.
+
+  Parameters
+  ----------
+  file_path: str
+    Path of the file written by the benchmark.
+
+  Returns
+  -------
+  kernels: dict(str, numpy.ndarray)
+    Cells per process, time, bandwidth (GB/s), flop rate (GFlop/s),
+    arithmetic intensity (flop/byte) and fraction of STREAM of each kernel,
+    sorted by number of cells per process.
+  """
+  kernels = {}
+  with open(file_path, 'r') as infile:
+    for line in infile:
+      columns = line.split()
+      kernels.setdefault(columns[1], []).append([float(value) for value
+                                                  in [columns[0]] + columns[2:]])
+  for name in kernels:
+    kernels[name] = numpy.array(sorted(kernels[name])).transpose()
+  return kernels
+
+
+def plot_bandwidth(kernels, legend, output_file):
+  """Plots the fraction of the STREAM bandwidth reached by each kernel
+  versus the number of cells per process.
+
+  Parameters
+  ----------
+  kernels: dict(str, numpy.ndarray)
+    Measurements of the kernels.
+  legend: str
+    Title of the plot.
+  output_file: str
+    Path of the image to be saved.
+  """
+  pyplot.figure(figsize=(8, 6))
+  pyplot.grid(True)
+  pyplot.title(legend)
+  pyplot.xlabel('cells per process')
+  pyplot.ylabel('fraction of the STREAM bandwidth')
+  for name in sorted(kernels):
+    if name != 'streamTriad':
+      pyplot.plot(kernels[name][0], kernels[name][5], label=name,
+                  marker='o', markersize=6)
+  pyplot.axhline(1.0, color='k', ls='--')
+  pyplot.legend(loc='best', frameon=False)
+  pyplot.xscale('log')
+  pyplot.savefig(output_file)
+
+
+def plot_roofline(kernels, legend, output_file):
+  """Plots the flop rate of the kernels on the largest grid versus their
+  arithmetic intensity, with the memory roof given by the STREAM bandwidth.
+
+  Parameters
+  ----------
+  kernels: dict(str, numpy.ndarray)
+    Measurements of the kernels.
+  legend: str
+    Title of the plot.
+  output_file: str
+    Path of the image to be saved.
+  """
+  bandwidth = kernels['streamTriad'][2].max()
+  pyplot.figure(figsize=(8, 6))
+  pyplot.grid(True)
+  pyplot.title(legend)
+  pyplot.xlabel('arithmetic intensity (flop/byte)')
+  pyplot.ylabel('GFlop/s')
+  intensities = [kernels[name][4][-1] for name in kernels
+                 if kernels[name][4][-1] > 0.0]
+  gauge = numpy.logspace(numpy.log10(0.5*min(intensities)),
+                         numpy.log10(2.0*max(intensities)), 101)
+  pyplot.plot(gauge, bandwidth*gauge, color='k', ls='-',
+              label='STREAM ({:.1f} GB/s)'.format(bandwidth))
+  for name in sorted(kernels):
+    if name != 'streamTriad' and kernels[name][4][-1] > 0.0:
+      pyplot.plot(kernels[name][4][-1], kernels[name][3][-1], label=name,
+                  marker='o', markersize=8, ls='')
+  pyplot.legend(loc='best', frameon=False)
+  pyplot.xscale('log')
+  pyplot.yscale('log')
+  pyplot.savefig(output_file)
+
+
+def main():
+  """Builds the micro-benchmark, runs it for 2d grids and 3d grids
+  and plots the bandwidth and the roofline of the kernels.
+  """
+  # build micro-benchmark
+  benchmark_directory = '{}/tests/kernelBenchmark'.format(os.environ['PETIBM_DIR'])
+  os.chdir(benchmark_directory)
+  os.system('make cleanTest')
+  os.system('make')
+  # run micro-benchmark for 2d grids and 3d grids
+  os.system('make runBenchmark')
+
+  # plot and save bandwidths and rooflines
+  pyplot.style.use('{}/scripts/python/style/'
+                   'style_PetIBM.mplstyle'.format(os.environ['PETIBM_DIR']))
+  for dim in [2, 3]:
+    kernels = read_timings('{}/data/kernels{}d.dat'.format(benchmark_directory, dim))
+    plot_bandwidth(kernels, 'kernels ({}d)'.format(dim),
+                   '{}/data/bandwidthKernels{}d.png'.format(benchmark_directory, dim))
+    plot_roofline(kernels, 'kernels ({}d)'.format(dim),
+                  '{}/data/rooflineKernels{}d.png'.format(benchmark_directory, dim))
+
+
+if __name__ == '__main__':
+  main()